@@ -29,6 +29,13 @@
 
 #include "LIS3DHTR.h"
 
+#if defined(LIS3DHTR_SIMULATE) && LIS3DHTR_SIMULATE == 1
+// Bus transfers go to the register model, no IDF dependency so the driver
+// also builds on the host
+#include "LIS3DHTR_sim.h"
+
+#define DELAY(ms)
+#else
 // Include FreeRTOS for delay
 #include <freertos/FreeRTOS.h>
 #include "driver/i2c.h"
@@ -40,6 +47,7 @@
 #endif
 
 #define DELAY(ms) vTaskDelay(ms / portTICK_RATE_MS);
+#endif
 
 LIS3DHTR::LIS3DHTR()
 {
@@ -48,7 +56,9 @@ LIS3DHTR::LIS3DHTR()
 
 void LIS3DHTR::begin(uint8_t address)
 {
-
+#if defined(LIS3DHTR_SIMULATE) && LIS3DHTR_SIMULATE == 1
+    lis3dhtr_sim_reset();
+#else
     i2c_config_t conf = {
         .mode = I2C_MODE_MASTER,
         .sda_io_num = I2C_MASTER_SDA_IO,
@@ -62,6 +72,7 @@ void LIS3DHTR::begin(uint8_t address)
     i2c_param_config(I2C_MASTER_NUM, &conf);
 
     i2c_driver_install(I2C_MASTER_NUM, conf.mode, I2C_MASTER_RX_BUF_DISABLE, I2C_MASTER_TX_BUF_DISABLE, I2C_NUM_0);
+#endif
 
     devAddr = address;
 
@@ -334,11 +345,14 @@ uint16_t LIS3DHTR::readbitADC3(void)
 
 void LIS3DHTR::writeRegister(uint8_t reg, uint8_t val)
 {
+#if defined(LIS3DHTR_SIMULATE) && LIS3DHTR_SIMULATE == 1
+    lis3dhtr_sim_write(reg, val);
+#else
 
 uint8_t write_buf[2] = {reg, val};
 
 i2c_master_write_to_device(I2C_MASTER_NUM, devAddr, write_buf, sizeof(write_buf), I2C_MASTER_TIMEOUT_MS / portTICK_RATE_MS);
-
+#endif
 }
 
 void LIS3DHTR::readRegisterRegion(uint8_t *outputPointer, uint8_t reg, uint8_t length)
@@ -346,7 +360,11 @@ void LIS3DHTR::readRegisterRegion(uint8_t *outputPointer, uint8_t reg, uint8_t l
 
     reg |= 0x80; //turn auto-increment bit on, bit 7 for I2C
 
+#if defined(LIS3DHTR_SIMULATE) && LIS3DHTR_SIMULATE == 1
+    lis3dhtr_sim_read(reg, outputPointer, length);
+#else
     i2c_master_write_read_device(I2C_MASTER_NUM, devAddr, &reg, 1, outputPointer, length, I2C_MASTER_TIMEOUT_MS / portTICK_RATE_MS);
+#endif
 
 }
 
@@ -397,4 +415,83 @@ void LIS3DHTR::click(uint8_t c, uint8_t click_thresh, uint8_t limit, uint8_t lat
     writeRegister(LIS3DHTR_REG_ACCEL_TIME_WINDOW, window);
 }
 
+/**
+ * Enable the 32 level FIFO. In stream mode the oldest sample is overwritten
+ * when the FIFO is full, the watermark flag is set once more than watermark
+ * samples are stored. LIS3DHTR_FIFO_BYPASS disables the FIFO again.
+ */
+void LIS3DHTR::setFifoMode(fifo_mode_t mode, uint8_t watermark)
+{
+    uint8_t ctrl5 = readRegister(LIS3DHTR_REG_ACCEL_CTRL_REG5);
+
+    // switching through bypass clears the FIFO
+    writeRegister(LIS3DHTR_REG_ACCEL_FIFO_CTRL, LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_BYPASS);
+
+    if (mode == LIS3DHTR_FIFO_BYPASS)
+    {
+        writeRegister(LIS3DHTR_REG_ACCEL_CTRL_REG5, ctrl5 & ~LIS3DHTR_REG_ACCEL_CTRL_REG5_FIFO_EN);
+        return;
+    }
+
+    writeRegister(LIS3DHTR_REG_ACCEL_CTRL_REG5, ctrl5 | LIS3DHTR_REG_ACCEL_CTRL_REG5_FIFO_EN);
+    writeRegister(LIS3DHTR_REG_ACCEL_FIFO_CTRL, mode | (watermark & LIS3DHTR_REG_ACCEL_FIFO_CTRL_FTH_MASK));
+}
+
+/**
+ * Number of unread samples in the FIFO
+ */
+uint8_t LIS3DHTR::getFifoLevel(bool *overrun)
+{
+    uint8_t src = readRegister(LIS3DHTR_REG_ACCEL_FIFO_SRC);
+
+    if (overrun != nullptr)
+    {
+        *overrun = (src & LIS3DHTR_REG_ACCEL_FIFO_SRC_OVRN) != 0;
+    }
+
+    if (src & LIS3DHTR_REG_ACCEL_FIFO_SRC_EMPTY)
+    {
+        return 0;
+    }
+
+    return (src & LIS3DHTR_REG_ACCEL_FIFO_SRC_OVRN) ? LIS3DHTR_FIFO_DEPTH : (src & LIS3DHTR_REG_ACCEL_FIFO_SRC_FSS_MASK);
+}
+
+/**
+ * Read all pending FIFO samples, up to max_samples, in one I2C transfer.
+ * With the FIFO enabled the register address rolls back from OUT_Z_H to
+ * OUT_X_L, so consecutive samples come out of a single burst read.
+ *
+ * @param xyz      room for 3 * max_samples values in g, oldest sample first
+ * @param overrun  set when samples were overwritten since the last read
+ * @return number of samples read
+ */
+uint8_t LIS3DHTR::readFifo(float *xyz, uint8_t max_samples, bool *overrun)
+{
+    int16_t raw[LIS3DHTR_FIFO_DEPTH * 3];
+    uint8_t n = getFifoLevel(overrun);
+
+    if (n > max_samples)
+    {
+        n = max_samples;
+    }
+    if (n > LIS3DHTR_FIFO_DEPTH)
+    {
+        n = LIS3DHTR_FIFO_DEPTH;
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    readRegisterRegion((uint8_t *)raw, LIS3DHTR_REG_ACCEL_OUT_X_L, n * 6);
+
+    for (int i = 0; i < n * 3; i++)
+    {
+        xyz[i] = (float)raw[i] / accRange;
+    }
+
+    return n;
+}
+
 LIS3DHTR::operator bool() { return isConnection(); }
\ No newline at end of file
@@ -0,0 +1,367 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "LIS3DHTR.h"
+#include "LIS3DHTR_sim.h"
+
+#include <chrono>
+#include <math.h>
+#include <string.h>
+
+#define SIM_REG_COUNT           0x80
+#define SIM_DEVICE_ID           0x33
+#define SIM_CTRL_REG1_DEFAULT   0x07
+#define SIM_CTRL_REG1_LPEN      0x08
+#define SIM_STATUS2_ZYXDA       0x08
+#define SIM_STATUS2_ZYXOR       0x80
+
+typedef struct {
+    int16_t xyz[3];
+} sim_sample_t;
+
+static uint8_t regs[SIM_REG_COUNT];
+static sim_sample_t fifo[LIS3DHTR_FIFO_DEPTH];
+static uint8_t fifo_head = 0;
+static uint8_t fifo_count = 0;
+static sim_sample_t latest;
+
+static int64_t (*clock_fn)(void) = nullptr;
+static bool clock_selected = false;
+static int64_t sim_time_us = 0;
+static int64_t next_sample_us = 0;
+
+static void sim_default_signal(int64_t t_us, float *xyz, void *ctx);
+static lis3dhtr_sim_signal_t signal_fn = sim_default_signal;
+static void *signal_ctx = nullptr;
+
+static bool powered = false;
+
+static lis3dhtr_sim_stats_t stats = {};
+
+static int64_t sim_steady_clock_us(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void sim_default_signal(int64_t t_us, float *xyz, void *ctx)
+{
+    (void)ctx;
+    xyz[0] = 0.5f * sinf(2.0f * (float)M_PI * 5.0f * (float)t_us / 1000000.0f);
+    xyz[1] = 0.0f;
+    xyz[2] = 1.0f;
+}
+
+/* output data rate selected by CTRL_REG1, in Hz, 0 when powered down */
+static uint32_t sim_odr_hz(void)
+{
+    static const uint32_t odr_table[16] = { 0, 1, 10, 25, 50, 100, 200, 400, 1600, 1344 };
+    uint8_t ctrl1 = regs[LIS3DHTR_REG_ACCEL_CTRL_REG1];
+    uint8_t odr = (ctrl1 & LIS3DHTR_REG_ACCEL_CTRL_REG1_AODR_MASK) >> 4;
+
+    if (odr == 9 && (ctrl1 & SIM_CTRL_REG1_LPEN)) {
+        return 5376;
+    }
+    return odr_table[odr];
+}
+
+/* LSB per g, matching the sensitivities the driver divides by */
+static float sim_sensitivity(void)
+{
+    switch (regs[LIS3DHTR_REG_ACCEL_CTRL_REG4] & LIS3DHTR_REG_ACCEL_CTRL_REG4_FS_MASK) {
+        case LIS3DHTR_REG_ACCEL_CTRL_REG4_FS_4G: return 7282.0f;
+        case LIS3DHTR_REG_ACCEL_CTRL_REG4_FS_8G: return 3968.0f;
+        case LIS3DHTR_REG_ACCEL_CTRL_REG4_FS_16G: return 1280.0f;
+        default: return 16000.0f;
+    }
+}
+
+static uint8_t sim_fifo_mode(void)
+{
+    if ((regs[LIS3DHTR_REG_ACCEL_CTRL_REG5] & LIS3DHTR_REG_ACCEL_CTRL_REG5_FIFO_EN) == 0) {
+        return LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_BYPASS;
+    }
+    return regs[LIS3DHTR_REG_ACCEL_FIFO_CTRL] & LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_MASK;
+}
+
+static void sim_fifo_clear(void)
+{
+    fifo_head = 0;
+    fifo_count = 0;
+}
+
+static void sim_produce_sample(int64_t t_us)
+{
+    float g[3];
+    float sensitivity = sim_sensitivity();
+
+    signal_fn(t_us, g, signal_ctx);
+
+    for (int i = 0; i < 3; i++) {
+        float raw = g[i] * sensitivity;
+        if (raw > 32767.0f) {
+            raw = 32767.0f;
+        }
+        else if (raw < -32768.0f) {
+            raw = -32768.0f;
+        }
+        latest.xyz[i] = (int16_t)raw;
+    }
+
+    stats.produced++;
+
+    if (regs[LIS3DHTR_REG_ACCEL_STATUS2] & SIM_STATUS2_ZYXDA) {
+        regs[LIS3DHTR_REG_ACCEL_STATUS2] |= SIM_STATUS2_ZYXOR;
+    }
+    regs[LIS3DHTR_REG_ACCEL_STATUS2] |= SIM_STATUS2_ZYXDA;
+
+    uint8_t mode = sim_fifo_mode();
+
+    if (mode == LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_BYPASS) {
+        return;
+    }
+
+    if (fifo_count == LIS3DHTR_FIFO_DEPTH) {
+        if (mode == LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_FIFO) {
+            stats.dropped++;
+            return;
+        }
+        fifo_head = (fifo_head + 1) % LIS3DHTR_FIFO_DEPTH;
+        fifo_count--;
+        stats.overwritten++;
+    }
+
+    fifo[(fifo_head + fifo_count) % LIS3DHTR_FIFO_DEPTH] = latest;
+    fifo_count++;
+}
+
+static void sim_run_until(int64_t t_us)
+{
+    uint32_t odr = sim_odr_hz();
+
+    if (odr == 0) {
+        sim_time_us = t_us;
+        next_sample_us = t_us;
+        return;
+    }
+
+    int64_t period_us = 1000000 / odr;
+
+    /* catch up at most one FIFO worth after a long pause, older samples
+       would be overwritten anyway */
+    if (t_us - next_sample_us > (LIS3DHTR_FIFO_DEPTH + 1) * period_us) {
+        int64_t skipped = (t_us - next_sample_us) / period_us - LIS3DHTR_FIFO_DEPTH;
+        stats.produced += (uint32_t)skipped;
+        if (sim_fifo_mode() == LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_STREAM) {
+            stats.overwritten += (uint32_t)skipped;
+        }
+        else if (sim_fifo_mode() == LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_FIFO) {
+            stats.dropped += (uint32_t)skipped;
+        }
+        next_sample_us += skipped * period_us;
+    }
+
+    while (next_sample_us <= t_us) {
+        sim_produce_sample(next_sample_us);
+        next_sample_us += period_us;
+    }
+
+    sim_time_us = t_us;
+}
+
+/* power on state before the first access */
+static void sim_power_on(void)
+{
+    if (powered == false) {
+        lis3dhtr_sim_reset();
+    }
+}
+
+static void sim_sync(void)
+{
+    sim_power_on();
+
+    if (clock_selected == false) {
+        clock_selected = true;
+        clock_fn = sim_steady_clock_us;
+        sim_time_us = clock_fn();
+        next_sample_us = sim_time_us;
+    }
+
+    if (clock_fn != nullptr) {
+        sim_run_until(clock_fn());
+    }
+}
+
+static uint8_t sim_fifo_src(void)
+{
+    uint8_t src = fifo_count & LIS3DHTR_REG_ACCEL_FIFO_SRC_FSS_MASK;
+
+    if (fifo_count == 0) {
+        src |= LIS3DHTR_REG_ACCEL_FIFO_SRC_EMPTY;
+    }
+    if (fifo_count == LIS3DHTR_FIFO_DEPTH) {
+        src |= LIS3DHTR_REG_ACCEL_FIFO_SRC_OVRN;
+    }
+    if (fifo_count > (regs[LIS3DHTR_REG_ACCEL_FIFO_CTRL] & LIS3DHTR_REG_ACCEL_FIFO_CTRL_FTH_MASK)) {
+        src |= LIS3DHTR_REG_ACCEL_FIFO_SRC_WTM;
+    }
+    return src;
+}
+
+static uint8_t sim_read_byte(uint8_t reg)
+{
+    if (reg >= LIS3DHTR_REG_ACCEL_OUT_X_L && reg <= LIS3DHTR_REG_ACCEL_OUT_Z_H) {
+        bool from_fifo = sim_fifo_mode() != LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_BYPASS && fifo_count > 0;
+        const sim_sample_t *sample = from_fifo ? &fifo[fifo_head] : &latest;
+        int axis = (reg - LIS3DHTR_REG_ACCEL_OUT_X_L) / 2;
+        uint16_t value = (uint16_t)sample->xyz[axis];
+        uint8_t byte = (reg & 1) ? (uint8_t)(value >> 8) : (uint8_t)(value & 0xff);
+
+        /* reading OUT_Z_H completes the sample */
+        if (reg == LIS3DHTR_REG_ACCEL_OUT_Z_H) {
+            regs[LIS3DHTR_REG_ACCEL_STATUS2] &= ~(SIM_STATUS2_ZYXDA | SIM_STATUS2_ZYXOR);
+            if (from_fifo) {
+                fifo_head = (fifo_head + 1) % LIS3DHTR_FIFO_DEPTH;
+                fifo_count--;
+            }
+        }
+        return byte;
+    }
+
+    if (reg == LIS3DHTR_REG_ACCEL_FIFO_SRC) {
+        return sim_fifo_src();
+    }
+
+    return regs[reg];
+}
+
+void lis3dhtr_sim_reset(void)
+{
+    powered = true;
+    memset(regs, 0, sizeof(regs));
+    regs[LIS3DHTR_REG_ACCEL_WHO_AM_I] = SIM_DEVICE_ID;
+    regs[LIS3DHTR_REG_ACCEL_CTRL_REG1] = SIM_CTRL_REG1_DEFAULT;
+    memset(&latest, 0, sizeof(latest));
+    sim_fifo_clear();
+    stats = {};
+    next_sample_us = sim_time_us;
+}
+
+void lis3dhtr_sim_set_clock(int64_t (*now_us)(void))
+{
+    sim_power_on();
+    clock_selected = true;
+    clock_fn = now_us;
+    if (clock_fn != nullptr) {
+        sim_time_us = clock_fn();
+    }
+    next_sample_us = sim_time_us;
+}
+
+void lis3dhtr_sim_advance(uint32_t us)
+{
+    sim_power_on();
+
+    if (clock_fn == nullptr) {
+        clock_selected = true;
+        sim_run_until(sim_time_us + us);
+    }
+}
+
+void lis3dhtr_sim_set_signal(lis3dhtr_sim_signal_t signal, void *ctx)
+{
+    signal_fn = signal ? signal : sim_default_signal;
+    signal_ctx = signal ? ctx : nullptr;
+}
+
+void lis3dhtr_sim_get_stats(lis3dhtr_sim_stats_t *out)
+{
+    *out = stats;
+}
+
+void lis3dhtr_sim_write(uint8_t reg, uint8_t val)
+{
+    reg &= 0x7f;
+
+    sim_sync();
+    stats.bus_writes++;
+
+    if (reg == LIS3DHTR_REG_ACCEL_WHO_AM_I || reg == LIS3DHTR_REG_ACCEL_FIFO_SRC ||
+        reg == LIS3DHTR_REG_ACCEL_STATUS2 ||
+        (reg >= LIS3DHTR_REG_ACCEL_OUT_X_L && reg <= LIS3DHTR_REG_ACCEL_OUT_Z_H)) {
+        return;
+    }
+
+    uint8_t old = regs[reg];
+    regs[reg] = val;
+
+    if (reg == LIS3DHTR_REG_ACCEL_CTRL_REG1 &&
+        ((old ^ val) & LIS3DHTR_REG_ACCEL_CTRL_REG1_AODR_MASK)) {
+        uint32_t odr = sim_odr_hz();
+        next_sample_us = sim_time_us + (odr ? 1000000 / odr : 0);
+    }
+    else if (reg == LIS3DHTR_REG_ACCEL_FIFO_CTRL &&
+        (val & LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_MASK) == LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_BYPASS) {
+        sim_fifo_clear();
+    }
+}
+
+void lis3dhtr_sim_read(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    bool increment = (reg & 0x80) != 0;
+
+    reg &= 0x7f;
+
+    sim_sync();
+    stats.bus_reads++;
+
+    bool fifo_on = sim_fifo_mode() != LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_BYPASS;
+
+    for (uint16_t i = 0; i < len; i++) {
+        buf[i] = sim_read_byte(reg);
+
+        if (increment == false) {
+            continue;
+        }
+        /* with the FIFO enabled the address rolls back to OUT_X_L so a
+           burst read walks through consecutive samples */
+        if (fifo_on && reg == LIS3DHTR_REG_ACCEL_OUT_Z_H) {
+            reg = LIS3DHTR_REG_ACCEL_OUT_X_L;
+        }
+        else {
+            reg = (reg + 1) & 0x7f;
+        }
+    }
+}
@@ -160,6 +160,27 @@
 
 #define LIS3DHTR_REG_ACCEL_STATUS2_UPDATE_MASK (0x08)   // Has New Data Flag Mask
 
+/**************************************************************************
+    ACCELEROMETER CONTROL REGISTER 5 DESCRIPTION
+**************************************************************************/
+#define LIS3DHTR_REG_ACCEL_CTRL_REG5_FIFO_EN (0x40)     // FIFO Enable
+
+/**************************************************************************
+    FIFO CONTROL AND SOURCE REGISTER DESCRIPTION
+**************************************************************************/
+#define LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_MASK (0xC0)         // FIFO Mode Selection
+#define LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_BYPASS (0x00)       // Bypass Mode
+#define LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_FIFO (0x40)         // FIFO Mode, stops when full
+#define LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_STREAM (0x80)       // Stream Mode, oldest data is overwritten
+#define LIS3DHTR_REG_ACCEL_FIFO_CTRL_FTH_MASK (0x1F)        // Watermark Level
+
+#define LIS3DHTR_REG_ACCEL_FIFO_SRC_WTM (0x80)              // Level Above Watermark
+#define LIS3DHTR_REG_ACCEL_FIFO_SRC_OVRN (0x40)             // FIFO Full, Data Overwritten
+#define LIS3DHTR_REG_ACCEL_FIFO_SRC_EMPTY (0x20)            // FIFO Empty
+#define LIS3DHTR_REG_ACCEL_FIFO_SRC_FSS_MASK (0x1F)         // Number Of Unread Samples
+
+#define LIS3DHTR_FIFO_DEPTH (32)
+
 enum power_type_t // power mode
 {
     POWER_MODE_NORMAL = LIS3DHTR_REG_ACCEL_CTRL_REG1_LPEN_NORMAL,
@@ -174,6 +195,13 @@ enum scale_type_t // measurement rage
     LIS3DHTR_RANGE_16G = LIS3DHTR_REG_ACCEL_CTRL_REG4_FS_16G, //
 };
 
+enum fifo_mode_t // FIFO mode
+{
+    LIS3DHTR_FIFO_BYPASS = LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_BYPASS,
+    LIS3DHTR_FIFO_FIFO = LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_FIFO,
+    LIS3DHTR_FIFO_STREAM = LIS3DHTR_REG_ACCEL_FIFO_CTRL_FM_STREAM
+};
+
 enum odr_type_t // output data rate
 {
     LIS3DHTR_DATARATE_POWERDOWN = LIS3DHTR_REG_ACCEL_CTRL_REG1_AODR_PD,
@@ -209,6 +237,10 @@ public:
     float getAccelerationZ(void);
     void click(uint8_t c, uint8_t click_thresh, uint8_t limit = 10, uint8_t latency = 20, uint8_t window = 255);
 
+    void setFifoMode(fifo_mode_t mode, uint8_t watermark = 0);
+    uint8_t getFifoLevel(bool *overrun = nullptr);
+    uint8_t readFifo(float *xyz, uint8_t max_samples, bool *overrun = nullptr);
+
     void openTemp();
     void closeTemp();
 
@@ -0,0 +1,97 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIS3DHTR_SIM_H
+#define LIS3DHTR_SIM_H
+
+/**
+ * Register level model of the LIS3DHTR, used in place of the I2C bus when
+ * the driver is built with LIS3DHTR_SIMULATE. It implements the parts of
+ * the device the firmware relies on: WHO_AM_I, the output data rate in
+ * CTRL_REG1, the full scale in CTRL_REG4, the 32 level FIFO with its
+ * bypass, FIFO and stream modes, FIFO_SRC and the OUT_X_L..OUT_Z_H
+ * address roll over used for burst reads.
+ *
+ * Samples are produced on a clock, by default the monotonic clock of the
+ * host, so FIFO fill level, overruns and the data rate behave as they do on
+ * the bench. The model has no locking, the driver is expected to be used
+ * from a single task.
+ */
+
+#include <stdint.h>
+
+/**
+ * Acceleration in g on the three axes at time t_us
+ */
+typedef void (*lis3dhtr_sim_signal_t)(int64_t t_us, float *xyz, void *ctx);
+
+typedef struct {
+    uint32_t produced;      /* samples generated at the output data rate */
+    uint32_t overwritten;   /* samples lost to a full FIFO in stream mode */
+    uint32_t dropped;       /* samples discarded by a full FIFO in FIFO mode */
+    uint32_t bus_reads;     /* read transfers */
+    uint32_t bus_writes;    /* write transfers */
+} lis3dhtr_sim_stats_t;
+
+/**
+ * Put every register back to its power on value and empty the FIFO
+ */
+void lis3dhtr_sim_reset(void);
+
+/**
+ * Select the time source, nullptr switches to manual time that only moves
+ * with lis3dhtr_sim_advance()
+ */
+void lis3dhtr_sim_set_clock(int64_t (*now_us)(void));
+
+/**
+ * Move manual time forward, generating the samples that fall in between
+ */
+void lis3dhtr_sim_advance(uint32_t us);
+
+/**
+ * Replace the default signal, 1 g on Z with a 5 Hz 0.5 g sine on X
+ */
+void lis3dhtr_sim_set_signal(lis3dhtr_sim_signal_t signal, void *ctx);
+
+void lis3dhtr_sim_get_stats(lis3dhtr_sim_stats_t *stats);
+
+/**
+ * Bus side, called by the driver instead of the I2C transfers. Bit 7 of reg
+ * enables address auto increment as on the real device.
+ */
+void lis3dhtr_sim_write(uint8_t reg, uint8_t val);
+void lis3dhtr_sim_read(uint8_t reg, uint8_t *buf, uint16_t len);
+
+#endif /* LIS3DHTR_SIM_H */
@@ -0,0 +1,82 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _EI_CLASSIFIER_EON_PROFILE_H_
+#define _EI_CLASSIFIER_EON_PROFILE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Per-layer profiling of EON compiled models. When enabled, every invoke
+ * records the time spent in each node together with its op and tensor
+ * sizes; the compiled model exposes them through its _profile() function.
+ */
+#ifndef EI_CLASSIFIER_PROFILE_LAYERS
+#define EI_CLASSIFIER_PROFILE_LAYERS 0
+#endif // EI_CLASSIFIER_PROFILE_LAYERS
+
+#if EI_CLASSIFIER_PROFILE_LAYERS == 1
+#if defined(ESP_PLATFORM)
+#include "esp_cpu.h"
+#define EI_EON_PROFILE_UNIT "cycles"
+static inline uint32_t ei_eon_profile_ticks(void) {
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+#else
+#include <chrono>
+#define EI_EON_PROFILE_UNIT "ns"
+static inline uint32_t ei_eon_profile_ticks(void) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif // ESP_PLATFORM
+#else
+#define EI_EON_PROFILE_UNIT ""
+#endif // EI_CLASSIFIER_PROFILE_LAYERS == 1
+
+typedef struct {
+    /** Builtin op name, e.g. "CONV_2D" */
+    const char *op;
+    /** Time of the last invoke, in EI_EON_PROFILE_UNIT */
+    uint32_t ticks;
+    /** Activation inputs read from the arena */
+    uint32_t input_bytes;
+    /** Constant inputs (weights, biases, shapes) */
+    uint32_t weight_bytes;
+    uint32_t output_bytes;
+} ei_eon_layer_profile_t;
+
+#endif // _EI_CLASSIFIER_EON_PROFILE_H_
@@ -0,0 +1,136 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef _EI_CLASSIFIER_IMAGE_SCALING_H_
+#define _EI_CLASSIFIER_IMAGE_SCALING_H_
+
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "edge-impulse-sdk/classifier/ei_quantize.h"
+
+/**
+ * @brief Describe an image scaling mode as a per-channel affine transform
+ *
+ * @return false if the mode does not change the features
+ */
+__attribute__((unused)) static bool ei_input_affine_from_scaling(int image_scaling, ei_input_affine_t *affine)
+{
+    static const float torch_mean[] = { 0.485, 0.456, 0.406 };
+    static const float torch_std[] = { 0.229, 0.224, 0.225 };
+    // This is ordered BGR
+    static const float tao_mean[] = { 103.939, 116.779, 123.68 };
+
+    for (uint8_t c = 0; c < 3; c++) {
+        affine->src[c] = c;
+    }
+    affine->channels = 1;
+
+    switch (image_scaling) {
+        case EI_CLASSIFIER_IMAGE_SCALING_0_255:
+            affine->mul[0] = 255.0f;
+            affine->add[0] = 0.0f;
+            return true;
+        case EI_CLASSIFIER_IMAGE_SCALING_MIN128_127:
+            affine->mul[0] = 255.0f;
+            affine->add[0] = -128.0f;
+            return true;
+        case EI_CLASSIFIER_IMAGE_SCALING_MIN1_1:
+            affine->mul[0] = 2.0f;
+            affine->add[0] = -1.0f;
+            return true;
+        case EI_CLASSIFIER_IMAGE_SCALING_TORCH:
+            affine->channels = 3;
+            for (uint8_t c = 0; c < 3; c++) {
+                affine->mul[c] = 1.0f / torch_std[c];
+                affine->add[c] = -torch_mean[c] / torch_std[c];
+            }
+            return true;
+        case EI_CLASSIFIER_IMAGE_SCALING_BGR_SUBTRACT_IMAGENET_MEAN:
+            // RGB to BGR
+            affine->channels = 3;
+            for (uint8_t c = 0; c < 3; c++) {
+                affine->src[c] = 2 - c;
+                affine->mul[c] = 255.0f;
+                affine->add[c] = -tao_mean[c];
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief The transform that undoes `affine`
+ */
+__attribute__((unused)) static void ei_input_affine_invert(const ei_input_affine_t *affine, ei_input_affine_t *inverse)
+{
+    inverse->channels = affine->channels;
+    for (uint8_t c = 0; c < affine->channels; c++) {
+        uint8_t src = affine->src[c];
+        inverse->src[src] = c;
+        inverse->mul[src] = 1.0f / affine->mul[c];
+        inverse->add[src] = -affine->add[c] / affine->mul[c];
+    }
+}
+
+/**
+ * @brief Apply an affine transform in place, one pass over the buffer
+ *
+ * @param buffer  Features, interleaved per channel
+ * @param count   Number of features (a multiple of affine->channels)
+ */
+__attribute__((unused)) static void ei_apply_input_affine(float *buffer, size_t count, const ei_input_affine_t *affine)
+{
+    if (affine->channels == 1) {
+        const float mul = affine->mul[0];
+        const float add = affine->add[0];
+        for (size_t ix = 0; ix < count; ix++) {
+            buffer[ix] = buffer[ix] * mul + add;
+        }
+        return;
+    }
+
+    const float m0 = affine->mul[0], m1 = affine->mul[1], m2 = affine->mul[2];
+    const float a0 = affine->add[0], a1 = affine->add[1], a2 = affine->add[2];
+    const uint8_t s0 = affine->src[0], s1 = affine->src[1], s2 = affine->src[2];
+
+    for (size_t ix = 0; ix + 2 < count; ix += 3) {
+        const float in[3] = { buffer[ix], buffer[ix + 1], buffer[ix + 2] };
+        buffer[ix + 0] = in[s0] * m0 + a0;
+        buffer[ix + 1] = in[s1] * m1 + a1;
+        buffer[ix + 2] = in[s2] * m2 + a2;
+    }
+}
+
+#endif // _EI_CLASSIFIER_IMAGE_SCALING_H_
@@ -36,8 +36,10 @@
 #define _EDGE_IMPULSE_MODEL_TYPES_H_
 
 #include <stdint.h>
+#include <new>
 
 #include "edge-impulse-sdk/classifier/ei_classifier_types.h"
+#include "edge-impulse-sdk/classifier/ei_eon_profile.h"
 #include "edge-impulse-sdk/dsp/ei_dsp_handle.h"
 #include "edge-impulse-sdk/dsp/numpy.hpp"
 #if EI_CLASSIFIER_USE_FULL_TFLITE || (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_AKIDA) || (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_MEMRYX)
@@ -75,6 +77,7 @@
 
 // These must match the enum values in TensorFlow Lite's "TfLiteType"
 #define EI_CLASSIFIER_DATATYPE_FLOAT32           1
+#define EI_CLASSIFIER_DATATYPE_UINT8             3
 #define EI_CLASSIFIER_DATATYPE_INT8              9
 
 #define EI_CLASSIFIER_LAST_LAYER_UNKNOWN               -1
@@ -305,6 +308,9 @@ typedef struct {
     TfLiteStatus (*model_reset)(void (*free)(void* ptr));
     TfLiteStatus (*model_input)(int, TfLiteTensor*);
     TfLiteStatus (*model_output)(int, TfLiteTensor*);
+    TfLiteStatus (*model_profile)(const ei_eon_layer_profile_t**, size_t*);
+    /* frees what model_init keeps across model_reset, may be nullptr */
+    void (*model_release)(void);
 } ei_config_tflite_eon_graph_t;
 
 typedef struct {
@@ -384,6 +390,22 @@ typedef struct {
     float frequency;
 } ei_input_params;
 
+/**
+ * Two stage cascade. The gate learning block runs first; the learning
+ * blocks after it only run when the gate score reaches the threshold.
+ */
+typedef struct {
+    uint32_t gate_block_id;
+    /** Gate output read as the score, e.g. the "not background" class */
+    uint16_t score_index;
+    float threshold;
+    /** EI_CLASSIFIER_DATATYPE_* of the gate raw output */
+    uint8_t output_datatype;
+    /** Dequantization of the gate output when it is left quantized */
+    float scale;
+    int32_t zero_point;
+} ei_cascade_config_t;
+
 typedef struct ei_impulse {
     /* project details */
     uint32_t project_id;
@@ -435,6 +457,9 @@ typedef struct ei_impulse {
     uint8_t results_type;
     uint8_t freeform_outputs_size;
     uint32_t *freeform_outputs;
+
+    /* optional early exit, nullptr runs every learning block */
+    const ei_cascade_config_t *cascade = nullptr;
 } ei_impulse_t;
 
 class ei_impulse_state_t {
@@ -493,25 +518,233 @@ public:
     }
 };
 
+/**
+ * Buffers that process_impulse() and process_impulse_continuous() need on
+ * every call: the feature matrices of the DSP blocks, the feature and raw
+ * output arrays and (when not part of the result struct) the classification
+ * array. Sized once from the impulse metadata and reused across calls.
+ */
+class ei_impulse_arena_t {
+public:
+    const ei_impulse_t *impulse;
+    bool ready = false;
+    /* one entry per DSP block followed by one per learning block */
+    ei_feature_t *features = nullptr;
+    ei_feature_t *raw_outputs = nullptr;
+    size_t raw_outputs_size = 0;
+    /* one matrix per DSP block, all views into feature_buffer */
+    ei::matrix_t *matrices = nullptr;
+    float *feature_buffer = nullptr;
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+    ei_impulse_result_classification_t *classification = nullptr;
+    size_t classification_size = 0;
+    /* one classification array per window of run_classifier_batch() */
+    ei_impulse_result_classification_t *batch_classification = nullptr;
+    size_t batch_windows = 0;
+#endif
+
+    ei_impulse_arena_t(const ei_impulse_t *impulse)
+        : impulse(impulse)
+    {
+    }
+
+    /* owns its buffers, a copy would free them twice */
+    ei_impulse_arena_t(const ei_impulse_arena_t &) = delete;
+    ei_impulse_arena_t &operator=(const ei_impulse_arena_t &) = delete;
+
+    /**
+     * @brief Allocate all buffers, does nothing if already done
+     * @return false if out of memory
+     */
+    bool prepare()
+    {
+        if (ready) {
+            return true;
+        }
+
+        const size_t dsp_blocks = impulse->dsp_blocks_size;
+        const size_t feature_count = dsp_blocks + impulse->learning_blocks_size;
+        size_t feature_buffer_size = 0;
+
+        for (size_t ix = 0; ix < dsp_blocks; ix++) {
+            feature_buffer_size += impulse->dsp_blocks[ix].n_output_features;
+        }
+
+        raw_outputs_size = impulse->output_tensors_size > impulse->learning_blocks_size ?
+            impulse->output_tensors_size : impulse->learning_blocks_size;
+
+        features = (ei_feature_t*)ei_calloc(feature_count > 0 ? feature_count : 1, sizeof(ei_feature_t));
+        raw_outputs = (ei_feature_t*)ei_calloc(raw_outputs_size > 0 ? raw_outputs_size : 1, sizeof(ei_feature_t));
+        matrices = (ei::matrix_t*)ei_malloc((dsp_blocks > 0 ? dsp_blocks : 1) * sizeof(ei::matrix_t));
+        feature_buffer = (float*)ei_calloc(feature_buffer_size > 0 ? feature_buffer_size : 1, sizeof(float));
+        if (!features || !raw_outputs || !matrices || !feature_buffer) {
+            release();
+            return false;
+        }
+
+        size_t offset = 0;
+        for (size_t ix = 0; ix < dsp_blocks; ix++) {
+            ::new (&matrices[ix]) ei::matrix_t(1, impulse->dsp_blocks[ix].n_output_features, feature_buffer + offset);
+            offset += impulse->dsp_blocks[ix].n_output_features;
+        }
+
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+        classification_size = 0;
+        if (impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION ||
+            impulse->results_type == EI_CLASSIFIER_TYPE_REGRESSION) {
+    #ifdef EI_DSP_RESULT_OVERRIDE
+            classification_size = EI_DSP_RESULT_OVERRIDE;
+    #else
+            classification_size = impulse->label_count;
+    #endif
+        }
+        if (classification_size > 0) {
+            classification = (ei_impulse_result_classification_t*)ei_calloc(
+                classification_size, sizeof(ei_impulse_result_classification_t));
+            if (!classification) {
+                release();
+                return false;
+            }
+        }
+#endif
+
+        ready = true;
+        return true;
+    }
+
+    /**
+     * @brief Point a DSP block's feature matrix back at its slice of the
+     * arena and clear it, DSP blocks may have reshaped it on the last call
+     */
+    ei::matrix_t *get_dsp_matrix(size_t ix)
+    {
+        size_t offset = 0;
+        for (size_t jx = 0; jx < ix; jx++) {
+            offset += impulse->dsp_blocks[jx].n_output_features;
+        }
+
+        ei::matrix_t *matrix = &matrices[ix];
+        matrix->buffer = feature_buffer + offset;
+        matrix->rows = 1;
+        matrix->cols = impulse->dsp_blocks[ix].n_output_features;
+        memset(matrix->buffer, 0, matrix->cols * sizeof(float));
+        return matrix;
+    }
+
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+    /**
+     * @brief Reset labels and scores for a new result
+     */
+    ei_impulse_result_classification_t *get_classification()
+    {
+        for (size_t ix = 0; ix < classification_size; ix++) {
+    #ifdef EI_DSP_RESULT_OVERRIDE
+            classification[ix].label = "";
+    #else
+            classification[ix].label = impulse->categories[ix];
+    #endif
+            classification[ix].value = 0.0f;
+        }
+        return classification;
+    }
+
+    /**
+     * @brief Make room for the classification of `windows` batch results,
+     * kept until a batch needs more or the arena is released
+     * @return false if out of memory
+     */
+    bool prepare_batch(size_t windows)
+    {
+        if (windows <= batch_windows || classification_size == 0) {
+            return true;
+        }
+
+        ei_free(batch_classification);
+        batch_classification = (ei_impulse_result_classification_t*)ei_calloc(
+            windows * classification_size, sizeof(ei_impulse_result_classification_t));
+        batch_windows = batch_classification ? windows : 0;
+        return batch_classification != nullptr;
+    }
+
+    /**
+     * @brief Copy the classification of the last result into the slot of
+     * batch window `ix`, prepare_batch() must have made room for it
+     */
+    ei_impulse_result_classification_t *keep_batch_classification(size_t ix)
+    {
+        if (classification_size == 0) {
+            return classification;
+        }
+
+        ei_impulse_result_classification_t *slot = batch_classification + ix * classification_size;
+        memcpy(slot, classification, classification_size * sizeof(ei_impulse_result_classification_t));
+        return slot;
+    }
+#endif
+
+    void release()
+    {
+        if (matrices && ready) {
+            for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+                matrices[ix].~ei_matrix();
+            }
+        }
+        ei_free(features);
+        ei_free(raw_outputs);
+        ei_free(matrices);
+        ei_free(feature_buffer);
+        features = nullptr;
+        raw_outputs = nullptr;
+        matrices = nullptr;
+        feature_buffer = nullptr;
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+        ei_free(classification);
+        classification = nullptr;
+        classification_size = 0;
+        ei_free(batch_classification);
+        batch_classification = nullptr;
+        batch_windows = 0;
+#endif
+        ready = false;
+    }
+
+    ~ei_impulse_arena_t()
+    {
+        release();
+    }
+};
+
+/** Outcome of the last cascaded inference and how often stage two ran */
+typedef struct {
+    bool rejected;
+    float last_score;
+    uint32_t gate_runs;
+    uint32_t stage_two_runs;
+} ei_cascade_state_t;
+
 class ei_impulse_handle_t {
 public:
     ei_impulse_handle_t(const ei_impulse_t *impulse)
         : state(impulse)
+        , arena(impulse)
         , impulse(impulse)
         , post_processing_state(nullptr)
 #if EI_CLASSIFIER_FREEFORM_OUTPUT
         , freeform_outputs(nullptr)
 #endif //EI_CLASSIFIER_FREEFORM_OUTPUT
         , input_params(nullptr)
+        , cascade()
         { /* ei_impulse_handle_t ctor */};
 
     ei_impulse_state_t state;
+    ei_impulse_arena_t arena;
     const ei_impulse_t *impulse;
     void** post_processing_state;
 #if EI_CLASSIFIER_FREEFORM_OUTPUT == 1
     ei::matrix_t *freeform_outputs;
 #endif // EI_CLASSIFIER_FREEFORM_OUTPUT
     ei_input_params* input_params;
+    ei_cascade_state_t cascade;
 };
 
 typedef struct {
@@ -56,6 +56,12 @@ void ei_print_results(ei_impulse_handle_t *impulse_handle, ei_impulse_result_t *
     const ei_impulse_t *impulse = impulse_handle->impulse;
     ei_impulse_result_t result = *result_ptr;
 
+    if (impulse->cascade != nullptr && impulse_handle->cascade.rejected) {
+        ei_printf("Cascade: rejected by gate, score ");
+        ei_printf_float(impulse_handle->cascade.last_score);
+        ei_printf("\n");
+    }
+
     if (impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION) {
         ei_printf("#Classification predictions:\n");
         for (uint16_t i = 0; i < impulse->label_count; i++) {
@@ -160,6 +166,24 @@ void ei_print_results(ei_impulse_handle_t *impulse_handle, ei_impulse_result_t *
     }
 }
 
+/**
+ * @brief      Print how often the gate of a cascaded impulse let windows
+ *             through to stage two. Does nothing for impulses without a cascade.
+ * @param      impulse_handle  Pointer to impulse handle (e.g. &ei_default_impulse)
+ */
+__attribute__((unused)) static void ei_print_cascade_stats(ei_impulse_handle_t *impulse_handle) {
+    const ei_cascade_state_t *cascade = &impulse_handle->cascade;
+
+    if (impulse_handle->impulse->cascade == nullptr || cascade->gate_runs == 0) {
+        return;
+    }
+
+    ei_printf("Cascade: stage two ran for %u of %u windows (",
+        (unsigned int)cascade->stage_two_runs, (unsigned int)cascade->gate_runs);
+    ei_printf_float(100.0f * (float)cascade->stage_two_runs / (float)cascade->gate_runs);
+    ei_printf(" %%)\n");
+}
+
 /**
  * @brief      Print the time it took for DSP/Classification/Anomaly blocks to run.
  *             this prints data in ms., unless <1ms. then it prints data in us.
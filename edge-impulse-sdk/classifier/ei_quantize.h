@@ -37,6 +37,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <type_traits>
 
 static int32_t pre_cast_quantize(float value, float scale, int32_t zero_point, bool is_signed) {
 
@@ -46,4 +47,58 @@ static int32_t pre_cast_quantize(float value, float scale, int32_t zero_point, b
     return std::min( std::max( static_cast<int32_t>(round(value / scale)) + zero_point, min_value), max_value);
 }
 
+/**
+ * Per-channel `x * mul + add` applied to features while they are quantized,
+ * so scaling does not need its own pass over the float features.
+ * Output channel c reads input channel src[c].
+ */
+typedef struct {
+    float mul[3];
+    float add[3];
+    uint8_t src[3];
+    uint8_t channels;
+} ei_input_affine_t;
+
+/**
+ * @brief Quantize float features into an int8 or uint8 buffer in one pass
+ *
+ * @param in          Features
+ * @param count       Number of features (a multiple of affine->channels)
+ * @param out         Quantized output
+ * @param scale       Quantization scale of the output
+ * @param zero_point  Quantization zero point of the output
+ * @param affine      Optional scaling applied before quantization
+ */
+template<typename T>
+static void quantize_features(const float *in, size_t count, T *out, float scale,
+    int32_t zero_point, const ei_input_affine_t *affine = nullptr)
+{
+    const int32_t max_value = std::is_signed<T>::value ? 127 : 255;
+    const int32_t min_value = std::is_signed<T>::value ? -128 : 0;
+    const float inv_scale = 1.0f / scale;
+
+    if (affine == nullptr) {
+        for (size_t ix = 0; ix < count; ix++) {
+            int32_t q = static_cast<int32_t>(roundf(in[ix] * inv_scale)) + zero_point;
+            out[ix] = static_cast<T>(std::min(std::max(q, min_value), max_value));
+        }
+        return;
+    }
+
+    // fold the quantization scale into the affine transform
+    float mul[3], add[3];
+    for (size_t c = 0; c < affine->channels; c++) {
+        mul[c] = affine->mul[c] * inv_scale;
+        add[c] = affine->add[c] * inv_scale;
+    }
+
+    for (size_t ix = 0; ix < count; ix += affine->channels) {
+        for (size_t c = 0; c < affine->channels; c++) {
+            float v = in[ix + affine->src[c]] * mul[c] + add[c];
+            int32_t q = static_cast<int32_t>(roundf(v)) + zero_point;
+            out[ix + c] = static_cast<T>(std::min(std::max(q, min_value), max_value));
+        }
+    }
+}
+
 #endif  //!__EI_QUANTIZE__H__
\ No newline at end of file
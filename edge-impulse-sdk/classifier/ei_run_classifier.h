@@ -43,12 +43,21 @@
 #include "ei_signal_with_axes.h"
 #include "postprocessing/ei_postprocessing.h"
 #include "edge-impulse-sdk/classifier/ei_data_normalization.h"
+#include "edge-impulse-sdk/classifier/ei_image_scaling.h"
 #include "edge-impulse-sdk/classifier/ei_print_results.h"
 
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/porting/ei_memory_placement.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
 #include <memory>
 
+// Fail instead of allocating the impulse arena lazily in process_impulse(),
+// the arena then has to come from init_impulse(). This only covers the
+// arena, DSP blocks and the inference engine still allocate per run.
+#ifndef EI_CLASSIFIER_REQUIRE_ARENA_INIT
+#define EI_CLASSIFIER_REQUIRE_ARENA_INIT 0
+#endif // EI_CLASSIFIER_REQUIRE_ARENA_INIT
+
 #if EI_CLASSIFIER_LOAD_ANOMALY_H
 #include "inferencing_engines/anomaly.h"
 #endif // EI_CLASSIFIER_LOAD_ANOMALY_H
@@ -105,6 +114,8 @@ extern "C" EI_IMPULSE_ERROR run_inference(ei_impulse_handle_t *handle, ei_featur
 extern "C" EI_IMPULSE_ERROR run_classifier_image_quantized(const ei_impulse_t *impulse, signal_t *signal, ei_impulse_result_t *result, bool debug);
 static EI_IMPULSE_ERROR can_run_classifier_image_quantized(const ei_impulse_t *impulse, ei_learning_block_t block_ptr);
 static void ei_result_struct_timing_us_to_ms(ei_impulse_result_t *result);
+void run_classifier_init(ei_impulse_handle_t *handle);
+void run_classifier_deinit(ei_impulse_handle_t *handle);
 
 #if EI_CLASSIFIER_LOAD_IMAGE_SCALING
 EI_IMPULSE_ERROR ei_scale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fmatrix);
@@ -131,6 +142,52 @@ __attribute__((unused)) void display_results(ei_impulse_handle_t *handle, ei_imp
     display_postprocessing(handle, result);
 }
 
+/**
+ * @brief      Read the cascade score from the raw output of the gate block
+ *
+ * @return     EI_IMPULSE_OUTPUT_TENSOR_NULL if the gate produced no output
+ *             or the score index is out of range
+ */
+static EI_IMPULSE_ERROR ei_cascade_gate_score(const ei_impulse_t *impulse, ei_impulse_result_t *result, float *score)
+{
+    const ei_cascade_config_t *cascade = impulse->cascade;
+    const uint32_t ix = cascade->score_index;
+
+    switch (cascade->output_datatype) {
+        case EI_CLASSIFIER_DATATYPE_FLOAT32: {
+            ei::matrix_t *mtx = nullptr;
+            if (!find_mtx_by_idx(result->_raw_outputs, &mtx, cascade->gate_block_id, impulse->output_tensors_size)
+                || ix >= mtx->rows * mtx->cols) {
+                return EI_IMPULSE_OUTPUT_TENSOR_NULL;
+            }
+            *score = mtx->buffer[ix];
+            break;
+        }
+        case EI_CLASSIFIER_DATATYPE_INT8: {
+            ei::matrix_i8_t *mtx = nullptr;
+            if (!find_mtx_by_idx(result->_raw_outputs, &mtx, cascade->gate_block_id, impulse->output_tensors_size)
+                || ix >= mtx->rows * mtx->cols) {
+                return EI_IMPULSE_OUTPUT_TENSOR_NULL;
+            }
+            *score = static_cast<float>(mtx->buffer[ix] - cascade->zero_point) * cascade->scale;
+            break;
+        }
+        case EI_CLASSIFIER_DATATYPE_UINT8: {
+            ei::matrix_u8_t *mtx = nullptr;
+            if (!find_mtx_by_idx(result->_raw_outputs, &mtx, cascade->gate_block_id, impulse->output_tensors_size)
+                || ix >= mtx->rows * mtx->cols) {
+                return EI_IMPULSE_OUTPUT_TENSOR_NULL;
+            }
+            *score = static_cast<float>(mtx->buffer[ix] - cascade->zero_point) * cascade->scale;
+            break;
+        }
+        default:
+            return EI_IMPULSE_OUTPUT_TENSOR_NULL;
+    }
+
+    return EI_IMPULSE_OK;
+}
+
 /**
  * @brief      Do inferencing over the processed feature matrix
  *
@@ -148,16 +205,37 @@ extern "C" EI_IMPULSE_ERROR run_inference(
     bool debug = false)
 {
     auto& impulse = handle->impulse;
+    const ei_cascade_config_t *cascade = impulse->cascade;
+
+    handle->cascade.rejected = false;
+
     for (size_t ix = 0; ix < impulse->learning_blocks_size; ix++) {
 
         ei_learning_block_t block = impulse->learning_blocks[ix];
 
+        // blocks after a rejecting gate are skipped, their outputs stay empty
+        if (handle->cascade.rejected) {
+            continue;
+        }
+
 #if EI_CLASSIFIER_LOAD_IMAGE_SCALING
         auto start_scale_matrix_us = ei_read_timer_us();
 
+        // quantized TFLite inputs apply the scaling while they are filled
+        bool scaling_fused = false;
+#if EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE
+        ei_input_affine_t affine;
+        scaling_fused = block.infer_fn == run_nn_inference &&
+            ei_can_fuse_input_scaling(block.image_scaling, (ei_learning_block_config_tflite_graph_t*)block.config) &&
+            ei_input_affine_from_scaling(block.image_scaling, &affine);
+#endif
+
         // we do not plan to have multiple dsp blocks with image
         // so just apply scaling to the first one
-        EI_IMPULSE_ERROR scale_res = ei_scale_fmatrix(&block, fmatrix[0].matrix);
+        EI_IMPULSE_ERROR scale_res = EI_IMPULSE_OK;
+        if (!scaling_fused) {
+            scale_res = ei_scale_fmatrix(&block, fmatrix[0].matrix);
+        }
         if (scale_res != EI_IMPULSE_OK) {
             return scale_res;
         }
@@ -174,7 +252,7 @@ extern "C" EI_IMPULSE_ERROR run_inference(
         auto start_unscale_matrix_us = ei_read_timer_us();
 
         // undo scaling, only if we have multiple learn blocks... otherwise just leave scaled
-        if (impulse->learning_blocks_size > 1) {
+        if (impulse->learning_blocks_size > 1 && !scaling_fused) {
             scale_res = ei_unscale_fmatrix(&block, fmatrix[0].matrix);
             if (scale_res != EI_IMPULSE_OK) {
                 return scale_res;
@@ -187,6 +265,31 @@ extern "C" EI_IMPULSE_ERROR run_inference(
         result->timing.dsp_us += (end_unscale_matrix_us - start_unscale_matrix_us) +
                                  (end_scale_matrix_us - start_scale_matrix_us);
 #endif
+
+        if (cascade != nullptr && block.blockId == cascade->gate_block_id) {
+            EI_IMPULSE_ERROR score_res = ei_cascade_gate_score(impulse, result, &handle->cascade.last_score);
+            if (score_res != EI_IMPULSE_OK) {
+                ei_printf("ERR: Cascade gate block %u has no output %u\n",
+                    (unsigned int)cascade->gate_block_id, (unsigned int)cascade->score_index);
+                return score_res;
+            }
+
+            handle->cascade.gate_runs++;
+            if (handle->cascade.last_score < cascade->threshold) {
+                handle->cascade.rejected = true;
+            }
+            else if (ix + 1 < impulse->learning_blocks_size) {
+                handle->cascade.stage_two_runs++;
+            }
+        }
+    }
+
+    // a rejected window reports every class at 0
+    if (handle->cascade.rejected && impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION) {
+        for (uint16_t ix = 0; ix < impulse->label_count; ix++) {
+            result->classification[ix].label = impulse->categories[ix];
+            result->classification[ix].value = 0.0f;
+        }
     }
 
     if (ei_run_impulse_check_canceled() == EI_IMPULSE_CANCELED) {
@@ -196,6 +299,30 @@ extern "C" EI_IMPULSE_ERROR run_inference(
     return EI_IMPULSE_OK;
 }
 
+/**
+ * @brief      Make sure the handle's arena holds the buffers for
+ *             process_impulse(). With EI_CLASSIFIER_REQUIRE_ARENA_INIT the
+ *             arena is never allocated here, init_impulse() has to run
+ *             first.
+ */
+static EI_IMPULSE_ERROR prepare_impulse_arena(ei_impulse_handle_t *handle)
+{
+    if (handle->arena.ready) {
+        return EI_IMPULSE_OK;
+    }
+
+#if EI_CLASSIFIER_REQUIRE_ARENA_INIT
+    ei_printf("ERR: Impulse arena not allocated, call init_impulse() or run_classifier_init() first\n");
+    return EI_IMPULSE_ALLOC_FAILED;
+#else
+    if (!handle->arena.prepare()) {
+        ei_printf("ERR: Out of memory, can't allocate impulse arena\n");
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+    return EI_IMPULSE_OK;
+#endif // EI_CLASSIFIER_REQUIRE_ARENA_INIT
+}
+
 /**
  * @brief      Process a complete impulse
  *
@@ -218,40 +345,18 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 
     memset(result, 0, sizeof(ei_impulse_result_t));
 
-#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
-    static std::vector<ei_impulse_result_classification_t> classification_results;
-    classification_results.clear(); // todo, should not clear and re-gen this every time...
-
-    if (handle->impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION ||
-        handle->impulse->results_type == EI_CLASSIFIER_TYPE_REGRESSION) {
-    #ifdef EI_DSP_RESULT_OVERRIDE
-        for (size_t ix = 0; ix < EI_DSP_RESULT_OVERRIDE; ix++) {
-            ei_impulse_result_classification_t classification = {
-                .label = "",
-                .value = 0.0f
-            };
-            classification_results.push_back(classification);
-        }
-    #else
-        for (size_t ix = 0; ix < handle->impulse->label_count; ix++) {
-            ei_impulse_result_classification_t classification = {
-                .label = handle->impulse->categories[ix],
-                .value = 0.0f
-            };
-            classification_results.push_back(classification);
-        }
-    #endif // EI_DSP_RESULT_OVERRIDE
+    EI_IMPULSE_ERROR arena_res = prepare_impulse_arena(handle);
+    if (arena_res != EI_IMPULSE_OK) {
+        return arena_res;
     }
+    ei_impulse_arena_t *arena = &handle->arena;
 
-    result->classification = classification_results.data();
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+    result->classification = arena->get_classification();
 #endif // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
 
-    uint8_t num_results = handle->impulse->output_tensors_size;
-
-    std::unique_ptr<ei_feature_t[]> raw_results_ptr(new ei_feature_t[num_results]);
-
-    result->_raw_outputs = raw_results_ptr.get();
-    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * num_results);
+    result->_raw_outputs = arena->raw_outputs;
+    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * arena->raw_outputs_size);
 
     EI_IMPULSE_ERROR res = EI_IMPULSE_OK;
     (void)res; // Get around -Werror=unused-variable if neither of the calls below are compiled in (e.g. unit-tests/hr)
@@ -280,47 +385,18 @@ extern "C" EI_IMPULSE_ERROR process_impulse(ei_impulse_handle_t *handle,
 #endif // EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TENSAIFLOW || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ONNX_TIDL) || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_DRPAI || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_ATON
     uint32_t block_num = handle->impulse->dsp_blocks_size;
 
-    // smart pointer to features array
-    std::unique_ptr<ei_feature_t[]> features_ptr(new ei_feature_t[block_num]);
-    ei_feature_t* features = features_ptr.get();
-
-    if (features == nullptr) {
-        ei_printf("ERR: Out of memory, can't allocate features\n");
-        return EI_IMPULSE_ALLOC_FAILED;
-    }
-
+    ei_feature_t* features = arena->features;
     memset(features, 0, sizeof(ei_feature_t) * block_num);
 
-    // have it outside of the loop to avoid going out of scope
-    std::unique_ptr<std::unique_ptr<ei::matrix_t>[]> matrix_ptrs_ptr(new std::unique_ptr<ei::matrix_t>[block_num]);
-    std::unique_ptr<ei::matrix_t> *matrix_ptrs = matrix_ptrs_ptr.get();
-
-    if (matrix_ptrs == nullptr) {
-        delete[] matrix_ptrs;
-        ei_printf("ERR: Out of memory, can't allocate matrix_ptrs\n");
-        return EI_IMPULSE_ALLOC_FAILED;
-    }
-
     uint64_t dsp_start_us = ei_read_timer_us();
 
     size_t out_features_index = 0;
 
     for (size_t ix = 0; ix < handle->impulse->dsp_blocks_size; ix++) {
         ei_model_dsp_t block = handle->impulse->dsp_blocks[ix];
+        EiMemoryPlacement placement(EI_MEMORY_CLASS_SCRATCH);
 
-        matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
-        if (matrix_ptrs[ix] == nullptr) {
-            ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-            return EI_IMPULSE_ALLOC_FAILED;
-        }
-
-        if (matrix_ptrs[ix]->buffer == nullptr) {
-            ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-            delete[] matrix_ptrs;
-            return EI_IMPULSE_ALLOC_FAILED;
-        }
-
-        features[ix].matrix = matrix_ptrs[ix].get();
+        features[ix].matrix = arena->get_dsp_matrix(ix);
         features[ix].blockId = block.blockId;
 
         if (out_features_index + block.n_output_features > handle->impulse->nn_input_frame_size) {
@@ -438,6 +514,10 @@ extern "C" EI_IMPULSE_ERROR init_impulse(ei_impulse_handle_t *handle) {
         return EI_IMPULSE_OUT_OF_MEMORY;
     }
     handle->state.reset();
+    if (!handle->arena.prepare()) {
+        ei_printf("ERR: Out of memory, can't allocate impulse arena\n");
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
     return EI_IMPULSE_OK;
 }
 
@@ -462,32 +542,14 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
     memset(result, 0, sizeof(ei_impulse_result_t));
 
-#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
-    static std::vector<ei_impulse_result_classification_t> classification_results;
-    classification_results.clear(); // todo, should not clear and re-gen this every time...
-
-    if (handle->impulse->results_type == EI_CLASSIFIER_TYPE_CLASSIFICATION ||
-        handle->impulse->results_type == EI_CLASSIFIER_TYPE_REGRESSION) {
-    #ifdef EI_DSP_RESULT_OVERRIDE
-        for (size_t ix = 0; ix < EI_DSP_RESULT_OVERRIDE; ix++) {
-            ei_impulse_result_classification_t classification = {
-                .label = "",
-                .value = 0.0f
-            };
-            classification_results.push_back(classification);
-        }
-    #else
-        for (size_t ix = 0; ix < handle->impulse->label_count; ix++) {
-            ei_impulse_result_classification_t classification = {
-                .label = handle->impulse->categories[ix],
-                .value = 0.0f
-            };
-            classification_results.push_back(classification);
-        }
-    #endif
+    EI_IMPULSE_ERROR arena_res = prepare_impulse_arena(handle);
+    if (arena_res != EI_IMPULSE_OK) {
+        return arena_res;
     }
+    ei_impulse_arena_t *arena = &handle->arena;
 
-    result->classification = classification_results.data();
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+    result->classification = arena->get_classification();
 
 #else // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 1
 
@@ -498,10 +560,8 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
 #endif // EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
 
-    // smart pointer to results array
-    std::unique_ptr<ei_feature_t[]> raw_results_ptr(new ei_feature_t[handle->impulse->learning_blocks_size]);
-    result->_raw_outputs = raw_results_ptr.get();
-    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * handle->impulse->learning_blocks_size);
+    result->_raw_outputs = arena->raw_outputs;
+    memset(result->_raw_outputs, 0, sizeof(ei_feature_t) * arena->raw_outputs_size);
 
     auto impulse = handle->impulse;
     static ei::matrix_t static_features_matrix(1, impulse->nn_input_frame_size);
@@ -517,6 +577,7 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
     for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
         ei_model_dsp_t block = impulse->dsp_blocks[ix];
+        EiMemoryPlacement placement(EI_MEMORY_CLASS_SCRATCH);
 
         if (out_features_index + block.n_output_features > impulse->nn_input_frame_size) {
             ei_printf("ERR: Would write outside feature buffer\n");
@@ -577,40 +638,15 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
 
         uint32_t block_num = impulse->dsp_blocks_size + impulse->learning_blocks_size;
 
-        // smart pointer to features array
-        std::unique_ptr<ei_feature_t[]> features_ptr(new ei_feature_t[block_num]);
-        ei_feature_t* features = features_ptr.get();
-        if (features == nullptr) {
-            ei_printf("ERR: Out of memory, can't allocate features\n");
-            return EI_IMPULSE_ALLOC_FAILED;
-        }
+        ei_feature_t* features = arena->features;
         memset(features, 0, sizeof(ei_feature_t) * block_num);
 
-        // have it outside of the loop to avoid going out of scope
-        std::unique_ptr<ei::matrix_t> *matrix_ptrs = new std::unique_ptr<ei::matrix_t>[block_num];
-        if (matrix_ptrs == nullptr) {
-            ei_printf("ERR: Out of memory, can't allocate matrix_ptrs\n");
-            return EI_IMPULSE_ALLOC_FAILED;
-        }
-
         out_features_index = 0;
         // iterate over every dsp block and run normalization
         for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
             ei_model_dsp_t block = impulse->dsp_blocks[ix];
-            matrix_ptrs[ix] = std::unique_ptr<ei::matrix_t>(new ei::matrix_t(1, block.n_output_features));
-
-            if (matrix_ptrs[ix] == nullptr) {
-                ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-                return EI_IMPULSE_ALLOC_FAILED;
-            }
 
-            if (matrix_ptrs[ix]->buffer == nullptr) {
-                ei_printf("ERR: Out of memory, can't allocate matrix_ptrs[%lu]\n", (unsigned long)ix);
-                delete[] matrix_ptrs;
-                return EI_IMPULSE_ALLOC_FAILED;
-            }
-
-            features[ix].matrix = matrix_ptrs[ix].get();
+            features[ix].matrix = arena->get_dsp_matrix(ix);
             features[ix].blockId = block.blockId;
 
             /* Create a copy of the matrix for normalization */
@@ -646,7 +682,6 @@ extern "C" EI_IMPULSE_ERROR process_impulse_continuous(ei_impulse_handle_t *hand
         if (ei_impulse_error != EI_IMPULSE_OK) {
             return ei_impulse_error;
         }
-        delete[] matrix_ptrs;
         ei_impulse_error = run_postprocessing(handle, result);
         if (ei_impulse_error != EI_IMPULSE_OK) {
             return ei_impulse_error;
@@ -677,6 +712,11 @@ __attribute__((unused)) static EI_IMPULSE_ERROR can_run_classifier_image_quantiz
         return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
     }
 
+    // the cascade decision is made in run_inference
+    if (impulse->cascade != nullptr) {
+        return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
+    }
+
         // Check if we have tflite graph
     if (block_ptr.infer_fn != run_nn_inference) {
         return EI_IMPULSE_ONLY_SUPPORTED_FOR_IMAGES;
@@ -715,103 +755,22 @@ extern "C" EI_IMPULSE_ERROR run_classifier_image_quantized(
 #endif // #if EI_CLASSIFIER_QUANTIZATION_ENABLED == 1 && (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TENSAIFLOW || EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_DRPAI)
 
 #if EI_CLASSIFIER_LOAD_IMAGE_SCALING
-static const float torch_mean[] = { 0.485, 0.456, 0.406 };
-static const float torch_std[] = { 0.229, 0.224, 0.225 };
-// This is ordered BGR
-static const float tao_mean[] = { 103.939, 116.779, 123.68 };
-
 EI_IMPULSE_ERROR ei_scale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fmatrix) {
-    if (block->image_scaling == EI_CLASSIFIER_IMAGE_SCALING_TORCH) {
-        // @todo; could we write some faster vector math here?
-        for (size_t ix = 0; ix < fmatrix->rows * fmatrix->cols; ix += 3) {
-            fmatrix->buffer[ix + 0] = (fmatrix->buffer[ix + 0] - torch_mean[0]) / torch_std[0];
-            fmatrix->buffer[ix + 1] = (fmatrix->buffer[ix + 1] - torch_mean[1]) / torch_std[1];
-            fmatrix->buffer[ix + 2] = (fmatrix->buffer[ix + 2] - torch_mean[2]) / torch_std[2];
-        }
-    }
-    else if (block->image_scaling == EI_CLASSIFIER_IMAGE_SCALING_0_255) {
-        int scale_res = numpy::scale(fmatrix, 255.0f);
-        if (scale_res != EIDSP_OK) {
-            ei_printf("ERR: Failed to scale matrix (%d)\n", scale_res);
-            return EI_IMPULSE_DSP_ERROR;
-        }
-    }
-    else if (block->image_scaling == EI_CLASSIFIER_IMAGE_SCALING_MIN128_127) {
-        int scale_res = numpy::scale_and_add(fmatrix, 255.0f, -128.0f);
-        if (scale_res != EIDSP_OK) {
-            ei_printf("ERR: Failed to scale matrix (%d)\n", scale_res);
-            return EI_IMPULSE_DSP_ERROR;
-        }
-    }
-    else if (block->image_scaling == EI_CLASSIFIER_IMAGE_SCALING_MIN1_1) {
-        int scale_res = numpy::scale_and_add(fmatrix, 2.0f, -1.0f);
-        if (scale_res != EIDSP_OK) {
-            ei_printf("ERR: Failed to scale matrix (%d)\n", scale_res);
-            return EI_IMPULSE_DSP_ERROR;
-        }
-    }
-    else if (block->image_scaling == EI_CLASSIFIER_IMAGE_SCALING_BGR_SUBTRACT_IMAGENET_MEAN) {
-        int scale_res = numpy::scale(fmatrix, 255.0f);
-        if (scale_res != EIDSP_OK) {
-            ei_printf("ERR: Failed to scale matrix (%d)\n", scale_res);
-            return EI_IMPULSE_DSP_ERROR;
-        }
-        // Transpose RGB to BGR and subtract mean
-        for (size_t ix = 0; ix < fmatrix->rows * fmatrix->cols; ix += 3) {
-            float r = fmatrix->buffer[ix + 0];
-            fmatrix->buffer[ix + 0] = fmatrix->buffer[ix + 2] - tao_mean[0];
-            fmatrix->buffer[ix + 1] -= tao_mean[1];
-            fmatrix->buffer[ix + 2] = r - tao_mean[2];
-        }
+    ei_input_affine_t affine;
+    if (ei_input_affine_from_scaling(block->image_scaling, &affine)) {
+        ei_apply_input_affine(fmatrix->buffer, fmatrix->rows * fmatrix->cols, &affine);
     }
 
     return EI_IMPULSE_OK;
 }
 
 EI_IMPULSE_ERROR ei_unscale_fmatrix(ei_learning_block_t *block, ei::matrix_t *fmatrix) {
-    if (block->image_scaling == EI_CLASSIFIER_IMAGE_SCALING_TORCH) {
-        // @todo; could we write some faster vector math here?
-        for (size_t ix = 0; ix < fmatrix->rows * fmatrix->cols; ix += 3) {
-            fmatrix->buffer[ix + 0] = (fmatrix->buffer[ix + 0] * torch_std[0]) + torch_mean[0];
-            fmatrix->buffer[ix + 1] = (fmatrix->buffer[ix + 1] * torch_std[1]) + torch_mean[1];
-            fmatrix->buffer[ix + 2] = (fmatrix->buffer[ix + 2] * torch_std[2]) + torch_mean[2];
-        }
-    }
-    else if (block->image_scaling == EI_CLASSIFIER_IMAGE_SCALING_MIN128_127) {
-        int scale_res = numpy::scale_and_add(fmatrix, 1.0f / 255.0f, 128.0f / 255.0f);
-        if (scale_res != EIDSP_OK) {
-            ei_printf("ERR: Failed to scale matrix (%d)\n", scale_res);
-            return EI_IMPULSE_DSP_ERROR;
-        }
-    }
-    else if (block->image_scaling == EI_CLASSIFIER_IMAGE_SCALING_MIN1_1) {
-        int scale_res = numpy::scale_and_add(fmatrix, 1.0f / 2.0f, 1.0f / 2.0f);
-        if (scale_res != EIDSP_OK) {
-            ei_printf("ERR: Failed to scale matrix (%d)\n", scale_res);
-            return EI_IMPULSE_DSP_ERROR;
-        }
-    }
-    else if (block->image_scaling == EI_CLASSIFIER_IMAGE_SCALING_0_255) {
-        int scale_res = numpy::scale(fmatrix, 1 / 255.0f);
-        if (scale_res != EIDSP_OK) {
-            ei_printf("ERR: Failed to scale matrix (%d)\n", scale_res);
-            return EI_IMPULSE_DSP_ERROR;
-        }
-    }
-    else if (block->image_scaling == EI_CLASSIFIER_IMAGE_SCALING_BGR_SUBTRACT_IMAGENET_MEAN) {
-        // Transpose BGR to RGB and add mean
-        for (size_t ix = 0; ix < fmatrix->rows * fmatrix->cols; ix += 3) {
-            float b = fmatrix->buffer[ix + 0];
-            fmatrix->buffer[ix + 0] = fmatrix->buffer[ix + 2] + tao_mean[2];
-            fmatrix->buffer[ix + 1] += tao_mean[1];
-            fmatrix->buffer[ix + 2] = b + tao_mean[0];
-        }
-        int scale_res = numpy::scale(fmatrix, 1 / 255.0f);
-        if (scale_res != EIDSP_OK) {
-            ei_printf("ERR: Failed to scale matrix (%d)\n", scale_res);
-            return EI_IMPULSE_DSP_ERROR;
-        }
+    ei_input_affine_t affine, inverse;
+    if (ei_input_affine_from_scaling(block->image_scaling, &affine)) {
+        ei_input_affine_invert(&affine, &inverse);
+        ei_apply_input_affine(fmatrix->buffer, fmatrix->rows * fmatrix->cols, &inverse);
     }
+
     return EI_IMPULSE_OK;
 }
 #endif
@@ -831,6 +790,159 @@ static void ei_result_struct_timing_us_to_ms(ei_impulse_result_t *result) {
     result->timing.postprocessing = (int)((result->timing.postprocessing_us + 500) / 1000);
 }
 
+/* Source signal and window offset used by process_impulse_batch() */
+static signal_t *batch_source_signal = nullptr;
+static size_t batch_source_offset = 0;
+
+static int batch_window_get_data(size_t offset, size_t length, float *out_ptr)
+{
+    return batch_source_signal->get_data(batch_source_offset + offset, length, out_ptr);
+}
+
+/**
+ * @brief      Whether overlapping windows can share DSP work: every DSP block
+ *             has a per-slice version and windows start on slice boundaries
+ */
+static bool can_run_batch_per_slice(const ei_impulse_t *impulse, size_t stride)
+{
+    if (impulse->slices_per_model_window < 2 || impulse->slice_size == 0) {
+        return false;
+    }
+    if (stride % impulse->slice_size != 0 || stride >= impulse->raw_sample_count) {
+        return false;
+    }
+
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        auto extract_fn = impulse->dsp_blocks[ix].extract_fn;
+        if (extract_fn != extract_mfcc_features &&
+            extract_fn != extract_mfe_features &&
+            extract_fn != extract_spectrogram_features) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief      Give a batch result its own copy of the classification. Without
+ *             a classification array in the result struct every result points
+ *             at the handle's array, which only holds the last window.
+ */
+static void batch_keep_result(ei_impulse_handle_t *handle, ei_impulse_result_t *result, size_t ix)
+{
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+    result->classification = handle->arena.keep_batch_classification(ix);
+#endif
+}
+
+/**
+ * Process every window of a long signal, see run_classifier_batch()
+ */
+static EI_IMPULSE_ERROR process_impulse_batch(ei_impulse_handle_t *handle,
+                                              signal_t *signal,
+                                              size_t stride,
+                                              ei_impulse_result_t *results,
+                                              size_t max_results,
+                                              size_t *results_count,
+                                              bool debug,
+                                              bool per_slice)
+{
+    if ((handle == nullptr) || (handle->impulse == nullptr) || (signal == nullptr) ||
+        (results == nullptr) || (results_count == nullptr) || (stride == 0)) {
+        return EI_IMPULSE_INFERENCE_ERROR;
+    }
+
+    const ei_impulse_t *impulse = handle->impulse;
+    const size_t frame_size = impulse->raw_samples_per_frame;
+    const size_t window = impulse->raw_sample_count;
+    const size_t frames = signal->total_length / frame_size;
+
+    *results_count = 0;
+    if (frames < window) {
+        ei_printf("ERR: Signal is shorter than one window (%d < %d frames)\n", (int)frames, (int)window);
+        return EI_IMPULSE_ERROR_SHAPES_DONT_MATCH;
+    }
+
+    signal_t window_signal;
+    window_signal.get_data = &batch_window_get_data;
+    batch_source_signal = signal;
+
+    EI_IMPULSE_ERROR res = EI_IMPULSE_OK;
+
+#if EI_CLASSIFIER_COMPILED == 1
+    ei_eon_session_begin();
+#endif
+
+    if (per_slice && !can_run_batch_per_slice(impulse, stride)) {
+        EI_LOGI("Per-slice batch not possible for this impulse or stride, classifying window by window\n");
+        per_slice = false;
+    }
+
+    if (per_slice) {
+        // resets the continuous state, which is shared by all handles
+        run_classifier_init(handle);
+    }
+
+    res = prepare_impulse_arena(handle);
+#if EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0
+    const size_t windows = (frames - window) / stride + 1;
+    if (res == EI_IMPULSE_OK && !handle->arena.prepare_batch(windows < max_results ? windows : max_results)) {
+        ei_printf("ERR: Out of memory, can't allocate batch results\n");
+        res = EI_IMPULSE_ALLOC_FAILED;
+    }
+#endif
+
+    if (res == EI_IMPULSE_OK && per_slice) {
+        // same path as run_classifier_continuous(): features are computed once
+        // per slice and shifted through the window
+        const size_t slices = frames / impulse->slice_size;
+        const size_t slices_per_stride = stride / impulse->slice_size;
+        ei_impulse_result_t slice_result;
+
+        window_signal.total_length = impulse->slice_size * frame_size;
+
+        for (size_t ix = 0; ix < slices && *results_count < max_results; ix++) {
+            batch_source_offset = ix * impulse->slice_size * frame_size;
+            res = process_impulse_continuous(handle, &window_signal, &slice_result, debug);
+            if (res != EI_IMPULSE_OK) {
+                break;
+            }
+
+            // the window ending with this slice starts at slice ix + 1 - slices_per_model_window
+            if (ix + 1 >= impulse->slices_per_model_window &&
+                (ix + 1 - impulse->slices_per_model_window) % slices_per_stride == 0) {
+                results[*results_count] = slice_result;
+                batch_keep_result(handle, &results[*results_count], *results_count);
+                (*results_count)++;
+            }
+        }
+    }
+    else if (res == EI_IMPULSE_OK) {
+        window_signal.total_length = impulse->dsp_input_frame_size;
+
+        for (size_t start = 0; start + window <= frames && *results_count < max_results; start += stride) {
+            batch_source_offset = start * frame_size;
+            res = process_impulse(handle, &window_signal, &results[*results_count], debug);
+            if (res != EI_IMPULSE_OK) {
+                break;
+            }
+            batch_keep_result(handle, &results[*results_count], *results_count);
+            (*results_count)++;
+        }
+    }
+
+    if (per_slice) {
+        run_classifier_deinit(handle);
+    }
+
+#if EI_CLASSIFIER_COMPILED == 1
+    ei_eon_session_end();
+#endif
+
+    batch_source_signal = nullptr;
+    return res;
+}
+
 /* Public functions ------------------------------------------------------- */
 
 /* Tread carefully: public functions are not to be changed
@@ -911,6 +1023,9 @@ __attribute__((unused)) void run_classifier_init(ei_impulse_handle_t *handle)
 extern "C" void run_classifier_deinit(void)
 {
     deinit_postprocessing(&ei_default_impulse);
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1)
+    ei_eon_release(ei_default_impulse.impulse);
+#endif
 }
 
 __attribute__((unused)) void run_classifier_deinit(ei_impulse_handle_t *handle)
@@ -919,6 +1034,9 @@ __attribute__((unused)) void run_classifier_deinit(ei_impulse_handle_t *handle)
 #if EI_CLASSIFIER_HAS_DATA_NORMALIZATION
     deinit_data_normalization(handle);
 #endif
+#if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1)
+    ei_eon_release(handle->impulse);
+#endif
 }
 
 /**
@@ -1100,6 +1218,80 @@ __attribute__((unused)) EI_IMPULSE_ERROR run_classifier(
     return process_impulse(impulse, signal, result, debug);
 }
 
+/**
+ * @brief Run the classifier over every window of a long signal.
+ *
+ * Windows are `stride` frames apart and the first one starts at the beginning of the signal.
+ * By default every window runs the full DSP, so results match `run_classifier()` on each
+ * window. With `per_slice` set, all DSP blocks MFCC, MFE or spectrogram and `stride` a
+ * multiple of EI_CLASSIFIER_SLICE_SIZE smaller than the window, overlapping windows share
+ * their features the way `run_classifier_continuous()` does (without the moving average
+ * filter), so results match continuous mode instead; otherwise `per_slice` is ignored.
+ * EON models stay initialized for the whole batch.
+ *
+ * The per-slice path runs between `run_classifier_init()` and `run_classifier_deinit()` on
+ * `impulse`. The continuous state (features written so far and the DSP slice buffers) is
+ * shared by all handles and is not restored, so a `run_classifier_continuous()` session that
+ * was running before the batch has to call `run_classifier_init()` again. The postprocessing
+ * state of `impulse` is freed at the end, and EON models are released.
+ *
+ * For a cascaded impulse `impulse->cascade` only describes the last window; a window the
+ * gate rejected reports every class at 0 in its result.
+ *
+ * **Blocking**: yes
+ *
+ * @param[in] impulse Pointer to an `ei_impulse_handle_t` struct that contains the model and
+ *  preprocessing information.
+ * @param[in] signal Pointer to a `signal_t` struct with the whole recording, at least
+ *  EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE values.
+ * @param[in] stride Frames between the start of two windows.
+ * @param[out] results Array of `max_results` structs, one per window. Classification, anomaly
+ *  and timing are kept per window. When the classification is not part of the result struct
+ *  it points at a per-window copy in the handle, valid until the next batch on the same
+ *  handle. Other pointer fields (e.g. bounding boxes) refer to buffers that
+ *  are reused and are only valid for the last window.
+ * @param[in] max_results Number of structs in `results`, windows beyond that are skipped.
+ * @param[out] results_count Number of windows classified.
+ * @param[in] debug Print internal preprocessing and inference debugging information via `ei_printf()`.
+ * @param[in] per_slice Share features between overlapping windows, see above.
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum. Will be `EI_IMPULSE_OK` if all
+ *  windows were classified successfully.
+ */
+__attribute__((unused)) EI_IMPULSE_ERROR run_classifier_batch(
+    ei_impulse_handle_t *impulse,
+    signal_t *signal,
+    size_t stride,
+    ei_impulse_result_t *results,
+    size_t max_results,
+    size_t *results_count,
+    bool debug = false,
+    bool per_slice = false)
+{
+    return process_impulse_batch(impulse, signal, stride, results, max_results, results_count, debug, per_slice);
+}
+
+/**
+ * @brief Run the classifier over every window of a long signal.
+ *
+ * Overloaded function [run_classifier_batch()](#run_classifier_batch) that defaults to the
+ * default impulse.
+ *
+ * @return Error code as defined by `EI_IMPULSE_ERROR` enum. Will be `EI_IMPULSE_OK` if all
+ *  windows were classified successfully.
+ */
+extern "C" EI_IMPULSE_ERROR run_classifier_batch(
+    signal_t *signal,
+    size_t stride,
+    ei_impulse_result_t *results,
+    size_t max_results,
+    size_t *results_count,
+    bool debug = false,
+    bool per_slice = false)
+{
+    return process_impulse_batch(&ei_default_impulse, signal, stride, results, max_results, results_count, debug, per_slice);
+}
+
 #if EI_CLASSIFIER_FREEFORM_OUTPUT
 /**
  * Set the location for freeform outputs. For impulses with freeform output the application needs to allocate
@@ -240,6 +240,8 @@ __attribute__((unused)) int extract_mfcc_features(signal_t *signal, matrix_t *ou
 
     const uint32_t frequency = static_cast<uint32_t>(sampling_frequency);
 
+    EI_PROFILE_SCOPE("extract_mfcc_features");
+
     // preemphasis class to preprocess the audio...
     class speechpy::processing::preemphasis pre(signal, config.pre_shift, config.pre_cof, false);
     preemphasis = &pre;
@@ -272,7 +274,10 @@ __attribute__((unused)) int extract_mfcc_features(signal_t *signal, matrix_t *ou
     }
 
     // cepstral mean and variance normalization
-    ret = speechpy::processing::cmvnw(output_matrix, config.win_size, true, false);
+    {
+        EI_PROFILE_SCOPE("cmvnw");
+        ret = speechpy::processing::cmvnw(output_matrix, config.win_size, true, false);
+    }
     if (ret != EIDSP_OK) {
         ei_printf("ERR: cmvnw failed (%d)\n", ret);
         EIDSP_ERR(ret);
@@ -288,6 +293,8 @@ __attribute__((unused)) int extract_mfcc_features(signal_t *signal, matrix_t *ou
 __attribute__((unused)) static int extract_mfcc_run_slice(signal_t *signal, matrix_t *output_matrix, ei_dsp_config_mfcc_t *config, const float sampling_frequency, matrix_size_t *matrix_size_out, int implementation_version) {
     uint32_t frequency = (uint32_t)sampling_frequency;
 
+    EI_PROFILE_SCOPE("extract_mfcc_run_slice");
+
     int x;
 
     // calculate the size of the spectrogram matrix
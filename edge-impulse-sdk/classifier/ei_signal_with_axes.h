@@ -41,6 +41,13 @@
 
 #if !EIDSP_SIGNAL_C_FN_POINTER
 
+#include <string.h>
+
+// number of floats read from the original signal in one go, whole frames only
+#ifndef EI_CLASSIFIER_SIGNAL_WITH_AXES_SCRATCH_SIZE
+#define EI_CLASSIFIER_SIGNAL_WITH_AXES_SCRATCH_SIZE     128
+#endif // EI_CLASSIFIER_SIGNAL_WITH_AXES_SCRATCH_SIZE
+
 using namespace ei;
 
 class SignalWithAxes {
@@ -48,11 +55,18 @@ public:
     SignalWithAxes(signal_t *original_signal, EI_CLASSIFIER_DSP_AXES_INDEX_TYPE *axes, size_t axes_count, const ei_impulse_t *impulse):
         _original_signal(original_signal), _axes(axes), _axes_count(axes_count), _impulse(impulse)
     {
-
+        // axes 0..n-1 in order can be copied out of a frame with a single memcpy
+        _axes_in_order = true;
+        for (size_t axis_ix = 0; axis_ix < _axes_count; axis_ix++) {
+            if (_axes[axis_ix] != axis_ix) {
+                _axes_in_order = false;
+                break;
+            }
+        }
     }
 
     signal_t * get_signal() {
-        if (this->_axes_count == _impulse->raw_samples_per_frame) {
+        if (this->_axes_count == _impulse->raw_samples_per_frame && _axes_in_order) {
             return this->_original_signal;
         }
 
@@ -67,28 +81,80 @@ public:
         return &wrapped_signal;
     }
 
+    /**
+     * Reads whole frames from the original signal into a scratch buffer and
+     * picks the selected axes out of them, instead of one get_data call per value.
+     */
     int get_data(size_t offset, size_t length, float *out_ptr) {
-        size_t offset_on_original_signal = offset / _axes_count * _impulse->raw_samples_per_frame;
-        size_t length_on_original_signal = length / _axes_count * _impulse->raw_samples_per_frame;
+        const size_t frame_size = _impulse->raw_samples_per_frame;
+        const size_t frames_per_read = EI_CLASSIFIER_SIGNAL_WITH_AXES_SCRATCH_SIZE / frame_size;
+
+        if (frames_per_read == 0) {
+            return get_data_per_value(offset, length, out_ptr);
+        }
 
+        float scratch[EI_CLASSIFIER_SIGNAL_WITH_AXES_SCRATCH_SIZE];
+        size_t frame = offset / _axes_count;
+        size_t axis_ix = offset % _axes_count;
         size_t out_ptr_ix = 0;
 
-        for (size_t ix = offset_on_original_signal; ix < offset_on_original_signal + length_on_original_signal; ix += _impulse->raw_samples_per_frame) {
-            for (size_t axis_ix = 0; axis_ix < this->_axes_count; axis_ix++) {
-                int r = _original_signal->get_data(ix + _axes[axis_ix], 1, &out_ptr[out_ptr_ix++]);
-                if (r != 0) {
-                    return r;
+        while (out_ptr_ix < length) {
+            // frames still needed to fill the output
+            size_t frames = (axis_ix + (length - out_ptr_ix) + _axes_count - 1) / _axes_count;
+            if (frames > frames_per_read) {
+                frames = frames_per_read;
+            }
+
+            int r = _original_signal->get_data(frame * frame_size, frames * frame_size, scratch);
+            if (r != 0) {
+                return r;
+            }
+
+            for (size_t f = 0; f < frames && out_ptr_ix < length; f++) {
+                const float *in = &scratch[f * frame_size];
+
+                if (_axes_in_order && axis_ix == 0 && length - out_ptr_ix >= _axes_count) {
+                    memcpy(&out_ptr[out_ptr_ix], in, _axes_count * sizeof(float));
+                    out_ptr_ix += _axes_count;
+                    continue;
                 }
+
+                for (; axis_ix < _axes_count && out_ptr_ix < length; axis_ix++) {
+                    out_ptr[out_ptr_ix++] = in[_axes[axis_ix]];
+                }
+                axis_ix = 0;
             }
+
+            frame += frames;
         }
 
         return 0;
     }
 
 private:
+    // fallback for frames that don't fit the scratch buffer
+    int get_data_per_value(size_t offset, size_t length, float *out_ptr) {
+        size_t frame = offset / _axes_count;
+        size_t axis_ix = offset % _axes_count;
+
+        for (size_t out_ptr_ix = 0; out_ptr_ix < length; out_ptr_ix++) {
+            int r = _original_signal->get_data(frame * _impulse->raw_samples_per_frame + _axes[axis_ix], 1, &out_ptr[out_ptr_ix]);
+            if (r != 0) {
+                return r;
+            }
+            if (++axis_ix == _axes_count) {
+                axis_ix = 0;
+                frame++;
+            }
+        }
+
+        return 0;
+    }
+
     signal_t *_original_signal;
     EI_CLASSIFIER_DSP_AXES_INDEX_TYPE *_axes;
     size_t _axes_count;
+    bool _axes_in_order;
     const ei_impulse_t *_impulse;
     signal_t wrapped_signal;
 };
@@ -40,10 +40,154 @@
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
 #include "edge-impulse-sdk/tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "edge-impulse-sdk/classifier/ei_aligned_malloc.h"
+#include "edge-impulse-sdk/porting/ei_memory_placement.h"
 #include "edge-impulse-sdk/classifier/ei_model_types.h"
 #include "edge-impulse-sdk/classifier/inferencing_engines/tflite_helper.h"
 #include "edge-impulse-sdk/classifier/ei_run_dsp.h"
 
+/**
+ * Allocator used for the EON tensor arena. Defaults to the aligned heap
+ * allocator; a scheduler that runs several models one after another can
+ * point it at a single shared arena instead.
+ */
+static void *(*eon_arena_alloc)(size_t, size_t) = ei_aligned_calloc;
+static void (*eon_arena_free)(void *) = ei_aligned_free;
+
+/**
+ * @brief      Replace the allocator used for EON tensor arenas
+ *
+ * @param[in]  alloc_fnc  Called as alloc_fnc(alignment, size) in model_init
+ * @param[in]  free_fnc   Called from model_reset with the pointer returned above
+ */
+__attribute__((unused)) static void ei_set_eon_arena_allocator(
+    void *(*alloc_fnc)(size_t, size_t),
+    void (*free_fnc)(void *))
+{
+    eon_arena_alloc = alloc_fnc ? alloc_fnc : ei_aligned_calloc;
+    eon_arena_free = free_fnc ? free_fnc : ei_aligned_free;
+}
+
+/**
+ * While a session is held (batch inference), the model stays initialized
+ * between invokes instead of being set up and torn down for every window.
+ * Models are identified by their init function, as graph configs may live
+ * on the stack.
+ */
+static bool eon_session_held = false;
+static TfLiteStatus (*eon_session_init_fn)(void*(*)(size_t, size_t)) = nullptr;
+static TfLiteStatus (*eon_session_reset_fn)(void (*)(void*)) = nullptr;
+
+static TfLiteStatus eon_session_release(void)
+{
+    TfLiteStatus status = kTfLiteOk;
+    if (eon_session_reset_fn) {
+        status = eon_session_reset_fn(eon_arena_free);
+    }
+    eon_session_init_fn = nullptr;
+    eon_session_reset_fn = nullptr;
+    return status;
+}
+
+static TfLiteStatus eon_model_init(ei_config_tflite_eon_graph_t *graph_config)
+{
+    if (eon_session_init_fn == graph_config->model_init) {
+        return kTfLiteOk;
+    }
+    // only one model is kept open, release the previous one
+    eon_session_release();
+
+    TfLiteStatus status = graph_config->model_init(eon_arena_alloc);
+    if (status == kTfLiteOk && eon_session_held) {
+        eon_session_init_fn = graph_config->model_init;
+        eon_session_reset_fn = graph_config->model_reset;
+    }
+    return status;
+}
+
+static TfLiteStatus eon_model_reset(ei_config_tflite_eon_graph_t *graph_config)
+{
+    if (eon_session_init_fn == graph_config->model_init) {
+        return kTfLiteOk;
+    }
+    return graph_config->model_reset(eon_arena_free);
+}
+
+/**
+ * @brief      Keep models initialized across invokes until
+ *             ei_eon_session_end() is called
+ */
+__attribute__((unused)) static void ei_eon_session_begin(void)
+{
+    eon_session_held = true;
+}
+
+/**
+ * @brief      Release the model kept open since ei_eon_session_begin()
+ */
+__attribute__((unused)) static void ei_eon_session_end(void)
+{
+    eon_session_held = false;
+    eon_session_release();
+}
+
+/**
+ * @brief      Per-layer profile of the last invoke of an EON learning block
+ *
+ * @param      block_config  Config of the learning block (learning_blocks[ix].config)
+ * @param      layers        Set to the profile of each node, in execution order
+ * @param      count         Set to the number of nodes
+ *
+ * @return     false if the model was compiled without EI_CLASSIFIER_PROFILE_LAYERS
+ */
+__attribute__((unused)) static bool ei_eon_get_layer_profile(
+    const ei_learning_block_config_tflite_graph_t *block_config,
+    const ei_eon_layer_profile_t **layers,
+    size_t *count)
+{
+    const ei_config_tflite_eon_graph_t *graph_config = (const ei_config_tflite_eon_graph_t*)block_config->graph_config;
+
+    *layers = nullptr;
+    *count = 0;
+    if (graph_config->model_profile == nullptr) {
+        return false;
+    }
+
+    return graph_config->model_profile(layers, count) == kTfLiteOk && *count > 0;
+}
+
+/**
+ * @brief      Print time, share of the total and tensor sizes of every node
+ *             in the last invoke. Prints nothing without layer profiling.
+ */
+__attribute__((unused)) static void ei_eon_print_layer_profile(const ei_learning_block_config_tflite_graph_t *block_config)
+{
+    const ei_eon_layer_profile_t *layers;
+    size_t count;
+
+    if (!ei_eon_get_layer_profile(block_config, &layers, &count)) {
+        return;
+    }
+
+    uint64_t total = 0;
+    for (size_t ix = 0; ix < count; ix++) {
+        total += layers[ix].ticks;
+    }
+    if (total == 0) {
+        total = 1;
+    }
+
+    ei_printf("Layer profile (block %u, %s):\n", (unsigned int)block_config->block_id, EI_EON_PROFILE_UNIT);
+    for (size_t ix = 0; ix < count; ix++) {
+        unsigned int permille = (unsigned int)((uint64_t)layers[ix].ticks * 1000 / total);
+        ei_printf("  %2u %-16s %10u %3u.%u%%  in %u B, weights %u B, out %u B\n",
+            (unsigned int)ix, layers[ix].op, (unsigned int)layers[ix].ticks,
+            permille / 10, permille % 10,
+            (unsigned int)layers[ix].input_bytes, (unsigned int)layers[ix].weight_bytes,
+            (unsigned int)layers[ix].output_bytes);
+    }
+    ei_printf("  total %u %s\n", (unsigned int)total, EI_EON_PROFILE_UNIT);
+}
+
 /**
  * Setup the TFLite runtime
  *
@@ -66,7 +210,8 @@ static EI_IMPULSE_ERROR inference_tflite_setup(
     TfLiteTensor *outputs = *output_arg;
     ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
-    TfLiteStatus init_status = graph_config->model_init(ei_aligned_calloc);
+    EiMemoryPlacement placement(EI_MEMORY_CLASS_ARENA);
+    TfLiteStatus init_status = eon_model_init(graph_config);
     if (init_status != kTfLiteOk) {
         ei_printf("Failed to initialize the model (error code %d)\n", init_status);
         return EI_IMPULSE_TFLITE_ARENA_ALLOC_FAILED;
@@ -112,8 +257,11 @@ static EI_IMPULSE_ERROR inference_tflite_run(
 
     ei_config_tflite_eon_graph_t *graph_config = (ei_config_tflite_eon_graph_t*)block_config->graph_config;
 
-    if (graph_config->model_invoke() != kTfLiteOk) {
-        return EI_IMPULSE_TFLITE_ERROR;
+    {
+        EI_PROFILE_SCOPE("nn invoke");
+        if (graph_config->model_invoke() != kTfLiteOk) {
+            return EI_IMPULSE_TFLITE_ERROR;
+        }
     }
 
     uint64_t ctx_end_us = ei_read_timer_us();
@@ -122,6 +270,10 @@ static EI_IMPULSE_ERROR inference_tflite_run(
 
     EI_LOGD("Predictions (time: %d ms.):\n", result->timing.classification);
 
+    if (debug) {
+        ei_eon_print_layer_profile(block_config);
+    }
+
     if (ei_run_impulse_check_canceled() == EI_IMPULSE_CANCELED) {
         return EI_IMPULSE_CANCELED;
     }
@@ -179,7 +331,7 @@ EI_IMPULSE_ERROR run_nn_inference_from_dsp(
         return output_res;
     }
 
-    if (graph_config->model_reset(ei_aligned_free) != kTfLiteOk) {
+    if (eon_model_reset(graph_config) != kTfLiteOk) {
         return EI_IMPULSE_TFLITE_ERROR;
     }
     ei_free(outputs);
@@ -231,13 +383,23 @@ EI_IMPULSE_ERROR run_nn_inference(
 
     uint8_t* tensor_arena = static_cast<uint8_t*>(p_tensor_arena.get());
 
+    // image scaling is folded into quantization, see run_inference()
+    ei_input_affine_t affine;
+    const ei_input_affine_t *input_affine = nullptr;
+    int image_scaling = impulse->learning_blocks[learn_block_index].image_scaling;
+    if (ei_can_fuse_input_scaling(image_scaling, block_config) &&
+        ei_input_affine_from_scaling(image_scaling, &affine)) {
+        input_affine = &affine;
+    }
+
     auto input_res = fill_input_tensor_from_matrix(fmatrix,
                                                    result->_raw_outputs,
                                                    &input,
                                                    input_block_ids,
                                                    input_block_ids_size,
                                                    impulse->dsp_blocks_size,
-                                                   impulse->learning_blocks_size);
+                                                   impulse->learning_blocks_size,
+                                                   input_affine);
 
     if (input_res != EI_IMPULSE_OK) {
         return input_res;
@@ -294,7 +456,7 @@ EI_IMPULSE_ERROR run_nn_inference(
         result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
     }
 
-    graph_config->model_reset(ei_aligned_free);
+    eon_model_reset(graph_config);
     ei_free(outputs);
 
     if (run_res != EI_IMPULSE_OK) {
@@ -430,7 +592,7 @@ EI_IMPULSE_ERROR run_nn_inference_image_quantized(
         result->_raw_outputs[learn_block_index + output_ix].blockId = block_config->block_id + output_ix;
     }
 
-    graph_config->model_reset(ei_aligned_free);
+    eon_model_reset(graph_config);
     ei_free(outputs);
 
     if (run_res != EI_IMPULSE_OK) {
@@ -451,6 +613,8 @@ __attribute__((unused)) int extract_tflite_eon_features(signal_t *signal, matrix
         .model_reset = dsp_config->reset_fn,
         .model_input = dsp_config->input_fn,
         .model_output = dsp_config->output_fn,
+        .model_profile = nullptr,
+        .model_release = nullptr,
     };
 
     const uint8_t ei_output_tensor_indices[1] = { 0 };
@@ -474,5 +638,34 @@ __attribute__((unused)) int extract_tflite_eon_features(signal_t *signal, matrix
     return EIDSP_OK;
 }
 
+/**
+ * @brief      Free what the EON learning blocks of an impulse keep across
+ *             invokes (weights copied to RAM). The next invoke sets them up
+ *             again.
+ */
+__attribute__((unused)) static void ei_eon_release(const ei_impulse_t *impulse)
+{
+    ei_eon_session_end();
+
+    for (size_t ix = 0; ix < impulse->learning_blocks_size; ix++) {
+        const ei_learning_block_t *block = &impulse->learning_blocks[ix];
+        if (block->infer_fn != &run_nn_inference) {
+            continue;
+        }
+
+        const ei_learning_block_config_tflite_graph_t *block_config =
+            (const ei_learning_block_config_tflite_graph_t *)block->config;
+        if (!block_config->compiled) {
+            continue;
+        }
+
+        const ei_config_tflite_eon_graph_t *graph_config =
+            (const ei_config_tflite_eon_graph_t *)block_config->graph_config;
+        if (graph_config->model_release) {
+            graph_config->model_release();
+        }
+    }
+}
+
 #endif // (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) && (EI_CLASSIFIER_COMPILED == 1)
 #endif // _EI_CLASSIFIER_INFERENCING_ENGINE_TFLITE_EON_H_
@@ -36,6 +36,7 @@
 #define _EI_CLASSIFIER_INFERENCING_ENGINE_TFLITE_HELPER_H_
 
 #include "edge-impulse-sdk/classifier/ei_quantize.h"
+#include "edge-impulse-sdk/classifier/ei_image_scaling.h"
 #if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE_FULL) || (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE) || (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TENSORRT) || (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE_TIDL)
 
 #if (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE_FULL) || (EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE_TIDL)
@@ -54,6 +55,28 @@
 #include "edge-impulse-sdk/tensorflow/lite/schema/schema_generated.h"
 #endif // EI_CLASSIFIER_INFERENCING_ENGINE == EI_CLASSIFIER_TFLITE
 
+/**
+ * @brief Whether a learning block's image scaling can be applied while its
+ * quantized input tensor is filled, instead of by ei_scale_fmatrix()
+ */
+__attribute__((unused)) static bool ei_can_fuse_input_scaling(
+    int image_scaling,
+    const ei_learning_block_config_tflite_graph_t *block_config)
+{
+#if EI_CLASSIFIER_LOAD_IMAGE_SCALING
+    return image_scaling != EI_CLASSIFIER_IMAGE_SCALING_NONE && block_config->quantized == 1;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Copy (float inputs) or quantize (int8/uint8 inputs) features into
+ * the input tensor, in a single pass per matrix
+ *
+ * @param affine    Optional scaling, applied to the first DSP block's
+ *                  features only (as ei_scale_fmatrix() does)
+ */
 EI_IMPULSE_ERROR fill_input_tensor_from_matrix(
     ei_feature_t *fmatrix,
     ei_feature_t *omatrix,
@@ -61,7 +84,8 @@ EI_IMPULSE_ERROR fill_input_tensor_from_matrix(
     uint32_t* input_block_ids,
     uint32_t input_block_ids_size,
     size_t fmtx_size,
-    size_t omtx_size
+    size_t omtx_size,
+    const ei_input_affine_t *affine = nullptr
 ) {
     size_t matrix_els = 0;
     uint32_t input_idx = 0;
@@ -81,28 +105,45 @@ EI_IMPULSE_ERROR fill_input_tensor_from_matrix(
         ei::matrix_t* matrix = fmatrix[0].matrix;
 #endif
 
-        matrix_els += matrix->rows * matrix->cols;
+        const size_t els = matrix->rows * matrix->cols;
+        matrix_els += els;
+
+        // check before writing, the size check below only runs after the last matrix
+        size_t capacity = input->type == kTfLiteFloat32 ? input->bytes / 4 : input->bytes;
+        if (matrix_els > capacity) {
+            ei_printf("ERR: input tensor has size %d bytes, but input matrix has has size %d bytes\n",
+                (int)input->bytes, (int)matrix_els);
+            return EI_IMPULSE_INVALID_SIZE;
+        }
+
+        const ei_input_affine_t *matrix_affine = (matrix == fmatrix[0].matrix) ? affine : nullptr;
 
         switch (input->type) {
             case kTfLiteFloat32: {
-                for (size_t ix = 0; ix < matrix->rows * matrix->cols; ix++) {
-                    input->data.f[input_idx++] = matrix->buffer[ix];
+                if (matrix_affine) {
+                    for (size_t ix = 0; ix < els; ix += matrix_affine->channels) {
+                        for (size_t c = 0; c < matrix_affine->channels; c++) {
+                            input->data.f[input_idx++] = matrix->buffer[ix + matrix_affine->src[c]] *
+                                matrix_affine->mul[c] + matrix_affine->add[c];
+                        }
+                    }
+                }
+                else {
+                    memcpy(&input->data.f[input_idx], matrix->buffer, els * sizeof(float));
+                    input_idx += els;
                 }
                 break;
             }
             case kTfLiteInt8: {
-                for (size_t ix = 0; ix < matrix->rows * matrix->cols; ix++) {
-                    float val = (float)matrix->buffer[ix];
-                    input->data.int8[input_idx++] = static_cast<int8_t>(
-                        pre_cast_quantize(val, input->params.scale, input->params.zero_point, true));
-                }
+                quantize_features(matrix->buffer, els, &input->data.int8[input_idx],
+                    input->params.scale, input->params.zero_point, matrix_affine);
+                input_idx += els;
                 break;
             }
             case kTfLiteUInt8: {
-                for (size_t ix = 0; ix < matrix->rows * matrix->cols; ix++) {
-                    float val = (float)matrix->buffer[ix];
-                    input->data.uint8[input_idx++] = static_cast<uint8_t>(
-                        pre_cast_quantize(val, input->params.scale, input->params.zero_point, false));            }
+                quantize_features(matrix->buffer, els, &input->data.uint8[input_idx],
+                    input->params.scale, input->params.zero_point, matrix_affine);
+                input_idx += els;
                 break;
             }
             default: {
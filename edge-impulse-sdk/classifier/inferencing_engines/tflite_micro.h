@@ -365,13 +365,23 @@ EI_IMPULSE_ERROR run_nn_inference(
         return init_res;
     }
 
+    // image scaling is folded into quantization, see run_inference()
+    ei_input_affine_t affine;
+    const ei_input_affine_t *input_affine = nullptr;
+    int image_scaling = impulse->learning_blocks[learn_block_index].image_scaling;
+    if (ei_can_fuse_input_scaling(image_scaling, block_config) &&
+        ei_input_affine_from_scaling(image_scaling, &affine)) {
+        input_affine = &affine;
+    }
+
     auto input_res = fill_input_tensor_from_matrix(fmatrix,
                                                    result->_raw_outputs,
                                                    input,
                                                    input_block_ids,
                                                    input_block_ids_size,
                                                    impulse->dsp_blocks_size,
-                                                   impulse->learning_blocks_size);
+                                                   impulse->learning_blocks_size,
+                                                   input_affine);
     if (input_res != EI_IMPULSE_OK) {
         return input_res;
     }
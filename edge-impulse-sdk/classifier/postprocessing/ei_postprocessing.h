@@ -116,6 +116,12 @@ extern "C" EI_IMPULSE_ERROR run_postprocessing(ei_impulse_handle_t *handle,
             state = handle->post_processing_state[ix];
         }
 
+        // a rejected cascade window keeps the zeroed classification from
+        // run_inference, the gate output is not in the impulse's label layout
+        if (handle->cascade.rejected) {
+            continue;
+        }
+
         EI_IMPULSE_ERROR res = impulse->postprocessing_blocks[ix].postprocess_fn(handle,
                                                                                 ix,
                                                                                 impulse->postprocessing_blocks[ix].input_block_id,
@@ -101,7 +101,8 @@
 #endif // EIDSP_TRACK_ALLOCATIONS
 
 // set EIDSP_TRACK_ALLOCATIONS=1 and EIDSP_PRINT_ALLOCATIONS=0
-// to track but not print allocations
+// to track but not print allocations. This only covers DSP buffers,
+// EI_ALLOC_TRACE_ENABLED (ei_alloc_trace.h) traces every ei_malloc call
 #ifndef EIDSP_PRINT_ALLOCATIONS
 #define EIDSP_PRINT_ALLOCATIONS      1
 #endif
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+
+#include "ei_alloc_trace.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if EI_ALLOC_TRACE_ENABLED == 1
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+// ei_malloc is called from several tasks (sampling, inference, AT commands)
+static portMUX_TYPE trace_lock = portMUX_INITIALIZER_UNLOCKED;
+#define EI_ALLOC_TRACE_LOCK()   portENTER_CRITICAL_SAFE(&trace_lock)
+#define EI_ALLOC_TRACE_UNLOCK() portEXIT_CRITICAL_SAFE(&trace_lock)
+#else
+#define EI_ALLOC_TRACE_LOCK()
+#define EI_ALLOC_TRACE_UNLOCK()
+#endif
+
+typedef struct {
+    void *ptr;
+    size_t size;
+} ei_alloc_trace_live_t;
+
+static ei_alloc_trace_live_t live[EI_ALLOC_TRACE_MAX_LIVE];
+static ei_alloc_trace_site_t sites[EI_ALLOC_TRACE_TOP_SITES];
+static size_t site_count = 0;
+static ei_alloc_trace_stats_t stats = {};
+
+/**
+ * @brief      Remember the call site if it is among the largest seen so far.
+ *             When the table is full the site with the smallest allocation
+ *             is replaced.
+ */
+static void record_site(size_t size, const void *caller)
+{
+    size_t smallest = 0;
+
+    for (size_t ix = 0; ix < site_count; ix++) {
+        if (sites[ix].caller == caller) {
+            sites[ix].count++;
+            if (size > sites[ix].largest) {
+                sites[ix].largest = size;
+            }
+            return;
+        }
+        if (sites[ix].largest < sites[smallest].largest) {
+            smallest = ix;
+        }
+    }
+
+    if (site_count < EI_ALLOC_TRACE_TOP_SITES) {
+        sites[site_count++] = { caller, size, 1 };
+    }
+    else if (size > sites[smallest].largest) {
+        sites[smallest] = { caller, size, 1 };
+    }
+}
+
+void ei_alloc_trace_on_alloc(void *ptr, size_t size, const void *caller)
+{
+    EI_ALLOC_TRACE_LOCK();
+
+    stats.allocs++;
+    record_site(size, caller);
+
+    size_t ix = 0;
+    for (; ix < EI_ALLOC_TRACE_MAX_LIVE; ix++) {
+        if (live[ix].ptr == NULL) {
+            live[ix].ptr = ptr;
+            live[ix].size = size;
+            break;
+        }
+    }
+
+    if (ix == EI_ALLOC_TRACE_MAX_LIVE) {
+        // size can't be given back on free, leave it out of in_use
+        stats.untracked++;
+    }
+    else {
+        stats.in_use += size;
+        if (stats.in_use > stats.peak) {
+            stats.peak = stats.in_use;
+        }
+    }
+
+    EI_ALLOC_TRACE_UNLOCK();
+}
+
+void ei_alloc_trace_on_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    EI_ALLOC_TRACE_LOCK();
+
+    stats.frees++;
+    for (size_t ix = 0; ix < EI_ALLOC_TRACE_MAX_LIVE; ix++) {
+        if (live[ix].ptr == ptr) {
+            stats.in_use -= live[ix].size;
+            live[ix].ptr = NULL;
+            live[ix].size = 0;
+            break;
+        }
+    }
+
+    EI_ALLOC_TRACE_UNLOCK();
+}
+
+void ei_alloc_trace_get_stats(ei_alloc_trace_stats_t *out)
+{
+    EI_ALLOC_TRACE_LOCK();
+    *out = stats;
+    EI_ALLOC_TRACE_UNLOCK();
+}
+
+size_t ei_alloc_trace_get_sites(const ei_alloc_trace_site_t **out)
+{
+    *out = sites;
+    return site_count;
+}
+
+/**
+ * @brief      Start measuring a window, e.g. one call to run_classifier().
+ *             The global peak is restarted from the current use, so windows
+ *             should not overlap.
+ */
+void ei_alloc_trace_begin(ei_alloc_trace_window_t *window)
+{
+    EI_ALLOC_TRACE_LOCK();
+    stats.peak = stats.in_use;
+    window->start_in_use = stats.in_use;
+    window->start_allocs = stats.allocs;
+    window->start_frees = stats.frees;
+    EI_ALLOC_TRACE_UNLOCK();
+}
+
+void ei_alloc_trace_end(ei_alloc_trace_window_t *window)
+{
+    EI_ALLOC_TRACE_LOCK();
+    window->allocs = stats.allocs - window->start_allocs;
+    window->frees = stats.frees - window->start_frees;
+    window->peak = stats.peak - window->start_in_use;
+    window->retained = (long)stats.in_use - (long)window->start_in_use;
+    EI_ALLOC_TRACE_UNLOCK();
+}
+
+/**
+ * @brief      Report a window in steady state that allocated, aborts with
+ *             EI_ALLOC_TRACE_ASSERT_STEADY=1 so the regression is caught
+ *             where it happens
+ *
+ * @param      window  ended window
+ * @param      what    name of the measured code for the report
+ *
+ * @return     true if the window did not allocate
+ */
+bool ei_alloc_trace_check_steady(const ei_alloc_trace_window_t *window, const char *what)
+{
+    if (window->allocs == 0) {
+        return true;
+    }
+
+    ei_printf("ERR: %s allocated %u times, %u bytes peak, in steady state\n",
+        what, (unsigned)window->allocs, (unsigned)window->peak);
+#if EI_ALLOC_TRACE_ASSERT_STEADY == 1
+    ei_alloc_trace_print();
+    abort();
+#endif
+
+    return false;
+}
+
+/**
+ * @brief      Forget counters and call sites. Live allocations stay tracked
+ *             so later frees still balance.
+ */
+void ei_alloc_trace_reset(void)
+{
+    EI_ALLOC_TRACE_LOCK();
+    stats.peak = stats.in_use;
+    stats.allocs = 0;
+    stats.frees = 0;
+    stats.untracked = 0;
+    site_count = 0;
+    memset(sites, 0, sizeof(sites));
+    EI_ALLOC_TRACE_UNLOCK();
+}
+
+void ei_alloc_trace_print(void)
+{
+    ei_alloc_trace_stats_t snapshot;
+    ei_alloc_trace_site_t top[EI_ALLOC_TRACE_TOP_SITES];
+    size_t count;
+
+    EI_ALLOC_TRACE_LOCK();
+    snapshot = stats;
+    count = site_count;
+    memcpy(top, sites, sizeof(top));
+    EI_ALLOC_TRACE_UNLOCK();
+
+    // largest first
+    for (size_t ix = 1; ix < count; ix++) {
+        ei_alloc_trace_site_t site = top[ix];
+        size_t jx = ix;
+        for (; jx > 0 && top[jx - 1].largest < site.largest; jx--) {
+            top[jx] = top[jx - 1];
+        }
+        top[jx] = site;
+    }
+
+    ei_printf("Heap: %u bytes in use, peak %u bytes, %u allocs, %u frees",
+        (unsigned)snapshot.in_use, (unsigned)snapshot.peak,
+        (unsigned)snapshot.allocs, (unsigned)snapshot.frees);
+    if (snapshot.untracked > 0) {
+        ei_printf(", %u untracked (raise EI_ALLOC_TRACE_MAX_LIVE)", (unsigned)snapshot.untracked);
+    }
+    ei_printf("\n");
+
+    ei_printf("Largest allocations by call site:\n");
+    for (size_t ix = 0; ix < count; ix++) {
+        ei_printf("    %p: %u bytes (%u calls)\n",
+            top[ix].caller, (unsigned)top[ix].largest, (unsigned)top[ix].count);
+    }
+}
+
+#endif // EI_ALLOC_TRACE_ENABLED == 1
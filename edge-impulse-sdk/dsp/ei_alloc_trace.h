@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+#ifndef _EIDSP_ALLOC_TRACE_H_
+#define _EIDSP_ALLOC_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Allocation tracer for everything that goes through ei_malloc, ei_calloc
+ * and ei_free: DSP buffers, classifier arenas, the EON tensor arena and
+ * sensor buffers in the firmware. With EI_ALLOC_TRACE_ENABLED=1 the porting
+ * layer reports every call here; the tracer keeps the heap in use and its
+ * peak, allocation counts and the call sites of the largest allocations.
+ * Replacing ei_malloc in the application bypasses it.
+ */
+#ifndef EI_ALLOC_TRACE_ENABLED
+#define EI_ALLOC_TRACE_ENABLED 0
+#endif // EI_ALLOC_TRACE_ENABLED
+
+/** Live allocations whose size is remembered until they are freed */
+#ifndef EI_ALLOC_TRACE_MAX_LIVE
+#define EI_ALLOC_TRACE_MAX_LIVE 96
+#endif // EI_ALLOC_TRACE_MAX_LIVE
+
+/**
+ * Abort when a window that should only use buffers allocated earlier, e.g.
+ * an inference after the first one, allocates. Needs EI_ALLOC_TRACE_ENABLED.
+ */
+#ifndef EI_ALLOC_TRACE_ASSERT_STEADY
+#define EI_ALLOC_TRACE_ASSERT_STEADY 0
+#endif // EI_ALLOC_TRACE_ASSERT_STEADY
+
+#if EI_ALLOC_TRACE_ASSERT_STEADY == 1 && EI_ALLOC_TRACE_ENABLED != 1
+#error "EI_ALLOC_TRACE_ASSERT_STEADY needs EI_ALLOC_TRACE_ENABLED=1"
+#endif
+
+/** Call sites kept, ordered by their largest allocation */
+#ifndef EI_ALLOC_TRACE_TOP_SITES
+#define EI_ALLOC_TRACE_TOP_SITES 8
+#endif // EI_ALLOC_TRACE_TOP_SITES
+
+typedef struct {
+    size_t in_use;
+    size_t peak;
+    uint32_t allocs;
+    uint32_t frees;
+    /** Allocations not tracked because the live table was full */
+    uint32_t untracked;
+} ei_alloc_trace_stats_t;
+
+typedef struct {
+    const void *caller;
+    size_t largest;
+    uint32_t count;
+} ei_alloc_trace_site_t;
+
+/** Heap activity between ei_alloc_trace_begin() and ei_alloc_trace_end() */
+typedef struct {
+    size_t start_in_use;
+    uint32_t start_allocs;
+    uint32_t start_frees;
+    uint32_t allocs;
+    uint32_t frees;
+    /** Highest use above start_in_use */
+    size_t peak;
+    /** Bytes still allocated at the end that were not there at the start */
+    long retained;
+} ei_alloc_trace_window_t;
+
+void ei_alloc_trace_on_alloc(void *ptr, size_t size, const void *caller);
+void ei_alloc_trace_on_free(void *ptr);
+void ei_alloc_trace_get_stats(ei_alloc_trace_stats_t *stats);
+size_t ei_alloc_trace_get_sites(const ei_alloc_trace_site_t **sites);
+void ei_alloc_trace_begin(ei_alloc_trace_window_t *window);
+void ei_alloc_trace_end(ei_alloc_trace_window_t *window);
+bool ei_alloc_trace_check_steady(const ei_alloc_trace_window_t *window, const char *what);
+void ei_alloc_trace_reset(void);
+void ei_alloc_trace_print(void);
+
+#if EI_ALLOC_TRACE_ENABLED == 1
+#define EI_ALLOC_TRACE_ALLOC(ptr, size) \
+    do { \
+        if (ptr) { \
+            ei_alloc_trace_on_alloc(ptr, size, __builtin_return_address(0)); \
+        } \
+    } while (0)
+#define EI_ALLOC_TRACE_FREE(ptr) ei_alloc_trace_on_free(ptr)
+#else
+#define EI_ALLOC_TRACE_ALLOC(ptr, size) do { } while (0)
+#define EI_ALLOC_TRACE_FREE(ptr) do { } while (0)
+#endif // EI_ALLOC_TRACE_ENABLED == 1
+
+#endif // _EIDSP_ALLOC_TRACE_H_
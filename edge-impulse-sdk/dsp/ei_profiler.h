@@ -31,8 +31,47 @@
 #ifndef __EIPROFILER__H__
 #define __EIPROFILER__H__
 
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 
+/**
+ * Scoped profiler. EI_PROFILE_SCOPE("name") times the enclosing block;
+ * scopes opened inside it become child zones. Every zone aggregates
+ * count/min/max/mean in a fixed table, nothing is printed until
+ * EI_PROFILE_DUMP(). With EI_PROFILER_ENABLED set to 0 (the default) the
+ * macros compile to nothing.
+ */
+#ifndef EI_PROFILER_ENABLED
+#define EI_PROFILER_ENABLED 0
+#endif
+
+#ifndef EI_PROFILER_MAX_ZONES
+#define EI_PROFILER_MAX_ZONES 24
+#endif
+
+#ifndef EI_PROFILER_MAX_DEPTH
+#define EI_PROFILER_MAX_DEPTH 8
+#endif
+
+/** Count CPU cycles instead of microseconds (ESP-IDF only) */
+#ifndef EI_PROFILER_USE_CYCLES
+#define EI_PROFILER_USE_CYCLES 0
+#endif
+
+#if EI_PROFILER_USE_CYCLES == 1 && defined(ESP_PLATFORM)
+#include "esp_cpu.h"
+#define EI_PROFILER_UNIT "cycles"
+/** CCOUNT is 32 bits wide, deltas are taken in 32 bits so they survive a wrap */
+typedef uint32_t ei_profiler_ticks_t;
+static inline ei_profiler_ticks_t ei_profiler_now(void) { return (ei_profiler_ticks_t)esp_cpu_get_cycle_count(); }
+#else
+#define EI_PROFILER_UNIT "us"
+typedef uint64_t ei_profiler_ticks_t;
+static inline ei_profiler_ticks_t ei_profiler_now(void) { return ei_read_timer_us(); }
+#endif
+
 class EiProfiler {
 public:
     EiProfiler()
@@ -41,16 +80,183 @@ public:
     }
     void reset()
     {
-        timestamp = ei_read_timer_ms();
+        timestamp = ei_read_timer_us();
     }
     void report(const char *message)
     {
-        ei_printf("%s took %llu\r\n", message, ei_read_timer_ms() - timestamp);
-        timestamp = ei_read_timer_ms(); //read again to not count printf time
+        ei_printf("%s took %llu us\r\n", message, (unsigned long long)(ei_read_timer_us() - timestamp));
+        timestamp = ei_read_timer_us(); //read again to not count printf time
     }
 
 private:
     uint64_t timestamp;
 };
 
+typedef struct {
+    const char *name;
+    int8_t parent;
+    uint8_t depth;
+    uint32_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+} ei_profiler_zone_t;
+
+/**
+ * Zone table shared by every translation unit. Not thread safe, profile
+ * from one task at a time.
+ */
+class EiProfilerZones {
+public:
+    static EiProfilerZones &get()
+    {
+        static EiProfilerZones zones;
+        return zones;
+    }
+
+    void reset()
+    {
+        zone_count = 0;
+        stack_size = 0;
+        dropped = 0;
+    }
+
+    /**
+     * @brief      Open a zone below the current one
+     * @return     Zone index, or -1 if the table or the stack is full
+     */
+    int enter(const char *name)
+    {
+        int parent = stack_size > 0 ? stack[stack_size - 1] : -1;
+        int ix = find(name, parent);
+
+        if (ix < 0 && zone_count < EI_PROFILER_MAX_ZONES && stack_size < EI_PROFILER_MAX_DEPTH) {
+            ix = zone_count++;
+            zones[ix].name = name;
+            zones[ix].parent = (int8_t)parent;
+            zones[ix].depth = (uint8_t)stack_size;
+            zones[ix].count = 0;
+            zones[ix].total = 0;
+            zones[ix].min = UINT64_MAX;
+            zones[ix].max = 0;
+        }
+
+        if (ix < 0 || stack_size >= EI_PROFILER_MAX_DEPTH) {
+            dropped++;
+            return -1;
+        }
+
+        stack[stack_size++] = (int8_t)ix;
+        return ix;
+    }
+
+    void leave(int ix, uint64_t elapsed)
+    {
+        if (ix < 0) {
+            return;
+        }
+
+        stack_size--;
+        ei_profiler_zone_t *zone = &zones[ix];
+        zone->count++;
+        zone->total += elapsed;
+        if (elapsed < zone->min) {
+            zone->min = elapsed;
+        }
+        if (elapsed > zone->max) {
+            zone->max = elapsed;
+        }
+    }
+
+    /**
+     * @brief      Print every zone as a tree, children below their parent
+     */
+    void dump()
+    {
+        ei_printf("Profile (%s):\n", EI_PROFILER_UNIT);
+        ei_printf("  %-28s %8s %10s %10s %10s\n", "zone", "count", "mean", "min", "max");
+        for (int ix = 0; ix < zone_count; ix++) {
+            if (zones[ix].parent < 0) {
+                dump_zone(ix);
+            }
+        }
+        if (dropped > 0) {
+            ei_printf("  %u scopes not recorded, increase EI_PROFILER_MAX_ZONES\n", (unsigned int)dropped);
+        }
+    }
+
+private:
+    EiProfilerZones() : zone_count(0), stack_size(0), dropped(0) { }
+
+    int find(const char *name, int parent)
+    {
+        for (int ix = 0; ix < zone_count; ix++) {
+            if (zones[ix].parent == parent &&
+                (zones[ix].name == name || strcmp(zones[ix].name, name) == 0)) {
+                return ix;
+            }
+        }
+        return -1;
+    }
+
+    void dump_zone(int ix)
+    {
+        const ei_profiler_zone_t *zone = &zones[ix];
+
+        if (zone->count > 0) {
+            char label[40];
+            int indent = zone->depth * 2;
+            snprintf(label, sizeof(label), "%*s%s", indent, "", zone->name);
+            ei_printf("  %-28s %8u %10llu %10llu %10llu\n", label, (unsigned int)zone->count,
+                (unsigned long long)(zone->total / zone->count),
+                (unsigned long long)zone->min, (unsigned long long)zone->max);
+        }
+
+        for (int child = ix + 1; child < zone_count; child++) {
+            if (zones[child].parent == ix) {
+                dump_zone(child);
+            }
+        }
+    }
+
+    ei_profiler_zone_t zones[EI_PROFILER_MAX_ZONES];
+    int8_t stack[EI_PROFILER_MAX_DEPTH];
+    int zone_count;
+    int stack_size;
+    uint32_t dropped;
+};
+
+/** Times its own lifetime as one entry of a named zone */
+class EiProfilerScope {
+public:
+    EiProfilerScope(const char *name)
+    {
+        zone = EiProfilerZones::get().enter(name);
+        start = ei_profiler_now();
+    }
+    ~EiProfilerScope()
+    {
+        ei_profiler_ticks_t delta = ei_profiler_now() - start;
+        uint64_t elapsed = delta;
+        EiProfilerZones::get().leave(zone, elapsed);
+    }
+
+private:
+    int zone;
+    ei_profiler_ticks_t start;
+};
+
+#define EI_PROFILER_CONCAT_(a, b) a##b
+#define EI_PROFILER_CONCAT(a, b) EI_PROFILER_CONCAT_(a, b)
+
+#if EI_PROFILER_ENABLED == 1
+#define EI_PROFILE_SCOPE(name) EiProfilerScope EI_PROFILER_CONCAT(ei_profile_scope_, __LINE__)(name)
+#define EI_PROFILE_RESET() EiProfilerZones::get().reset()
+#define EI_PROFILE_DUMP() EiProfilerZones::get().dump()
+#else
+#define EI_PROFILE_SCOPE(name)
+#define EI_PROFILE_RESET()
+#define EI_PROFILE_DUMP()
+#endif // EI_PROFILER_ENABLED == 1
+
 #endif  //!__EIPROFILER__H__
@@ -59,6 +59,7 @@
 #include "returntypes.hpp"
 #include "memory.hpp"
 #include "ei_utils.h"
+#include "ei_profiler.h"
 #include "kissfft/kiss_fftr.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
 
@@ -1381,6 +1382,8 @@ public:
         // pad to the rigth with zeros
         memset(fft_input.buffer + src_size, 0, (n_fft - src_size) * sizeof(float));
 
+        EI_PROFILE_SCOPE("fft");
+
         auto res = ei::fft::hw_r2c_fft(fft_input.buffer, output, n_fft);
         if (handle_fft_hw_failure(res, n_fft)) {
             // fallback to software
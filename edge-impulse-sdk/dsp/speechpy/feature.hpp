@@ -37,6 +37,7 @@
 #include "functions.hpp"
 #include "processing.hpp"
 #include "../memory.hpp"
+#include "../ei_profiler.h"
 #include "../returntypes.hpp"
 #include "../ei_vector.h"
 
@@ -335,13 +336,16 @@ public:
                 EIDSP_ERR(ret);
             }
 
-            ret = numpy::power_spectrum(
-                signal_frame.buffer,
-                stack_frame_info.frame_length,
-                power_spectrum_frame.buffer,
-                power_spectrum_frame_size,
-                fft_length
-            );
+            {
+                EI_PROFILE_SCOPE("power spectrum");
+                ret = numpy::power_spectrum(
+                    signal_frame.buffer,
+                    stack_frame_info.frame_length,
+                    power_spectrum_frame.buffer,
+                    power_spectrum_frame_size,
+                    fft_length
+                );
+            }
 
             if (ret != 0) {
                 EIDSP_ERR(ret);
@@ -356,6 +360,7 @@ public:
                 out_energies->buffer[ix] = energy;
             }
 
+            EI_PROFILE_SCOPE("filterbank");
             auto row_ptr = out_features->get_row_ptr(ix);
             for (size_t i = 0; i < num_filters; i++) {
                 size_t left = bins[i];
@@ -763,7 +768,10 @@ public:
         }
 
         // now do DST type 2
-        ret = numpy::dct2(&features_matrix, DCT_NORMALIZATION_ORTHO);
+        {
+            EI_PROFILE_SCOPE("dct");
+            ret = numpy::dct2(&features_matrix, DCT_NORMALIZATION_ORTHO);
+        }
         if (ret != EIDSP_OK) {
             EIDSP_ERR(ret);
         }
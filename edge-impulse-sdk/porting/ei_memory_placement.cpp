@@ -0,0 +1,204 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ei_memory_placement.h"
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+static portMUX_TYPE placement_lock = portMUX_INITIALIZER_UNLOCKED;
+#define EI_MEMORY_PLACEMENT_LOCK()   portENTER_CRITICAL_SAFE(&placement_lock)
+#define EI_MEMORY_PLACEMENT_UNLOCK() portEXIT_CRITICAL_SAFE(&placement_lock)
+#else
+#define EI_MEMORY_PLACEMENT_LOCK()
+#define EI_MEMORY_PLACEMENT_UNLOCK()
+#endif
+
+/**
+ * Every block carries a small header so ei_free can give the bytes back
+ * to the right region and class. 16 bytes keep the payload 16 byte aligned.
+ */
+typedef struct {
+    uint32_t size;
+    uint8_t cls;
+    uint8_t region;
+    uint8_t reserved[10];
+} ei_memory_block_header_t;
+
+static_assert(sizeof(ei_memory_block_header_t) == 16, "header must keep 16 byte alignment");
+
+static ei_memory_placement_stats_t class_stats[EI_MEMORY_CLASS_COUNT];
+
+static const char *class_names[EI_MEMORY_CLASS_COUNT] = {
+    "default", "scratch", "arena", "weights", "cold"
+};
+
+static const char *region_names[EI_MEMORY_REGION_COUNT] = {
+    "any", "internal", "external"
+};
+
+static ei_memory_region_t preferred_region(ei_memory_class_t cls)
+{
+    switch (cls) {
+        case EI_MEMORY_CLASS_SCRATCH:
+            return EI_MEMORY_PLACEMENT_SCRATCH;
+        case EI_MEMORY_CLASS_ARENA:
+            return EI_MEMORY_PLACEMENT_ARENA;
+        case EI_MEMORY_CLASS_WEIGHTS:
+            return EI_MEMORY_PLACEMENT_WEIGHTS;
+        case EI_MEMORY_CLASS_COLD:
+            return EI_MEMORY_PLACEMENT_COLD;
+        default:
+            return EI_MEMORY_REGION_ANY;
+    }
+}
+
+void *ei_memory_placement_alloc(size_t size, bool zero)
+{
+    ei_memory_class_t cls = ei_memory_current_class();
+    ei_memory_region_t region = preferred_region(cls);
+    size_t total = size + sizeof(ei_memory_block_header_t);
+    bool fallback = false;
+
+    void *block = ei_memory_region_alloc(&region, total);
+    if (block == NULL && region != EI_MEMORY_REGION_ANY) {
+        region = (region == EI_MEMORY_REGION_INTERNAL) ?
+            EI_MEMORY_REGION_EXTERNAL : EI_MEMORY_REGION_INTERNAL;
+        block = ei_memory_region_alloc(&region, total);
+        fallback = true;
+    }
+
+    EI_MEMORY_PLACEMENT_LOCK();
+    ei_memory_placement_stats_t *stats = &class_stats[cls];
+    if (block == NULL) {
+        stats->failures++;
+    }
+    else {
+        stats->allocs++;
+        if (fallback) {
+            stats->fallbacks++;
+        }
+        stats->in_use[region] += size;
+        if (stats->in_use[region] > stats->peak[region]) {
+            stats->peak[region] = stats->in_use[region];
+        }
+    }
+    EI_MEMORY_PLACEMENT_UNLOCK();
+
+    if (block == NULL) {
+        return NULL;
+    }
+
+    ei_memory_block_header_t *header = (ei_memory_block_header_t *)block;
+    header->size = (uint32_t)size;
+    header->cls = (uint8_t)cls;
+    header->region = (uint8_t)region;
+
+    void *ptr = header + 1;
+    if (zero) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+void ei_memory_placement_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    ei_memory_block_header_t *header = (ei_memory_block_header_t *)ptr - 1;
+    ei_memory_region_t region = (ei_memory_region_t)header->region;
+
+    EI_MEMORY_PLACEMENT_LOCK();
+    class_stats[header->cls].in_use[region] -= header->size;
+    EI_MEMORY_PLACEMENT_UNLOCK();
+
+    ei_memory_region_free(region, header, header->size + sizeof(ei_memory_block_header_t));
+}
+
+void ei_memory_placement_get_stats(ei_memory_class_t cls, ei_memory_placement_stats_t *stats)
+{
+    EI_MEMORY_PLACEMENT_LOCK();
+    *stats = class_stats[cls];
+    EI_MEMORY_PLACEMENT_UNLOCK();
+}
+
+/**
+ * @brief      Clear counters and peaks, bytes in use are kept so later frees
+ *             still balance.
+ */
+void ei_memory_placement_reset(void)
+{
+    EI_MEMORY_PLACEMENT_LOCK();
+    for (size_t cls = 0; cls < EI_MEMORY_CLASS_COUNT; cls++) {
+        class_stats[cls].allocs = 0;
+        class_stats[cls].fallbacks = 0;
+        class_stats[cls].failures = 0;
+        for (size_t region = 0; region < EI_MEMORY_REGION_COUNT; region++) {
+            class_stats[cls].peak[region] = class_stats[cls].in_use[region];
+        }
+    }
+    EI_MEMORY_PLACEMENT_UNLOCK();
+}
+
+void ei_memory_placement_print(void)
+{
+    ei_printf("Memory placement (bytes in use / peak):\n");
+    for (size_t cls = 0; cls < EI_MEMORY_CLASS_COUNT; cls++) {
+        ei_memory_placement_stats_t stats;
+        ei_memory_placement_get_stats((ei_memory_class_t)cls, &stats);
+        if (stats.allocs == 0 && stats.failures == 0) {
+            continue;
+        }
+
+        ei_printf("    %-8s %5lu allocs", class_names[cls], (unsigned long)stats.allocs);
+        for (size_t region = EI_MEMORY_REGION_INTERNAL; region < EI_MEMORY_REGION_COUNT; region++) {
+            ei_printf(", %s %u / %u", region_names[region],
+                (unsigned)stats.in_use[region], (unsigned)stats.peak[region]);
+        }
+        if (stats.fallbacks > 0) {
+            ei_printf(", %lu fallbacks", (unsigned long)stats.fallbacks);
+        }
+        if (stats.failures > 0) {
+            ei_printf(", %lu failed", (unsigned long)stats.failures);
+        }
+        ei_printf("\n");
+    }
+}
+
+#endif // EI_MEMORY_PLACEMENT_ENABLED == 1
@@ -0,0 +1,162 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_MEMORY_PLACEMENT_H_
+#define _EI_MEMORY_PLACEMENT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Memory placement for targets with both fast internal RAM and slower
+ * external RAM (e.g. ESP32 with PSRAM). Code that allocates through
+ * ei_malloc/ei_calloc tags its buffers with a class using
+ * EiMemoryPlacement, and the port maps every class to a preferred region,
+ * falling back to the other region when the preferred one is full.
+ * Without EI_MEMORY_PLACEMENT_ENABLED=1 the classes are ignored and
+ * ei_malloc behaves as before.
+ */
+#ifndef EI_MEMORY_PLACEMENT_ENABLED
+#define EI_MEMORY_PLACEMENT_ENABLED 0
+#endif // EI_MEMORY_PLACEMENT_ENABLED
+
+/**
+ * EON constant tensors stay in flash (0) or are copied to RAM when the model
+ * is initialized (1), tagged EI_MEMORY_CLASS_WEIGHTS. Flash reads go through
+ * the cache, which the copy avoids at the cost of RAM.
+ */
+#ifndef EI_CLASSIFIER_EON_WEIGHTS_IN_RAM
+#define EI_CLASSIFIER_EON_WEIGHTS_IN_RAM 0
+#endif // EI_CLASSIFIER_EON_WEIGHTS_IN_RAM
+
+typedef enum {
+    EI_MEMORY_REGION_ANY = 0,
+    EI_MEMORY_REGION_INTERNAL,
+    EI_MEMORY_REGION_EXTERNAL,
+    EI_MEMORY_REGION_COUNT
+} ei_memory_region_t;
+
+typedef enum {
+    /** Untagged allocations, placed the way the port's malloc would */
+    EI_MEMORY_CLASS_DEFAULT = 0,
+    /** Hot, short lived DSP buffers: FFT scratch, feature matrices */
+    EI_MEMORY_CLASS_SCRATCH,
+    /** Tensor arena of the neural network */
+    EI_MEMORY_CLASS_ARENA,
+    /** EON constant tensors copied out of flash (EI_CLASSIFIER_EON_WEIGHTS_IN_RAM) */
+    EI_MEMORY_CLASS_WEIGHTS,
+    /** Large buffers touched once per window: sample and image buffers */
+    EI_MEMORY_CLASS_COLD,
+    EI_MEMORY_CLASS_COUNT
+} ei_memory_class_t;
+
+// Preferred region per class, override from the build to change the policy
+#ifndef EI_MEMORY_PLACEMENT_SCRATCH
+#define EI_MEMORY_PLACEMENT_SCRATCH EI_MEMORY_REGION_INTERNAL
+#endif
+#ifndef EI_MEMORY_PLACEMENT_ARENA
+#define EI_MEMORY_PLACEMENT_ARENA   EI_MEMORY_REGION_INTERNAL
+#endif
+#ifndef EI_MEMORY_PLACEMENT_WEIGHTS
+#define EI_MEMORY_PLACEMENT_WEIGHTS EI_MEMORY_REGION_INTERNAL
+#endif
+#ifndef EI_MEMORY_PLACEMENT_COLD
+#define EI_MEMORY_PLACEMENT_COLD    EI_MEMORY_REGION_EXTERNAL
+#endif
+
+typedef struct {
+    uint32_t allocs;
+    /** Bytes currently allocated in each region */
+    size_t in_use[EI_MEMORY_REGION_COUNT];
+    size_t peak[EI_MEMORY_REGION_COUNT];
+    /** Allocations that did not fit in the preferred region */
+    uint32_t fallbacks;
+    /** Allocations that did not fit anywhere */
+    uint32_t failures;
+} ei_memory_placement_stats_t;
+
+/**
+ * @brief      Class used for ei_malloc/ei_calloc calls made from this point.
+ *             Not per task: tag allocations from the task that owns the
+ *             buffers, and keep the scopes short.
+ */
+inline ei_memory_class_t &ei_memory_current_class(void)
+{
+    static ei_memory_class_t current = EI_MEMORY_CLASS_DEFAULT;
+    return current;
+}
+
+/**
+ * Tags allocations made while in scope with a memory class, e.g.
+ *
+ *     EiMemoryPlacement placement(EI_MEMORY_CLASS_ARENA);
+ *     arena = ei_aligned_calloc(16, arena_size);
+ */
+class EiMemoryPlacement {
+public:
+    EiMemoryPlacement(ei_memory_class_t cls) : previous(ei_memory_current_class())
+    {
+        ei_memory_current_class() = cls;
+    }
+
+    ~EiMemoryPlacement()
+    {
+        ei_memory_current_class() = previous;
+    }
+
+private:
+    ei_memory_class_t previous;
+};
+
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+/**
+ * Implemented in ei_memory_placement.cpp, used by ei_malloc/ei_calloc/ei_free
+ * of the ports that support placement.
+ */
+void *ei_memory_placement_alloc(size_t size, bool zero);
+void ei_memory_placement_free(void *ptr);
+void ei_memory_placement_get_stats(ei_memory_class_t cls, ei_memory_placement_stats_t *stats);
+void ei_memory_placement_reset(void);
+void ei_memory_placement_print(void);
+
+/**
+ * Implemented by the port: allocate from one region (ANY lets the port
+ * choose) and report the region used, or return NULL if it is full.
+ * Memory must be 16 byte aligned.
+ */
+void *ei_memory_region_alloc(ei_memory_region_t *region, size_t size);
+void ei_memory_region_free(ei_memory_region_t region, void *ptr, size_t size);
+#endif // EI_MEMORY_PLACEMENT_ENABLED == 1
+
+#endif // _EI_MEMORY_PLACEMENT_H_
@@ -49,6 +49,11 @@
 
 // memory handling
 #include "esp_heap_caps.h"
+#include "edge-impulse-sdk/dsp/ei_alloc_trace.h"
+#include "edge-impulse-sdk/porting/ei_memory_placement.h"
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+#include "esp_memory_utils.h"
+#endif
 
 #define EI_WEAK_FN __attribute__((weak))
 
@@ -98,36 +103,87 @@ __attribute__((weak)) void ei_printf_float(float f) {
 // we use alligned alloc instead of regular malloc
 // due to https://github.com/espressif/esp-nn/issues/7
 __attribute__((weak)) void *ei_malloc(size_t size) {
-#if defined(CONFIG_IDF_TARGET_ESP32S3)
+    void *ptr;
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+    ptr = ei_memory_placement_alloc(size, false);
+#elif defined(CONFIG_IDF_TARGET_ESP32S3)
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
-    return heap_caps_aligned_alloc(16, size, MALLOC_CAP_DEFAULT);
+    ptr = heap_caps_aligned_alloc(16, size, MALLOC_CAP_DEFAULT);
 #else
-    return aligned_alloc(16, size);
+    ptr = aligned_alloc(16, size);
 #endif
+#else
+    ptr = malloc(size);
 #endif
-    return malloc(size);
+    EI_ALLOC_TRACE_ALLOC(ptr, size);
+    return ptr;
 }
 
 __attribute__((weak)) void *ei_calloc(size_t nitems, size_t size) {
-#if defined(CONFIG_IDF_TARGET_ESP32S3)
+    void *ptr;
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+    ptr = ei_memory_placement_alloc(nitems * size, true);
+#elif defined(CONFIG_IDF_TARGET_ESP32S3)
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
-    return heap_caps_calloc(nitems, size, MALLOC_CAP_DEFAULT);
+    ptr = heap_caps_calloc(nitems, size, MALLOC_CAP_DEFAULT);
 #else
-    void *p;
-    p = aligned_alloc(16, nitems * size);
-    if (p == nullptr)
-        return p;
-
-    memset(p, '\0', nitems * size);
-    return p;
+    ptr = aligned_alloc(16, nitems * size);
+    if (ptr != nullptr) {
+        memset(ptr, '\0', nitems * size);
+    }
 #endif
+#else
+    ptr = calloc(nitems, size);
 #endif
-    return calloc(nitems, size);
+    EI_ALLOC_TRACE_ALLOC(ptr, nitems * size);
+    return ptr;
 }
 
 __attribute__((weak)) void ei_free(void *ptr) {
+    EI_ALLOC_TRACE_FREE(ptr);
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+    ei_memory_placement_free(ptr);
+#else
     free(ptr);
+#endif
+}
+
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+/**
+ * Map placement regions to heap capabilities. Internal RAM is the DRAM the
+ * CPU reaches without going through the cache, external RAM is PSRAM.
+ * Requires ESP-IDF 5.x.
+ */
+void *ei_memory_region_alloc(ei_memory_region_t *region, size_t size) {
+    uint32_t caps;
+
+    switch (*region) {
+        case EI_MEMORY_REGION_INTERNAL:
+            caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+            break;
+        case EI_MEMORY_REGION_EXTERNAL:
+#if defined(CONFIG_SPIRAM)
+            caps = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+            break;
+#else
+            return nullptr;
+#endif
+        default:
+            caps = MALLOC_CAP_DEFAULT;
+            break;
+    }
+
+    void *ptr = heap_caps_aligned_alloc(16, size, caps);
+    if (ptr != nullptr && *region == EI_MEMORY_REGION_ANY) {
+        *region = esp_ptr_external_ram(ptr) ? EI_MEMORY_REGION_EXTERNAL : EI_MEMORY_REGION_INTERNAL;
+    }
+    return ptr;
+}
+
+void ei_memory_region_free(ei_memory_region_t region, void *ptr, size_t size) {
+    heap_caps_free(ptr);
 }
+#endif // EI_MEMORY_PLACEMENT_ENABLED == 1
 
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
 extern "C"
@@ -43,6 +43,9 @@
 #include <stdarg.h>
 #include <stdlib.h>
 
+#include "edge-impulse-sdk/dsp/ei_alloc_trace.h"
+#include "edge-impulse-sdk/porting/ei_memory_placement.h"
+
 __attribute__((weak)) EI_IMPULSE_ERROR ei_run_impulse_check_canceled() {
     return EI_IMPULSE_OK;
 }
@@ -99,16 +102,82 @@ __attribute__((weak)) char ei_getchar(void)
 }
 
 __attribute__((weak)) void *ei_malloc(size_t size) {
-    return malloc(size);
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+    void *ptr = ei_memory_placement_alloc(size, false);
+#else
+    void *ptr = malloc(size);
+#endif
+    EI_ALLOC_TRACE_ALLOC(ptr, size);
+    return ptr;
 }
 
 __attribute__((weak)) void *ei_calloc(size_t nitems, size_t size) {
-    return calloc(nitems, size);
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+    void *ptr = ei_memory_placement_alloc(nitems * size, true);
+#else
+    void *ptr = calloc(nitems, size);
+#endif
+    EI_ALLOC_TRACE_ALLOC(ptr, nitems * size);
+    return ptr;
 }
 
 __attribute__((weak)) void ei_free(void *ptr) {
+    EI_ALLOC_TRACE_FREE(ptr);
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+    ei_memory_placement_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+// Simulated internal RAM and PSRAM, sized like an ESP32 with 4MB PSRAM
+#ifndef EI_MEMORY_SIM_INTERNAL_SIZE
+#define EI_MEMORY_SIM_INTERNAL_SIZE     (160 * 1024)
+#endif
+#ifndef EI_MEMORY_SIM_EXTERNAL_SIZE
+#define EI_MEMORY_SIM_EXTERNAL_SIZE     (4 * 1024 * 1024)
+#endif
+// Untagged blocks up to this size go to internal RAM first, larger ones to
+// PSRAM first (CONFIG_SPIRAM_MALLOC_ALWAYSINTERNAL)
+#ifndef EI_MEMORY_SIM_ALWAYSINTERNAL
+#define EI_MEMORY_SIM_ALWAYSINTERNAL    (16 * 1024)
+#endif
+
+static size_t sim_pool_used[EI_MEMORY_REGION_COUNT] = { 0 };
+static const size_t sim_pool_size[EI_MEMORY_REGION_COUNT] = {
+    0, EI_MEMORY_SIM_INTERNAL_SIZE, EI_MEMORY_SIM_EXTERNAL_SIZE
+};
+
+static bool sim_pool_fits(ei_memory_region_t region, size_t size) {
+    return sim_pool_used[region] + size <= sim_pool_size[region];
+}
+
+void *ei_memory_region_alloc(ei_memory_region_t *region, size_t size) {
+    if (*region == EI_MEMORY_REGION_ANY) {
+        ei_memory_region_t first = size <= EI_MEMORY_SIM_ALWAYSINTERNAL ?
+            EI_MEMORY_REGION_INTERNAL : EI_MEMORY_REGION_EXTERNAL;
+        ei_memory_region_t second = first == EI_MEMORY_REGION_INTERNAL ?
+            EI_MEMORY_REGION_EXTERNAL : EI_MEMORY_REGION_INTERNAL;
+        *region = sim_pool_fits(first, size) ? first : second;
+    }
+
+    if (!sim_pool_fits(*region, size)) {
+        return NULL;
+    }
+
+    void *ptr = aligned_alloc(16, (size + 15) & ~(size_t)15);
+    if (ptr != NULL) {
+        sim_pool_used[*region] += size;
+    }
+    return ptr;
+}
+
+void ei_memory_region_free(ei_memory_region_t region, void *ptr, size_t size) {
+    sim_pool_used[region] -= size;
     free(ptr);
 }
+#endif // EI_MEMORY_PLACEMENT_ENABLED == 1
 
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
 extern "C"
@@ -0,0 +1,125 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_audio_gate.h"
+
+#include <math.h>
+
+void EiAudioSliceStats::reset(void)
+{
+    energy = 0;
+    crossings = 0;
+    count = 0;
+    last_sample = 0;
+    rms = 0.0f;
+    zcr = 0.0f;
+}
+
+void EiAudioSliceStats::add(const int16_t *samples, size_t n_samples)
+{
+    for (size_t i = 0; i < n_samples; i++) {
+        int16_t sample = samples[i];
+
+        energy += (int32_t)sample * sample;
+        crossings += ((sample ^ last_sample) < 0);
+        last_sample = sample;
+    }
+    count += n_samples;
+}
+
+void EiAudioSliceStats::finish(void)
+{
+    if (count > 0) {
+        rms = sqrtf((float)energy / count);
+        zcr = (float)crossings / count;
+    }
+    energy = 0;
+    crossings = 0;
+    count = 0;
+}
+
+void EiAudioGate::start(uint32_t hangover_slices, uint32_t initial_slices)
+{
+    this->hangover_slices = hangover_slices;
+    hangover = initial_slices;
+    noise_floor = 0.0f;
+    closed = false;
+    just_opened = false;
+    last_active = false;
+    slices = 0;
+    skipped = 0;
+    openings = 0;
+}
+
+/**
+ * Falling levels are followed quickly, rising levels slowly so a constant
+ * new background is eventually gated again.
+ */
+bool EiAudioGate::update(float rms, float zcr)
+{
+    slices++;
+    just_opened = false;
+
+    if (noise_floor <= 0.0f) {
+        noise_floor = rms;
+    }
+
+    last_active = (rms > EI_AUDIO_GATE_MIN_RMS) &&
+        ((rms > noise_floor * EI_AUDIO_GATE_RATIO) ||
+         (zcr > EI_AUDIO_GATE_ZCR && rms > noise_floor * EI_AUDIO_GATE_ZCR_RATIO));
+
+    noise_floor += (rms - noise_floor) * (rms < noise_floor ? 0.5f : 0.01f);
+
+    if (last_active) {
+        hangover = hangover_slices;
+    }
+    else if (hangover > 0) {
+        hangover--;
+    }
+
+    if (hangover > 0) {
+        if (closed) {
+            closed = false;
+            just_opened = true;
+            openings++;
+        }
+        return true;
+    }
+
+    closed = true;
+    skipped++;
+
+    return false;
+}
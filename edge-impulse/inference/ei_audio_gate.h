@@ -0,0 +1,126 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_AUDIO_GATE_H
+#define EI_AUDIO_GATE_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stddef.h>
+#include <stdint.h>
+
+/** Slice RMS over the noise floor that opens the gate (2.0 = +6 dB) */
+#ifndef EI_AUDIO_GATE_RATIO
+#define EI_AUDIO_GATE_RATIO         2.0f
+#endif
+/** Lower ratio accepted when the zero crossing rate looks like a fricative */
+#ifndef EI_AUDIO_GATE_ZCR_RATIO
+#define EI_AUDIO_GATE_ZCR_RATIO     1.4f
+#endif
+#ifndef EI_AUDIO_GATE_ZCR
+#define EI_AUDIO_GATE_ZCR           0.25f
+#endif
+/** Levels below this never open the gate, in raw int16 units */
+#ifndef EI_AUDIO_GATE_MIN_RMS
+#define EI_AUDIO_GATE_MIN_RMS       100.0f
+#endif
+
+/**
+ * @brief RMS level and zero crossing rate (crossings per sample) of a slice,
+ * accumulated by the capture task while it copies the samples
+ */
+class EiAudioSliceStats {
+public:
+    void reset(void);
+
+    /** Add the next samples of the slice being captured */
+    void add(const int16_t *samples, size_t n_samples);
+
+    /** The slice is complete, compute its level and start the next one */
+    void finish(void);
+
+    float get_rms(void) const { return rms; }
+    float get_zcr(void) const { return zcr; }
+
+private:
+    uint64_t energy = 0;
+    uint32_t crossings = 0;
+    uint32_t count = 0;
+    int16_t last_sample = 0;
+    float rms = 0.0f;
+    float zcr = 0.0f;
+};
+
+/**
+ * @brief Silence gate for continuous audio. A slice is active when its level
+ * is clearly over the tracked noise floor, or a little over it with a
+ * fricative-like zero crossing rate. The gate stays open for a hangover of
+ * slices after the last active one.
+ */
+class EiAudioGate {
+public:
+    /**
+     * @brief Keep hangover_slices open after an active slice, and the first
+     * initial_slices of the stream while the noise floor settles
+     */
+    void start(uint32_t hangover_slices, uint32_t initial_slices);
+
+    /**
+     * @brief Decide on the slice that just completed
+     * @return true if the slice should be classified
+     */
+    bool update(float rms, float zcr);
+
+    /** The last update() opened the gate after silence */
+    bool opened(void) const { return just_opened; }
+    /** The last update() found the slice active */
+    bool active(void) const { return last_active; }
+    float get_noise_floor(void) const { return noise_floor; }
+
+    uint32_t get_slices(void) const { return slices; }
+    uint32_t get_skipped(void) const { return skipped; }
+    uint32_t get_openings(void) const { return openings; }
+
+private:
+    uint32_t hangover_slices = 0;
+    uint32_t hangover = 0;
+    float noise_floor = 0.0f;
+    bool closed = false;
+    bool just_opened = false;
+    bool last_active = false;
+    uint32_t slices = 0;
+    uint32_t skipped = 0;
+    uint32_t openings = 0;
+};
+
+#endif /* EI_AUDIO_GATE_H */
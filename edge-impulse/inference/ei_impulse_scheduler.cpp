@@ -0,0 +1,335 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_impulse_scheduler.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+#include <cstring>
+
+typedef struct {
+    ei_scheduled_impulse_t config;
+    int64_t release_us;
+    int64_t deadline_us;
+    ei_scheduler_stats_t stats;
+} scheduled_entry_t;
+
+static scheduled_entry_t entries[EI_SCHEDULER_MAX_IMPULSES];
+static int entry_count = 0;
+static ei_scheduler_run_fn_t run_impulse = nullptr;
+static bool debug_mode = false;
+static bool running = false;
+static int64_t started_us = 0;
+static int64_t stopped_us = 0;
+
+/**
+ * One tensor arena shared by every scheduled impulse. Invocations never
+ * overlap, so the arena only has to be as large as the biggest model; it
+ * grows on the first run of each model and is reused afterwards.
+ */
+static void *arena_raw = nullptr;
+static uint8_t *arena = nullptr;
+static size_t arena_size = 0;
+static size_t arena_peak = 0;
+static bool arena_in_use = false;
+
+/**
+ * @brief      Register an impulse with the scheduler
+ *
+ * @return     Id used for ei_scheduler_get_stats, or -1 on error
+ */
+int ei_scheduler_add(const ei_scheduled_impulse_t *config)
+{
+    if (running) {
+        ei_printf("ERR: Cannot add impulses while the scheduler is running\n");
+        return -1;
+    }
+
+    if (config == nullptr || config->handle == nullptr || config->get_input == nullptr
+        || config->period_ms == 0) {
+        ei_printf("ERR: Invalid scheduler configuration\n");
+        return -1;
+    }
+
+    if (entry_count >= EI_SCHEDULER_MAX_IMPULSES) {
+        ei_printf("ERR: Scheduler full, increase EI_SCHEDULER_MAX_IMPULSES\n");
+        return -1;
+    }
+
+    scheduled_entry_t *entry = &entries[entry_count];
+    memset(entry, 0, sizeof(scheduled_entry_t));
+    entry->config = *config;
+    if (entry->config.deadline_ms == 0) {
+        entry->config.deadline_ms = entry->config.period_ms;
+    }
+
+    return entry_count++;
+}
+
+/**
+ * @brief      Release every registered impulse now and start tracking
+ *             utilization
+ *
+ * @param[in]  run_fn  Inference entry point, normally process_impulse
+ */
+bool ei_scheduler_start(ei_scheduler_run_fn_t run_fn, bool debug)
+{
+    if (run_fn == nullptr || entry_count == 0) {
+        ei_printf("ERR: Nothing to schedule\n");
+        return false;
+    }
+
+    run_impulse = run_fn;
+    debug_mode = debug;
+    arena_peak = arena_size;
+    started_us = (int64_t)ei_read_timer_us();
+
+    for (int i = 0; i < entry_count; i++) {
+        scheduled_entry_t *entry = &entries[i];
+        memset(&entry->stats, 0, sizeof(ei_scheduler_stats_t));
+        entry->release_us = started_us;
+        entry->deadline_us = started_us + (int64_t)entry->config.deadline_ms * 1000;
+    }
+
+    running = true;
+    return true;
+}
+
+/**
+ * @brief      Run the released impulse with the earliest deadline
+ *
+ * @return     Microseconds until the next release, 0 if another impulse is
+ *             already due, or -1 when the scheduler is not running
+ */
+int64_t ei_scheduler_poll(void)
+{
+    if (!running) {
+        return -1;
+    }
+
+    int64_t now = (int64_t)ei_read_timer_us();
+    scheduled_entry_t *next = nullptr;
+    int64_t next_release = INT64_MAX;
+
+    for (int i = 0; i < entry_count; i++) {
+        scheduled_entry_t *entry = &entries[i];
+        if (entry->release_us <= now) {
+            if (next == nullptr || entry->deadline_us < next->deadline_us) {
+                next = entry;
+            }
+        }
+        else if (entry->release_us < next_release) {
+            next_release = entry->release_us;
+        }
+    }
+
+    if (next == nullptr) {
+        return next_release - now;
+    }
+
+    const int64_t period_us = (int64_t)next->config.period_ms * 1000;
+    ei::signal_t signal;
+
+    if (next->config.get_input(next->config.ctx, &signal)) {
+        ei_impulse_result_t result;
+        EI_IMPULSE_ERROR res = run_impulse(next->config.handle, &signal, &result, debug_mode);
+
+        int64_t end = (int64_t)ei_read_timer_us();
+        uint32_t elapsed = (uint32_t)(end - now);
+
+        next->stats.runs++;
+        next->stats.busy_us += elapsed;
+        if (elapsed > next->stats.max_us) {
+            next->stats.max_us = elapsed;
+        }
+        if (end > next->deadline_us) {
+            next->stats.deadline_misses++;
+        }
+        if (res != EI_IMPULSE_OK) {
+            next->stats.errors++;
+        }
+
+        if (next->config.on_result) {
+            next->config.on_result(next->config.ctx, next->config.handle, &result, res);
+        }
+        now = end;
+    }
+    else {
+        next->stats.skipped++;
+    }
+
+    next->release_us += period_us;
+    /* drop releases that are already a full period late instead of bursting */
+    while (next->release_us + period_us <= now) {
+        next->release_us += period_us;
+        next->stats.skipped++;
+    }
+    next->deadline_us = next->release_us + (int64_t)next->config.deadline_ms * 1000;
+
+    return 0;
+}
+
+/**
+ * @brief      Stop scheduling and release the shared arena. Registrations
+ *             are kept and statistics stay readable until the next start,
+ *             ei_scheduler_clear() drops them.
+ */
+void ei_scheduler_stop(void)
+{
+    if (running) {
+        stopped_us = (int64_t)ei_read_timer_us();
+        running = false;
+    }
+
+    if (!arena_in_use && arena_raw != nullptr) {
+        ei_free(arena_raw);
+        arena_raw = nullptr;
+        arena = nullptr;
+        arena_size = 0;
+    }
+}
+
+/**
+ * @brief      Forget every registered impulse, the scheduler must be stopped
+ */
+void ei_scheduler_clear(void)
+{
+    if (running) {
+        ei_printf("ERR: Cannot remove impulses while the scheduler is running\n");
+        return;
+    }
+
+    entry_count = 0;
+}
+
+bool ei_scheduler_get_stats(int id, ei_scheduler_stats_t *stats)
+{
+    if (id < 0 || id >= entry_count || stats == nullptr) {
+        return false;
+    }
+
+    *stats = entries[id].stats;
+    return true;
+}
+
+/**
+ * @brief      Print runs, deadline misses and the share of wall time each
+ *             impulse kept the CPU busy
+ */
+void ei_scheduler_print_stats(void)
+{
+    int64_t end = running ? (int64_t)ei_read_timer_us() : stopped_us;
+    int64_t wall_us = end - started_us;
+    float total = 0.0f;
+
+    if (wall_us <= 0) {
+        wall_us = 1;
+    }
+
+    ei_printf("Scheduler: %d impulse(s), %u ms, arena %u bytes\n",
+        entry_count, (unsigned int)(wall_us / 1000), (unsigned int)arena_peak);
+
+    for (int i = 0; i < entry_count; i++) {
+        const ei_scheduler_stats_t *stats = &entries[i].stats;
+        float utilization = 100.0f * (float)stats->busy_us / (float)wall_us;
+        uint32_t avg_us = stats->runs ? (uint32_t)(stats->busy_us / stats->runs) : 0;
+        total += utilization;
+
+        ei_printf("  #%d (project %d) every %u ms: %u runs, %u missed, %u skipped, %u errors, "
+            "avg %u us, max %u us, ",
+            i, (int)entries[i].config.handle->impulse->project_id,
+            (unsigned int)entries[i].config.period_ms,
+            (unsigned int)stats->runs, (unsigned int)stats->deadline_misses,
+            (unsigned int)stats->skipped, (unsigned int)stats->errors,
+            (unsigned int)avg_us, (unsigned int)stats->max_us);
+        ei_printf_float(utilization);
+        ei_printf(" %% CPU\n");
+    }
+
+    ei_printf("  Total ");
+    ei_printf_float(total);
+    ei_printf(" %% CPU\n");
+}
+
+/**
+ * @brief      Tensor arena allocator for ei_set_eon_arena_allocator.
+ *             Hands out the shared arena, growing it if this model needs
+ *             more than any model before it. Memory is zeroed like
+ *             ei_aligned_calloc.
+ */
+void *ei_scheduler_arena_alloc(size_t align, size_t size)
+{
+    if (arena_in_use) {
+        ei_printf("ERR: Shared tensor arena is already in use\n");
+        return nullptr;
+    }
+
+    if (align == 0 || (align & (align - 1)) != 0) {
+        return nullptr;
+    }
+
+    if (arena == nullptr || ((uintptr_t)arena & (align - 1)) != 0 || size > arena_size) {
+        size_t new_size = size > arena_size ? size : arena_size;
+        void *raw = ei_calloc(new_size + align - 1, 1);
+        if (raw == nullptr) {
+            ei_printf("ERR: Failed to allocate %u byte tensor arena\n", (unsigned int)new_size);
+            return nullptr;
+        }
+        if (arena_raw != nullptr) {
+            ei_free(arena_raw);
+        }
+        arena_raw = raw;
+        arena = (uint8_t *)(((uintptr_t)raw + align - 1) & ~((uintptr_t)align - 1));
+        arena_size = new_size;
+        arena_peak = new_size;
+    }
+    else {
+        memset(arena, 0, size);
+    }
+
+    arena_in_use = true;
+    return arena;
+}
+
+/**
+ * @brief      Counterpart of ei_scheduler_arena_alloc. The arena is kept for
+ *             the next model and only freed by ei_scheduler_stop.
+ */
+void ei_scheduler_arena_free(void *ptr)
+{
+    if (ptr != nullptr && ptr == arena) {
+        arena_in_use = false;
+    }
+}
@@ -0,0 +1,103 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef EI_IMPULSE_SCHEDULER_H
+#define EI_IMPULSE_SCHEDULER_H
+
+/* Include ----------------------------------------------------------------- */
+#include <cstdint>
+#include <cstddef>
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+
+/** Maximum number of impulses that can be registered at the same time */
+#ifndef EI_SCHEDULER_MAX_IMPULSES
+#define EI_SCHEDULER_MAX_IMPULSES   4
+#endif
+
+/**
+ * Fill signal with the next window for this impulse.
+ * Return false if no new window is available yet; the release is then
+ * counted as skipped and the impulse waits for its next period.
+ */
+typedef bool (*ei_scheduler_input_fn_t)(void *ctx, ei::signal_t *signal);
+
+/** Called after every invocation with the result and the status it returned */
+typedef void (*ei_scheduler_result_fn_t)(void *ctx,
+                                         ei_impulse_handle_t *handle,
+                                         ei_impulse_result_t *result,
+                                         EI_IMPULSE_ERROR status);
+
+/**
+ * Runs one window through an impulse. Normally process_impulse, passed in
+ * from the translation unit that includes ei_run_classifier.h.
+ */
+typedef EI_IMPULSE_ERROR (*ei_scheduler_run_fn_t)(ei_impulse_handle_t *handle,
+                                                  ei::signal_t *signal,
+                                                  ei_impulse_result_t *result,
+                                                  bool debug);
+
+typedef struct {
+    ei_impulse_handle_t *handle;
+    uint32_t period_ms;
+    /** Relative deadline, 0 uses the period */
+    uint32_t deadline_ms;
+    ei_scheduler_input_fn_t get_input;
+    ei_scheduler_result_fn_t on_result;
+    void *ctx;
+} ei_scheduled_impulse_t;
+
+typedef struct {
+    uint32_t runs;
+    /** Invocations that finished after their deadline */
+    uint32_t deadline_misses;
+    /** Releases dropped because input was not ready or the impulse fell a period behind */
+    uint32_t skipped;
+    uint32_t errors;
+    uint64_t busy_us;
+    uint32_t max_us;
+} ei_scheduler_stats_t;
+
+int ei_scheduler_add(const ei_scheduled_impulse_t *config);
+bool ei_scheduler_start(ei_scheduler_run_fn_t run_fn, bool debug = false);
+int64_t ei_scheduler_poll(void);
+void ei_scheduler_stop(void);
+void ei_scheduler_clear(void);
+bool ei_scheduler_get_stats(int id, ei_scheduler_stats_t *stats);
+void ei_scheduler_print_stats(void);
+
+void *ei_scheduler_arena_alloc(size_t align, size_t size);
+void ei_scheduler_arena_free(void *ptr);
+
+#endif /* EI_IMPULSE_SCHEDULER_H */
@@ -0,0 +1,136 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_inference_stats.h"
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/dsp/ei_profiler.h"
+#include "edge-impulse-sdk/dsp/ei_alloc_trace.h"
+#include "edge-impulse-sdk/porting/ei_memory_placement.h"
+
+#if EI_ALLOC_TRACE_ENABLED == 1
+static ei_alloc_trace_window_t trace_window;
+/* heap activity inside run_classifier, worst case over all inferences */
+static uint32_t trace_allocs_max = 0;
+static size_t trace_peak_max = 0;
+static long trace_retained = 0;
+/** Inferences since the classifier was initialised, the first one sets up its buffers */
+static uint32_t trace_inferences = 0;
+#endif
+
+/**
+ * @brief      Clear the profiler zones, the heap trace and the placement
+ *             counters when a runner starts
+ */
+void ei_inference_stats_reset(void)
+{
+    EI_PROFILE_RESET();
+#if EI_ALLOC_TRACE_ENABLED == 1
+    trace_allocs_max = 0;
+    trace_peak_max = 0;
+    trace_retained = 0;
+    trace_inferences = 0;
+    ei_alloc_trace_reset();
+#endif
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+    ei_memory_placement_reset();
+#endif
+}
+
+/**
+ * @brief      The classifier was initialised again, its next inference may
+ *             allocate its buffers
+ */
+void ei_inference_stats_classifier_init(void)
+{
+#if EI_ALLOC_TRACE_ENABLED == 1
+    trace_inferences = 0;
+#endif
+}
+
+/**
+ * @brief      Call right before run_classifier or run_classifier_continuous
+ */
+void ei_inference_stats_begin(void)
+{
+#if EI_ALLOC_TRACE_ENABLED == 1
+    ei_alloc_trace_begin(&trace_window);
+#endif
+}
+
+/**
+ * @brief      Call right after the inference. Every inference after the
+ *             first one is checked for heap allocations.
+ *
+ * @param[in]  debug  Print the heap activity of this inference
+ */
+void ei_inference_stats_end(bool debug)
+{
+#if EI_ALLOC_TRACE_ENABLED == 1
+    ei_alloc_trace_end(&trace_window);
+    if (trace_window.allocs > trace_allocs_max) {
+        trace_allocs_max = trace_window.allocs;
+    }
+    if (trace_window.peak > trace_peak_max) {
+        trace_peak_max = trace_window.peak;
+    }
+    trace_retained += trace_window.retained;
+    if (trace_inferences++ > 0) {
+        ei_alloc_trace_check_steady(&trace_window, "run_classifier");
+    }
+    if (debug) {
+        ei_printf("Heap: %u allocs, %u bytes peak, %ld bytes retained by this inference\n",
+            (unsigned)trace_window.allocs, (unsigned)trace_window.peak, trace_window.retained);
+    }
+#else
+    (void)debug;
+#endif
+}
+
+/**
+ * @brief      Print the profiler zones, the heap use per inference and where
+ *             the buffers were placed, when a runner stops
+ */
+void ei_inference_stats_print(void)
+{
+    EI_PROFILE_DUMP();
+#if EI_ALLOC_TRACE_ENABLED == 1
+    ei_printf("Per inference: %lu allocs max, %u bytes peak max, %ld bytes retained in total\n",
+        (unsigned long)trace_allocs_max, (unsigned)trace_peak_max, trace_retained);
+    ei_alloc_trace_print();
+#endif
+#if EI_MEMORY_PLACEMENT_ENABLED == 1
+    ei_memory_placement_print();
+#endif
+}
@@ -42,8 +42,33 @@
 #include "edge-impulse-sdk/dsp/numpy.hpp"
 #include "ei_microphone.h"
 #include "ei_device_espressif_esp32.h"
+#include "ei_impulse_scheduler.h"
+#include "ei_audio_gate.h"
+#include "ei_inference_stats.h"
 #include "ei_run_impulse.h"
 
+#include "esp_timer.h"
+
+/** Longest time the runner blocks before checking for a stop request */
+#define STOP_POLL_MS    100
+
+/**
+ * Silence gate for continuous mode. Slices whose level stays close to the
+ * tracked noise floor skip DSP and the neural network entirely; the last
+ * slices before speech are kept and replayed so the feature window is
+ * complete again when the gate opens.
+ */
+#ifndef EI_AUDIO_GATE_ENABLED
+#define EI_AUDIO_GATE_ENABLED       0
+#endif
+/** Slices kept open after the last active one */
+#ifndef EI_AUDIO_GATE_HANGOVER
+#define EI_AUDIO_GATE_HANGOVER      EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW
+#endif
+
+#define AUDIO_GATE_PREROLL          (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW - 1)
+#define AUDIO_GATE_PREROLL_SLOTS    (AUDIO_GATE_PREROLL > 0 ? AUDIO_GATE_PREROLL : 1)
+
 typedef enum {
     INFERENCE_STOPPED,
     INFERENCE_WAITING,
@@ -57,26 +82,168 @@ static inference_state_t state = INFERENCE_STOPPED;
 static uint64_t last_inference_ts = 0;
 static bool continuous_mode = false;
 static bool debug_mode = false;
+/** Windows are classified on a fixed period by ei_impulse_scheduler */
+static bool scheduled_mode = false;
+
+/* runner statistics, printed when inferencing stops */
+static uint32_t runner_wakeups = 0;
+static int64_t runner_start_us = 0;
+static uint32_t results_count = 0;
+static uint64_t latency_sum_us = 0;
+static uint32_t latency_max_us = 0;
+static uint32_t reported_overruns = 0;
+
+#if EI_AUDIO_GATE_ENABLED
+static EiAudioGate gate;
+static int16_t *gate_preroll = nullptr;
+static uint32_t gate_preroll_head;
+static uint32_t gate_preroll_count;
+static const int16_t *gate_replay_slice;
+
+static int audio_gate_replay_get_data(size_t offset, size_t length, float *out_ptr)
+{
+    return ei::numpy::int16_to_float(&gate_replay_slice[offset], out_ptr, length);
+}
+
+/**
+ * @brief Restart the feature window from the kept slices so the next result
+ * covers a full, contiguous window of audio
+ */
+static EI_IMPULSE_ERROR audio_gate_replay(void)
+{
+    signal_t signal;
+    ei_impulse_result_t result = { 0 };
+    uint32_t first = (gate_preroll_head + AUDIO_GATE_PREROLL_SLOTS - gate_preroll_count) % AUDIO_GATE_PREROLL_SLOTS;
+
+    run_classifier_deinit();
+    run_classifier_init();
+    ei_inference_stats_classifier_init();
+
+    signal.total_length = EI_CLASSIFIER_SLICE_SIZE;
+    signal.get_data = &audio_gate_replay_get_data;
+
+    // fewer than a window's worth of slices, the NN does not run here
+    for (uint32_t i = 0; i < gate_preroll_count; i++) {
+        gate_replay_slice = &gate_preroll[((first + i) % AUDIO_GATE_PREROLL_SLOTS) * EI_CLASSIFIER_SLICE_SIZE];
+        EI_IMPULSE_ERROR ei_error = run_classifier_continuous(&signal, &result, false);
+        if (ei_error != EI_IMPULSE_OK) {
+            return ei_error;
+        }
+    }
+
+    // print as soon as the window is full again
+    print_results = (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW >> 1) - 1 -
+        (AUDIO_GATE_PREROLL - gate_preroll_count);
+    gate_preroll_count = 0;
+
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief Run the gate on the slice that just completed
+ *
+ * @return true when the slice should not be classified
+ */
+static bool audio_gate_skip_slice(void)
+{
+    float rms, zcr;
+
+    ei_microphone_inference_get_slice_stats(&rms, &zcr);
+    bool open = gate.update(rms, zcr);
+
+    if (debug_mode) {
+        ei_printf("Gate: rms %.1f zcr %.3f floor %.1f %s\n",
+            rms, zcr, gate.get_noise_floor(), gate.active() ? "active" : "silent");
+    }
 
+    if (open) {
+        if (gate.opened()) {
+            EI_IMPULSE_ERROR ei_error = audio_gate_replay();
+            if (ei_error != EI_IMPULSE_OK) {
+                ei_printf("Failed to replay audio before gate opened (%d)\n", ei_error);
+            }
+        }
+        return false;
+    }
+
+    if (gate_preroll != nullptr && AUDIO_GATE_PREROLL > 0) {
+        memcpy(&gate_preroll[gate_preroll_head * EI_CLASSIFIER_SLICE_SIZE],
+            ei_microphone_inference_get_buffer(), EI_CLASSIFIER_SLICE_SIZE * sizeof(int16_t));
+        gate_preroll_head = (gate_preroll_head + 1) % AUDIO_GATE_PREROLL_SLOTS;
+        if (gate_preroll_count < AUDIO_GATE_PREROLL) {
+            gate_preroll_count++;
+        }
+    }
+
+    return true;
+}
+
+static void audio_gate_start(void)
+{
+    // open while the first window fills, the floor settles in the meantime
+    gate.start(EI_AUDIO_GATE_HANGOVER, EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);
+    ei_microphone_inference_set_slice_stats(true);
+    gate_preroll_head = 0;
+    gate_preroll_count = 0;
+
+    gate_preroll = (int16_t *)ei_malloc(AUDIO_GATE_PREROLL_SLOTS * EI_CLASSIFIER_SLICE_SIZE * sizeof(int16_t));
+    if (gate_preroll == nullptr) {
+        ei_printf("WARN: No memory for gate pre-roll, results resume one window after silence\n");
+    }
+}
+
+static void audio_gate_stop(void)
+{
+    ei_microphone_inference_set_slice_stats(false);
+
+    if (gate.get_slices() > 0) {
+        ei_printf("Silence gate: %lu of %lu slices skipped (%.1f%%), opened %lu times\n",
+            gate.get_skipped(), gate.get_slices(),
+            100.0f * gate.get_skipped() / gate.get_slices(), gate.get_openings());
+    }
+
+    ei_free(gate_preroll);
+    gate_preroll = nullptr;
+}
+#endif /* EI_AUDIO_GATE_ENABLED */
+
+/**
+ * @brief Advance the state machine. Blocks until the capture task signals a
+ * full slice, or for at most STOP_POLL_MS so a stop request is still seen.
+ */
 void ei_run_impulse(void)
 {
+    int64_t ready_us = 0;
+
+    runner_wakeups++;
+
     switch(state) {
         case INFERENCE_STOPPED:
             // nothing to do
             return;
-        case INFERENCE_WAITING:
-            if(ei_read_timer_ms() < (last_inference_ts + 2000)) {
+        case INFERENCE_WAITING: {
+            uint64_t now = ei_read_timer_ms();
+            if(now < (last_inference_ts + 2000)) {
+                uint64_t left = last_inference_ts + 2000 - now;
+                ei_sleep(left < STOP_POLL_MS ? left : STOP_POLL_MS);
                 return;
             }
             state = INFERENCE_SAMPLING;
             ei_microphone_inference_reset_buffers();
-            break;
+            return;
+        }
         case INFERENCE_SAMPLING:
-            // wait for data to be collected through callback
-            if (ei_microphone_inference_is_recording()) {
+            // wait for the capture task to fill a buffer
+            if (ei_microphone_inference_wait(STOP_POLL_MS, &ready_us) == false) {
                 return;
             }
             state = INFERENCE_DATA_READY;
+#if EI_AUDIO_GATE_ENABLED
+            if (continuous_mode == true && audio_gate_skip_slice() == true) {
+                state = INFERENCE_SAMPLING;
+                return;
+            }
+#endif
             break;
             // nothing to do, just continue to inference provcessing below
         case INFERENCE_DATA_READY:
@@ -92,17 +259,35 @@ void ei_run_impulse(void)
     // run the impulse: DSP, neural network and the Anomaly algorithm
     ei_impulse_result_t result = { 0 };
     EI_IMPULSE_ERROR ei_error;
+    ei_inference_stats_begin();
     if(continuous_mode == true) {
         ei_error = run_classifier_continuous(&signal, &result, debug_mode);
     }
     else {
         ei_error = run_classifier(&signal, &result, debug_mode);
     }
+    ei_inference_stats_end(debug_mode);
     if (ei_error != EI_IMPULSE_OK) {
         ei_printf("Failed to run impulse (%d)", ei_error);
         return;
     }
 
+    if (ready_us != 0) {
+        uint32_t latency_us = (uint32_t)(esp_timer_get_time() - ready_us);
+        latency_sum_us += latency_us;
+        if (latency_us > latency_max_us) {
+            latency_max_us = latency_us;
+        }
+        results_count++;
+    }
+
+    if (ei_microphone_inference_get_overruns() != reported_overruns) {
+        reported_overruns = ei_microphone_inference_get_overruns();
+        ei_printf(
+            "Error sample buffer overrun. Decrease the number of slices per model window "
+            "(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW)\n");
+    }
+
     if(continuous_mode == true) {
         if(++print_results >= (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW >> 1)) {
             ei_print_results(&ei_default_impulse, &result);
@@ -123,6 +308,117 @@ void ei_run_impulse(void)
     }
 }
 
+/**
+ * @brief Scheduler input, hands over the newest complete window. Returns
+ * false when no window completed since the previous release, the scheduler
+ * then counts the release as skipped.
+ */
+static bool scheduled_get_input(void *ctx, ei::signal_t *signal)
+{
+    int64_t ready_us = 0;
+
+    if (ei_microphone_inference_wait(0, &ready_us) == false) {
+        return false;
+    }
+
+    *(int64_t *)ctx = ready_us;
+    signal->total_length = EI_CLASSIFIER_RAW_SAMPLE_COUNT;
+    signal->get_data = &ei_microphone_inference_get_data;
+
+    return true;
+}
+
+static void scheduled_on_result(void *ctx, ei_impulse_handle_t *handle,
+                                ei_impulse_result_t *result, EI_IMPULSE_ERROR status)
+{
+    if (status != EI_IMPULSE_OK) {
+        ei_printf("Failed to run impulse (%d)\n", status);
+        return;
+    }
+
+    uint32_t latency_us = (uint32_t)(esp_timer_get_time() - *(int64_t *)ctx);
+    latency_sum_us += latency_us;
+    if (latency_us > latency_max_us) {
+        latency_max_us = latency_us;
+    }
+    results_count++;
+
+    ei_print_results(handle, result);
+}
+
+static void runner_reset_stats(void)
+{
+    runner_wakeups = 0;
+    runner_start_us = esp_timer_get_time();
+    results_count = 0;
+    latency_sum_us = 0;
+    latency_max_us = 0;
+    reported_overruns = 0;
+    ei_inference_stats_reset();
+}
+
+/**
+ * @brief Classify the microphone through ei_impulse_scheduler: the window is
+ * released every period_ms and has to be classified within deadline_ms (0
+ * uses the period). Runs, deadline misses, skipped releases and CPU share
+ * are printed when stopped. EON models take their tensor arena from the
+ * scheduler's shared arena.
+ */
+void ei_start_impulse_scheduled(uint32_t period_ms, uint32_t deadline_ms, bool debug)
+{
+    static int64_t window_ready_us = 0;
+    ei_scheduled_impulse_t config = {};
+
+    config.handle = &ei_default_impulse;
+    config.period_ms = period_ms;
+    config.deadline_ms = deadline_ms;
+    config.get_input = &scheduled_get_input;
+    config.on_result = &scheduled_on_result;
+    config.ctx = &window_ready_us;
+
+    ei_scheduler_clear();
+    if (ei_scheduler_add(&config) < 0) {
+        return;
+    }
+
+    continuous_mode = false;
+    debug_mode = debug;
+    scheduled_mode = true;
+
+    if (ei_microphone_inference_start(EI_CLASSIFIER_RAW_SAMPLE_COUNT, EI_CLASSIFIER_INTERVAL_MS) == false) {
+        ei_printf("ERR: Could not allocate audio buffer (size %d), this could be due to the window length of your model\r\n", EI_CLASSIFIER_RAW_SAMPLE_COUNT);
+        scheduled_mode = false;
+        return;
+    }
+
+#if EI_CLASSIFIER_COMPILED == 1
+    ei_set_eon_arena_allocator(&ei_scheduler_arena_alloc, &ei_scheduler_arena_free);
+#endif
+
+    ei_printf("Classifying every %lu ms, press 'b' to break\n", period_ms);
+
+    run_classifier_init(&ei_default_impulse);
+    runner_reset_stats();
+    state = INFERENCE_SAMPLING;
+
+    if (ei_scheduler_start(&process_impulse, debug) == false) {
+        ei_stop_impulse();
+        return;
+    }
+
+    while(!ei_user_invoke_stop()) {
+        int64_t wait_us = ei_scheduler_poll();
+        runner_wakeups++;
+
+        if (wait_us > 0) {
+            uint32_t wait_ms = (uint32_t)((wait_us + 999) / 1000);
+            ei_sleep(wait_ms < STOP_POLL_MS ? wait_ms : STOP_POLL_MS);
+        }
+    }
+
+    ei_stop_impulse();
+}
+
 void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed)
 {
     const float sample_length = 1000.0f * static_cast<float>(EI_CLASSIFIER_RAW_SAMPLE_COUNT) /
@@ -148,6 +444,9 @@ void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed)
         // only print when we run the complete maf buffer to prevent printing the same classification multiple times.
         print_results = -(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);
         run_classifier_init();
+#if EI_AUDIO_GATE_ENABLED
+        audio_gate_start();
+#endif
         state = INFERENCE_SAMPLING;
     }
     else {
@@ -163,9 +462,10 @@ void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed)
         return;
     }
 
+    runner_reset_stats();
+
     while(!ei_user_invoke_stop()) {
         ei_run_impulse();
-        ei_sleep(1);
     }
 
     ei_stop_impulse();
@@ -176,6 +476,32 @@ void ei_stop_impulse(void)
 {
     if(state != INFERENCE_STOPPED) {
         ei_printf("Inferencing stopped by user\r\n");
+
+        float run_s = (esp_timer_get_time() - runner_start_us) / 1000000.0f;
+        if (run_s > 0.0f) {
+            ei_printf("Runner wakeups: %.1f/s\n", runner_wakeups / run_s);
+        }
+        if (results_count > 0) {
+            ei_printf("Slice to result: %lu us mean, %lu us max\n",
+                (uint32_t)(latency_sum_us / results_count), latency_max_us);
+        }
+        if (scheduled_mode == true) {
+            ei_scheduler_stop();
+            ei_scheduler_print_stats();
+#if EI_CLASSIFIER_COMPILED == 1
+            ei_set_eon_arena_allocator(nullptr, nullptr);
+#endif
+            scheduled_mode = false;
+        }
+        ei_print_cascade_stats(&ei_default_impulse);
+        ei_inference_stats_print();
+
+#if EI_AUDIO_GATE_ENABLED
+        if (continuous_mode == true) {
+            audio_gate_stop();
+        }
+#endif
+
         // EiDevice.set_state(eiStateFinished);
         /* reset samples buffer */
         ei_microphone_inference_end();
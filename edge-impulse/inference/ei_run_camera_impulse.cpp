@@ -40,6 +40,7 @@
 #include "edge-impulse-sdk/classifier/ei_run_classifier.h"
 #include "edge-impulse-sdk/classifier/ei_print_results.h"
 #include "edge-impulse-sdk/dsp/image/image.hpp"
+#include "edge-impulse-sdk/porting/ei_memory_placement.h"
 #include "ei_camera.h"
 #include "firmware-sdk/at_base64_lib.h"
 #include "firmware-sdk/jpeg/encode_as_jpg.h"
@@ -127,7 +128,10 @@ void ei_run_impulse(void)
         return;
     }
 
-    snapshot_buf = (uint8_t*)ei_malloc(snapshot_buf_size);
+    {
+        EiMemoryPlacement placement(EI_MEMORY_CLASS_COLD);
+        snapshot_buf = (uint8_t*)ei_malloc(snapshot_buf_size);
+    }
 
     // check if allocation was successful
     if(snapshot_buf == nullptr) {
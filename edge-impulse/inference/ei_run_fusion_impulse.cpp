@@ -42,8 +42,14 @@
 #include "edge-impulse-sdk/dsp/numpy.hpp"
 #include "firmware-sdk/ei_fusion.h"
 #include "ei_device_espressif_esp32.h"
+#include "ei_inference_stats.h"
 #include "ei_run_impulse.h"
 
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
 typedef enum {
     INFERENCE_STOPPED,
     INFERENCE_WAITING,
@@ -57,8 +63,112 @@ static inference_state_t state = INFERENCE_STOPPED;
 static uint64_t last_inference_ts = 0;
 static bool continuous_mode = false;
 static bool debug_mode = false;
-static float samples_circ_buff[EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE];
-static int samples_wr_index = 0;
+/** One slide more than a window, filled while the current window is classified */
+#define SAMPLES_RING_SIZE \
+    (EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE + EI_CLASSIFIER_SLICE_SIZE * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME)
+
+static float samples_ring[SAMPLES_RING_SIZE];
+/** Next write position in samples_ring */
+static size_t samples_head = 0;
+/** Values written since the last inference and since start */
+static uint32_t samples_since_inference = 0;
+static uint32_t samples_collected = 0;
+/** Window handed to the classifier, samples_ring is read in place */
+static size_t window_start = 0;
+static size_t window_size = 0;
+static bool window_in_use = false;
+static uint32_t samples_since_window = 0;
+/** Slides dropped because inference was still busy with the previous one */
+static uint32_t missed_deadlines = 0;
+static uint32_t reported_missed_deadlines = 0;
+/** All DSP blocks can process a slice and keep their state between slices */
+static bool dsp_per_slice = false;
+static portMUX_TYPE samples_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Continuous mode only works on slices for the MFCC, MFE and spectrogram
+ * blocks, any other block gets the full window on every slide.
+ */
+static bool impulse_supports_slices(void)
+{
+    const ei_impulse_t *impulse = ei_default_impulse.impulse;
+
+    for (size_t ix = 0; ix < impulse->dsp_blocks_size; ix++) {
+        if (impulse->dsp_blocks[ix].extract_fn != extract_mfcc_features
+            && impulse->dsp_blocks[ix].extract_fn != extract_spectrogram_features
+            && impulse->dsp_blocks[ix].extract_fn != extract_mfe_features) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void samples_reset(void)
+{
+    samples_head = 0;
+    samples_since_inference = 0;
+    samples_collected = 0;
+    window_in_use = false;
+    missed_deadlines = 0;
+    reported_missed_deadlines = 0;
+}
+
+/**
+ * @brief signal_t callback, reads the window straight from the ring buffer
+ */
+static int samples_get_data(size_t offset, size_t length, float *out_ptr)
+{
+    size_t start = (window_start + offset) % SAMPLES_RING_SIZE;
+    size_t first_part = SAMPLES_RING_SIZE - start;
+
+    if (first_part >= length) {
+        memcpy(out_ptr, &samples_ring[start], length * sizeof(float));
+    }
+    else {
+        memcpy(out_ptr, &samples_ring[start], first_part * sizeof(float));
+        memcpy(out_ptr + first_part, samples_ring, (length - first_part) * sizeof(float));
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Freeze the newest size values as the window to classify. In continuous
+ * mode sampling carries on in the spare part of the ring.
+ */
+static void take_window(size_t size)
+{
+    taskENTER_CRITICAL(&samples_lock);
+
+    window_start = (samples_head + SAMPLES_RING_SIZE - size) % SAMPLES_RING_SIZE;
+    window_size = size;
+    window_in_use = true;
+    samples_since_window = 0;
+    samples_since_inference = 0;
+    if (continuous_mode == true) {
+        state = INFERENCE_SAMPLING;
+    }
+
+    taskEXIT_CRITICAL(&samples_lock);
+}
+
+/**
+ * @brief Release the window
+ *
+ * @return false if sampling overwrote part of the window during inference
+ */
+static bool release_window(void)
+{
+    taskENTER_CRITICAL(&samples_lock);
+
+    bool intact = samples_since_window <= SAMPLES_RING_SIZE - window_size;
+    window_in_use = false;
+
+    taskEXIT_CRITICAL(&samples_lock);
+
+    return intact;
+}
 
 /**
  * @brief Called for each single sample
@@ -70,24 +180,52 @@ bool samples_callback(const void *raw_sample, uint32_t raw_sample_size)
         // see: sample_timer_callback in ei_inertial_sensor.cpp why we have to return true
         return true;
     }
-    else if(state != INFERENCE_SAMPLING) {
+    else if(state != INFERENCE_SAMPLING && continuous_mode == false) {
         // don't collect samples if we are not in SAMPLING state
         return false;
     }
 
-    float *sample = (float *)raw_sample;
+    const float *sample = (const float *)raw_sample;
+    size_t n_values = raw_sample_size / sizeof(float);
+    size_t first_part = SAMPLES_RING_SIZE - samples_head;
 
-    for(int i = 0; i < (int)(raw_sample_size / sizeof(float)); i++) {
-        samples_circ_buff[samples_wr_index++] = sample[i];
-        if(samples_wr_index >= samples_per_inference) {
-            state = INFERENCE_DATA_READY;
+    if (n_values > SAMPLES_RING_SIZE) {
+        return false;
+    }
+
+    taskENTER_CRITICAL(&samples_lock);
+
+    if (first_part >= n_values) {
+        memcpy(&samples_ring[samples_head], sample, n_values * sizeof(float));
+    }
+    else {
+        memcpy(&samples_ring[samples_head], sample, first_part * sizeof(float));
+        memcpy(samples_ring, sample + first_part, (n_values - first_part) * sizeof(float));
+    }
+    samples_head = (samples_head + n_values) % SAMPLES_RING_SIZE;
+
+    samples_since_inference += n_values;
+    if (samples_collected < EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE) {
+        samples_collected += n_values;
+    }
+    if (window_in_use) {
+        samples_since_window += n_values;
+    }
+
+    // a slide that completes while the previous one still waits is dropped
+    if (samples_since_inference >= samples_per_inference
+        && (dsp_per_slice || samples_collected >= EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE)) {
+        if (state == INFERENCE_DATA_READY) {
+            missed_deadlines++;
+            samples_since_inference -= samples_per_inference;
         }
-        if(samples_wr_index > EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE) {
-            /* start from beginning of the circular buffer */
-            samples_wr_index = 0;
+        else {
+            state = INFERENCE_DATA_READY;
         }
     }
 
+    taskEXIT_CRITICAL(&samples_lock);
+
     return false;
 }
 
@@ -118,51 +256,54 @@ void ei_run_impulse(void)
 
     signal_t signal;
 
-    // shift circular buffer, so the newest data will be the first
-    // if samples_wr_index is 0, then roll is immediately returning
-    numpy::roll(samples_circ_buff, EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE, (-samples_wr_index));
-    /* reset wr index, the oldest data will be overwritten */
-    samples_wr_index = 0;
-
-    // Create a data structure to represent this window of data
-    int err = numpy::signal_from_buffer(samples_circ_buff, EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE, &signal);
-    if (err != 0) {
-        ei_printf("ERR: signal_from_buffer failed (%d)\n", err);
-    }
+    // per slice DSP only needs the newest slide, otherwise classify the whole window
+    take_window((continuous_mode && dsp_per_slice) ? samples_per_inference : EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE);
+    signal.total_length = window_size;
+    signal.get_data = &samples_get_data;
 
     // run the impulse: DSP, neural network and the Anomaly algorithm
     ei_impulse_result_t result = { 0 };
     EI_IMPULSE_ERROR ei_error;
-    if(continuous_mode == true) {
+    ei_inference_stats_begin();
+    if(continuous_mode == true && dsp_per_slice == true) {
         ei_error = run_classifier_continuous(&signal, &result, debug_mode);
     }
     else {
         ei_error = run_classifier(&signal, &result, debug_mode);
     }
+    ei_inference_stats_end(debug_mode);
+
+    bool window_intact = release_window();
 
     if (ei_error != EI_IMPULSE_OK) {
         ei_printf("Failed to run impulse (%d)", ei_error);
         return;
     }
 
-    if(continuous_mode == true) {
-        if(++print_results >= (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW >> 1)) {
+    // sampling overwrote the start of the window, the slide is counted as missed
+    if(window_intact == true) {
+        if(continuous_mode == true && dsp_per_slice == true) {
+            if(++print_results >= (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW >> 1)) {
+                ei_print_results(&ei_default_impulse, &result);
+                print_results = 0;
+            }
+        }
+        else {
             ei_print_results(&ei_default_impulse, &result);
-            print_results = 0;
         }
     }
-    else {
-        ei_print_results(&ei_default_impulse, &result);
-    }
 
-    if(continuous_mode == true) {
-        state = INFERENCE_SAMPLING;
+    if(continuous_mode == true && missed_deadlines != reported_missed_deadlines) {
+        ei_printf("Inference slower than the slide, %lu slides missed\n", missed_deadlines);
+        reported_missed_deadlines = missed_deadlines;
     }
-    else {
+
+    if(continuous_mode == false) {
         ei_printf("Starting inferencing in 2 seconds...\n");
         last_inference_ts = ei_read_timer_ms();
         state = INFERENCE_WAITING;
     }
+    // in continuous mode take_window() already moved on to the next slide
 }
 
 void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed)
@@ -194,25 +335,34 @@ void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed)
     ei_printf("Starting inferencing, press 'b' to break\n");
 
     if (continuous == true) {
-        //samples_per_inference = EI_CLASSIFIER_SLICE_SIZE * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME;
-        // In order to have meaningful classification results, continuous inference has to run over
-        // the complete model window. So the first iterations will print out garbage.
-        // We now use a fixed length moving average filter of half the slices per model window and
-        // only print when we run the complete maf buffer to prevent printing the same classification multiple times.
-        //print_results = -(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);
-        //run_classifier_init();
-        ei_printf("ERR: no continuous classification available for current model\r\n");
-        return;
+        // classify every slice, windows overlap by (EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW - 1) slices
+        samples_per_inference = EI_CLASSIFIER_SLICE_SIZE * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME;
+        memset(samples_ring, 0, sizeof(samples_ring));
+
+        dsp_per_slice = impulse_supports_slices();
+        if (dsp_per_slice) {
+            // In order to have meaningful classification results, continuous inference has to run over
+            // the complete model window. So the first iterations will print out garbage.
+            // We use a fixed length moving average filter of half the slices per model window and
+            // only print when we run the complete maf buffer to prevent printing the same classification multiple times.
+            print_results = -(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW);
+            run_classifier_init();
+        }
+        ei_printf("Classifying every %.0f ms\n",
+            (float)EI_CLASSIFIER_SLICE_SIZE * (float)EI_CLASSIFIER_INTERVAL_MS);
     }
     else {
         samples_per_inference = EI_CLASSIFIER_RAW_SAMPLE_COUNT * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME;
+        dsp_per_slice = false;
         // it's time to prepare for sampling
         ei_printf("Starting inferencing in 2 seconds...\n");
         last_inference_ts = ei_read_timer_ms();
     }
 
+    samples_reset();
+    ei_inference_stats_reset();
     state = INFERENCE_SAMPLING;
-    ei_fusion_sample_start(&samples_callback, EI_CLASSIFIER_INTERVAL_MS);
+    ei_fusion_resampled_sample_start(&samples_callback, EI_CLASSIFIER_INTERVAL_MS);
 
     while(!ei_user_invoke_stop()) {
         if (state == INFERENCE_SAMPLING) {
@@ -230,9 +380,10 @@ void ei_stop_impulse(void)
 {
     if(state != INFERENCE_STOPPED) {
         ei_printf("Inferencing stopped by user\r\n");
+        ei_inference_stats_print();
         // EiDevice.set_state(eiStateFinished);
         /* reset samples buffer */
-        samples_wr_index = 0;
+        samples_reset();
     }
     state = INFERENCE_STOPPED;
 }
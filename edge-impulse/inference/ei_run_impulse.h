@@ -39,6 +39,7 @@
 #include <cstdint>
 
 void ei_start_impulse(bool continuous, bool debug, bool use_max_uart_speed = false);
+void ei_start_impulse_scheduled(uint32_t period_ms, uint32_t deadline_ms, bool debug);
 void ei_run_impulse(void);
 void ei_stop_impulse(void);
 bool is_inference_running(void);
@@ -0,0 +1,197 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_slice_event.h"
+
+#if EI_PORTING_ESPRESSIF == 1
+
+#define SLICE_READY_BIT     (1 << 0)
+
+bool EiSliceEvent::init(void)
+{
+    if (events == NULL) {
+        events = xEventGroupCreate();
+    }
+    if (events == NULL) {
+        return false;
+    }
+
+    clear();
+    overruns = 0;
+
+    return true;
+}
+
+bool EiSliceEvent::signal(int64_t slice_ready_us)
+{
+    bool taken;
+
+    taskENTER_CRITICAL(&lock);
+    taken = (ready == false);
+    if (taken == false) {
+        overruns++;
+    }
+    ready = true;
+    ready_us = slice_ready_us;
+    taskEXIT_CRITICAL(&lock);
+
+    xEventGroupSetBits(events, SLICE_READY_BIT);
+
+    return taken;
+}
+
+bool EiSliceEvent::wait(uint32_t timeout_ms, int64_t *slice_ready_us)
+{
+    EventBits_t bits = xEventGroupWaitBits(
+        events,
+        SLICE_READY_BIT,
+        pdTRUE,
+        pdTRUE,
+        timeout_ms == EI_SLICE_EVENT_WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms));
+
+    if ((bits & SLICE_READY_BIT) == 0) {
+        return false;
+    }
+
+    taskENTER_CRITICAL(&lock);
+    ready = false;
+    if (slice_ready_us != NULL) {
+        *slice_ready_us = ready_us;
+    }
+    taskEXIT_CRITICAL(&lock);
+
+    return true;
+}
+
+bool EiSliceEvent::pending(void)
+{
+    bool is_ready;
+
+    taskENTER_CRITICAL(&lock);
+    is_ready = ready;
+    taskEXIT_CRITICAL(&lock);
+
+    return is_ready;
+}
+
+void EiSliceEvent::clear(void)
+{
+    taskENTER_CRITICAL(&lock);
+    ready = false;
+    taskEXIT_CRITICAL(&lock);
+
+    xEventGroupClearBits(events, SLICE_READY_BIT);
+}
+
+uint32_t EiSliceEvent::get_overruns(void)
+{
+    uint32_t count;
+
+    taskENTER_CRITICAL(&lock);
+    count = overruns;
+    taskEXIT_CRITICAL(&lock);
+
+    return count;
+}
+
+#elif EI_PORTING_POSIX == 1
+
+#include <chrono>
+
+bool EiSliceEvent::init(void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    ready = false;
+    overruns = 0;
+
+    return true;
+}
+
+bool EiSliceEvent::signal(int64_t slice_ready_us)
+{
+    bool taken;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        taken = (ready == false);
+        if (taken == false) {
+            overruns++;
+        }
+        ready = true;
+        ready_us = slice_ready_us;
+    }
+    cv.notify_one();
+
+    return taken;
+}
+
+bool EiSliceEvent::wait(uint32_t timeout_ms, int64_t *slice_ready_us)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    if (timeout_ms == EI_SLICE_EVENT_WAIT_FOREVER) {
+        cv.wait(guard, [this] { return ready; });
+    }
+    else if (cv.wait_for(guard, std::chrono::milliseconds(timeout_ms), [this] { return ready; }) == false) {
+        return false;
+    }
+
+    ready = false;
+    if (slice_ready_us != NULL) {
+        *slice_ready_us = ready_us;
+    }
+
+    return true;
+}
+
+bool EiSliceEvent::pending(void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return ready;
+}
+
+void EiSliceEvent::clear(void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    ready = false;
+}
+
+uint32_t EiSliceEvent::get_overruns(void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return overruns;
+}
+
+#endif
@@ -0,0 +1,101 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_SLICE_EVENT_H
+#define EI_SLICE_EVENT_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stdint.h>
+
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+
+#if EI_PORTING_ESPRESSIF == 1
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#elif EI_PORTING_POSIX == 1
+#include <condition_variable>
+#include <mutex>
+#endif
+
+/** Timeout for EiSliceEvent::wait() that never expires */
+#define EI_SLICE_EVENT_WAIT_FOREVER     UINT32_MAX
+
+/**
+ * @brief Signal from the capture task to the runner that a slice of audio
+ * is complete. The runner blocks in wait() instead of polling a flag, and
+ * a slice completed before the previous one was taken counts as overrun.
+ *
+ * On the ESP32 this is a FreeRTOS event group, on the posix port a
+ * std::condition_variable, both with the same semantics.
+ */
+class EiSliceEvent {
+public:
+    /** Create the event, no slice pending and no overruns */
+    bool init(void);
+
+    /**
+     * @brief Capture side, a slice completed at ready_us
+     * @return false if the previous slice was not taken yet
+     */
+    bool signal(int64_t ready_us);
+
+    /**
+     * @brief Block until a slice is ready and take it
+     * @param[out] ready_us if not NULL, time the slice was completed
+     * @return false on timeout
+     */
+    bool wait(uint32_t timeout_ms, int64_t *ready_us);
+
+    /** A slice is ready and not taken yet */
+    bool pending(void);
+
+    /** Drop a pending slice */
+    void clear(void);
+
+    uint32_t get_overruns(void);
+
+private:
+#if EI_PORTING_ESPRESSIF == 1
+    EventGroupHandle_t events = NULL;
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+#elif EI_PORTING_POSIX == 1
+    std::mutex lock;
+    std::condition_variable cv;
+#endif
+    bool ready = false;
+    int64_t ready_us = 0;
+    uint32_t overruns = 0;
+};
+
+#endif /* EI_SLICE_EVENT_H */
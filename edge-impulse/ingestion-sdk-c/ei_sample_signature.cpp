@@ -0,0 +1,91 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_sample_signature.h"
+
+/**
+ * @brief      Write the CBOR header of a sample to the start of the record,
+ *             skipping the signature text
+ *
+ * @param      mem          Sample memory, with a record opened for writing
+ * @param      ctx          Context initialized by sensor_aq_init()
+ * @param[in]  header_size  Number of header bytes in ctx->cbor_buffer
+ *
+ * @return     false if the header could not be written
+ */
+bool ei_sample_write_header(EiDeviceMemory *mem, sensor_aq_ctx *ctx, size_t header_size)
+{
+    const uint8_t *header = (const uint8_t *)ctx->cbor_buffer.ptr;
+    size_t sig_start = ctx->signature_index;
+    size_t sig_end = sig_start + ctx->hash_buffer.size;
+
+    if (sig_end > header_size) {
+        return false;
+    }
+
+    if (mem->write_sample_data(header, 0, sig_start) != sig_start) {
+        return false;
+    }
+
+    return mem->write_sample_data(header + sig_end, sig_end, header_size - sig_end) == header_size - sig_end;
+}
+
+/**
+ * @brief      Hex encode the signature and write it into the gap left by
+ *             ei_sample_write_header()
+ *
+ * @param      mem   Sample memory, with the record still open
+ * @param      ctx   Context whose hash_buffer holds the raw signature, as
+ *                   written by the signing context's finish()
+ *
+ * @return     false if the signature could not be written
+ */
+bool ei_sample_write_signature(EiDeviceMemory *mem, sensor_aq_ctx *ctx)
+{
+    uint8_t *hash = ctx->hash_buffer.buffer;
+    size_t raw_size = ctx->hash_buffer.size / 2;
+
+    // encode back to front, so every raw byte is read before it is overwritten
+    for (size_t ix = raw_size; ix > 0; ix--) {
+        uint8_t value = hash[ix - 1];
+        uint8_t first = (value >> 4) & 0xf;
+        uint8_t second = value & 0xf;
+
+        hash[(ix - 1) * 2] = first >= 10 ? 87 + first : 48 + first;
+        hash[(ix - 1) * 2 + 1] = second >= 10 ? 87 + second : 48 + second;
+    }
+
+    return mem->write_sample_data(hash, ctx->signature_index, ctx->hash_buffer.size) == ctx->hash_buffer.size;
+}
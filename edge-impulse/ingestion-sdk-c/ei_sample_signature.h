@@ -0,0 +1,55 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _EI_SAMPLE_SIGNATURE_H
+#define _EI_SAMPLE_SIGNATURE_H
+
+/* Include ----------------------------------------------------------------- */
+#include "firmware-sdk/sensor-aq/sensor_aq.h"
+#include "firmware-sdk/ei_device_memory.h"
+
+/**
+ * The HMAC of a sample is only known once all data is written, and the
+ * signature text in the stored header cannot be overwritten without an
+ * erase. The header is therefore stored with the signature left erased
+ * (0xFF) and the signature is written into that gap before the record is
+ * finalized. The signature is computed over the header with the '0'
+ * placeholder, the same as sensor_aq_finish() does.
+ */
+
+/* Function prototypes ----------------------------------------------------- */
+bool ei_sample_write_header(EiDeviceMemory *mem, sensor_aq_ctx *ctx, size_t header_size);
+bool ei_sample_write_signature(EiDeviceMemory *mem, sensor_aq_ctx *ctx);
+
+#endif /* _EI_SAMPLE_SIGNATURE_H */
@@ -44,6 +44,9 @@
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 
 #include "sensor_aq_mbedtls_hs256.h"
+#include "ei_sample_signature.h"
+#include "firmware-sdk/sensor-aq/sensor_aq_none.h"
+#include "ei_uploader_esp32.h"
 
 #include "esp_log.h"
 
@@ -57,6 +60,9 @@ extern int ei_inertial_read_data(void);
 extern void ei_printf(const char *format, ...);
 extern void ei_printf_float(float f);
 
+/** Number of samples collected before they are CBOR encoded as one block */
+#define EI_SAMPLER_BATCH_ROWS 16
+
 /* Forward declarations ---------------------------------------------------- */
 static size_t ei_write(const void *buffer, size_t size, size_t count, EI_SENSOR_AQ_STREAM *);
 static int ei_seek(EI_SENSOR_AQ_STREAM *, long int offset, int origin);
@@ -70,13 +76,24 @@ static uint32_t samples_required;
 static uint32_t current_sample;
 static uint32_t sample_buffer_size;
 static uint32_t headerOffset = 0;
-static uint8_t write_word_buf[4];
+/** Flash sector sized buffer, written and signed as one block */
+static uint8_t *write_buf = NULL;
+static uint32_t write_buf_len = 0;
 static int write_addr = 0;
+/** Samples waiting to be encoded, EI_SAMPLER_BATCH_ROWS rows of sample_size bytes */
+static float *batch_buf = NULL;
+static uint32_t batch_len = 0;
+static uint32_t batch_row_values = 0;
+/** Set by sample_data_callback when a block could not be encoded or written */
+static int sample_error = AQ_OK;
 EI_SENSOR_AQ_STREAM stream;
 
 static unsigned char ei_mic_ctx_buffer[1024];
+/** HMAC context, signs the header and then every flushed write buffer */
 static sensor_aq_signing_ctx_t ei_mic_signing_ctx;
 static sensor_aq_mbedtls_hs256_ctx_t ei_mic_hs_ctx;
+/** Given to sensor_aq for the sample data so it does not sign sample by sample */
+static sensor_aq_signing_ctx_t ei_data_signing_ctx;
 static sensor_aq_ctx ei_mic_ctx = {
     { ei_mic_ctx_buffer, 1024 },
     &ei_mic_signing_ctx,
@@ -87,9 +104,38 @@ static sensor_aq_ctx ei_mic_ctx = {
 
 static const char *TAG = "Sampler";
 
+/**
+ * @brief      Write the buffered sample data to FLASH and add it to the signature
+ *
+ * @return     false if the write or the signature update failed
+ */
+static bool ei_flush_write_buffer(void)
+{
+    EiDeviceInfo* dev = EiDeviceInfo::get_device();
+    EiDeviceMemory* mem = dev->get_memory();
+    uint32_t flush_addr = write_addr - write_buf_len;
+
+    if (write_buf_len == 0) {
+        return true;
+    }
+
+    ESP_LOGD(TAG, "Flushing %lu bytes at %lu\n", write_buf_len, flush_addr);
+
+    if (mem->write_sample_data(write_buf, flush_addr + headerOffset, write_buf_len) != write_buf_len) {
+        write_buf_len = 0;
+        return false;
+    }
+
+    int ctx_err = ei_mic_signing_ctx.update(&ei_mic_signing_ctx, write_buf, write_buf_len);
+    write_buf_len = 0;
+
+    return ctx_err == 0;
+}
+
 /**
  * @brief      Write sample data to FLASH
- * @details    Write size is always 4 bytes to keep alignment
+ * @details    Data is collected in a block sized buffer, which is written
+ *             and signed at once when full
  *
  * @param[in]  buffer     The buffer
  * @param[in]  size       The size
@@ -102,15 +148,29 @@ static size_t ei_write(const void *buffer, size_t size, size_t count, EI_SENSOR_
 {
     EiDeviceInfo* dev = EiDeviceInfo::get_device();
     EiDeviceMemory* mem = dev->get_memory();
-    for (size_t i = 0; i < count; i++) {
-        write_word_buf[write_addr & 0x3] = *((char *)buffer + i);
+    const uint8_t *data = (const uint8_t *)buffer;
+    size_t remaining = count;
+
+    while (remaining > 0) {
+        size_t chunk = mem->block_size - write_buf_len;
+
+        if (chunk > remaining) {
+            chunk = remaining;
+        }
 
-        if ((++write_addr & 0x03) == 0x00) {
+        memcpy(&write_buf[write_buf_len], data, chunk);
+        write_buf_len += chunk;
+        write_addr += chunk;
+        data += chunk;
+        remaining -= chunk;
 
-            mem->write_sample_data(write_word_buf, (write_addr - 4) + headerOffset, 4);
+        if (write_buf_len == mem->block_size) {
+            if (ei_flush_write_buffer() == false) {
+                return count - remaining;
+            }
         }
     }
-    ESP_LOGD(TAG, "\nwriting %02x %02x %02x %02x\n", write_word_buf[0],  write_word_buf[1],  write_word_buf[2],  write_word_buf[3]);
+
     return count;
 }
 
@@ -133,30 +193,26 @@ static time_t ei_time(time_t *t)
 }
 
 /**
- * @brief      Write out remaining data in word buffer to FLASH.
+ * @brief      Write out remaining data in write buffer to FLASH.
  *             And append CBOR end character.
+ *
+ * @return     false if the data could not be written
  */
-static void ei_write_last_data(void)
+static bool ei_write_last_data(void)
 {
     EiDeviceInfo* dev = EiDeviceInfo::get_device();
     EiDeviceMemory* mem = dev->get_memory();
+    uint8_t fill_buf[8];
 
-    uint8_t fill = ((uint8_t)write_addr & 0x03);
-    uint8_t insert_end_address = 0;
-
-    if (fill != 0x00) {
-        for (uint8_t i = fill; i < 4; i++) {
-            write_word_buf[i] = 0xFF;
-        }
-        mem->write_sample_data(write_word_buf, (write_addr & ~0x03) + headerOffset, 4);
-        insert_end_address = 4;
+    if (ei_flush_write_buffer() == false) {
+        return false;
     }
 
-    /* Write appending word for end character */
-    for (uint8_t i = 0; i < 4; i++) {
-        write_word_buf[i] = 0xFF;
-    }
-    mem->write_sample_data(write_word_buf, (write_addr & ~0x03) + headerOffset + insert_end_address, 4);
+    /* Pad to a word and append a word for the end character, not signed */
+    uint8_t fill = (4 - ((uint8_t)write_addr & 0x03)) & 0x03;
+
+    memset(fill_buf, 0xFF, sizeof(fill_buf));
+    return mem->write_sample_data(fill_buf, write_addr + headerOffset, fill + 4) == (uint32_t)(fill + 4);
 }
 
 /**
@@ -187,6 +243,19 @@ bool ei_sampler_start_sampling(void *v_ptr_payload, starter_callback ei_sample_s
 
     ei_printf("Samples req: %d\n", samples_required);
 
+    write_buf = (uint8_t *)ei_malloc(mem->block_size);
+    batch_buf = (float *)ei_malloc(sample_size * EI_SAMPLER_BATCH_ROWS);
+    if (write_buf == NULL || batch_buf == NULL) {
+        ei_printf("ERR: Failed to allocate write buffer\n");
+        ei_free(write_buf);
+        ei_free(batch_buf);
+        return false;
+    }
+    write_buf_len = 0;
+    batch_len = 0;
+    batch_row_values = sample_size / sizeof(float);
+    sample_error = AQ_OK;
+
     // Minimum delay of 2000 ms for daemon
     if (((sample_buffer_size / mem->block_size) + 1) * mem->block_erase_time < 2000) {
         ei_printf("Starting in %d ms... (or until all flash was erased)\n", 2000);
@@ -198,17 +267,25 @@ bool ei_sampler_start_sampling(void *v_ptr_payload, starter_callback ei_sample_s
                     ((sample_buffer_size / mem->block_size) + 1) * mem->block_erase_time);
     }
 
+    mem->setup_sampling(payload->sensors[0].name, dev->get_sample_label().c_str());
+
     if(mem->erase_sample_data(0, sample_buffer_size) != (sample_buffer_size)) {
+        ei_free(write_buf);
+        ei_free(batch_buf);
         return false;
     }
     ESP_LOGD(TAG, "Done erasing\n");
 
     if (create_header(payload) == false) {
+        ei_free(write_buf);
+        ei_free(batch_buf);
         return false;
     }
     ESP_LOGD(TAG, "Done header\n");
 
     if(ei_sample_start(&sample_data_callback, dev->get_sample_interval_ms()) == false) {
+        ei_free(write_buf);
+        ei_free(batch_buf);
         return false;
     }
 
@@ -219,18 +296,47 @@ bool ei_sampler_start_sampling(void *v_ptr_payload, starter_callback ei_sample_s
         ei_sleep(10);
     };
 
-    ei_write_last_data();
+    if (sample_error != AQ_OK) {
+        ei_printf("ERR: Failed to encode or write sample data (%d)\n", sample_error);
+        ei_free(write_buf);
+        write_buf = NULL;
+        ei_free(batch_buf);
+        batch_buf = NULL;
+        return false;
+    }
+
+    bool write_ok = ei_write_last_data();
     write_addr++;
+    ei_free(write_buf);
+    write_buf = NULL;
+    ei_free(batch_buf);
+    batch_buf = NULL;
+
+    if (write_ok == false) {
+        ei_printf("ERR: Failed to write the end of the sample to flash\n");
+        return false;
+    }
 
     uint8_t final_byte[] = {0xff};
-    int ctx_err = ei_mic_ctx.signature_ctx->update(ei_mic_ctx.signature_ctx, final_byte, 1);
+    int ctx_err = ei_mic_signing_ctx.update(&ei_mic_signing_ctx, final_byte, 1);
+    if (ctx_err == 0) {
+        // finish the signing
+        ESP_LOGD(TAG, "Finish the signing \n");
+        ctx_err = ei_mic_signing_ctx.finish(&ei_mic_signing_ctx, ei_mic_ctx.hash_buffer.buffer);
+    }
+
     if (ctx_err != 0) {
-        return ctx_err;
+        ei_printf("ERR: Failed to sign the sample (%d)\n", ctx_err);
+        return false;
+    }
+
+    // the record is only finalized (and uploaded) once it carries its signature
+    if (ei_sample_write_signature(mem, &ei_mic_ctx) == false) {
+        ei_printf("ERR: Failed to write the signature to flash\n");
+        return false;
     }
 
-    // finish the signing
-    ESP_LOGD(TAG, "Finish the signing \n");
-    ctx_err = ei_mic_ctx.signature_ctx->finish(ei_mic_ctx.signature_ctx, ei_mic_ctx.hash_buffer.buffer);
+    mem->finalize_samplig();
 
     finish_and_upload((char*)dev->get_sample_label().c_str(), dev->get_sample_length_ms());
 
@@ -249,6 +355,7 @@ static bool create_header(sensor_aq_payload_info *payload)
     EiDeviceInfo* dev = EiDeviceInfo::get_device();
     EiDeviceMemory* mem = dev->get_memory();
     sensor_aq_init_mbedtls_hs256_context(&ei_mic_signing_ctx, &ei_mic_hs_ctx, dev->get_sample_hmac_key().c_str());
+    ei_mic_ctx.signature_ctx = &ei_mic_signing_ctx;
 
     int tr = sensor_aq_init(&ei_mic_ctx, payload, NULL, true);
 
@@ -271,16 +378,18 @@ static bool create_header(sensor_aq_payload_info *payload)
         return false;
     }
 
-    // Write to blockdevice
-    tr = mem->write_sample_data((uint8_t*)ei_mic_ctx.cbor_buffer.ptr, 0, end_of_header_ix);
+    // Write to blockdevice, the signature is written when the sample is complete
     ESP_LOGD(TAG, "Try to write %d bytes\r\n", end_of_header_ix);
 
-    if (tr != end_of_header_ix) {
-        ei_printf("Failed to write to header blockdevice (%d)\n", tr);
+    if (ei_sample_write_header(mem, &ei_mic_ctx, end_of_header_ix) == false) {
+        ei_printf("Failed to write to header blockdevice\n");
         return false;
     }
 
     ei_mic_ctx.stream = &stream;
+    // sample data gets signed per flushed block, see ei_flush_write_buffer()
+    sensor_aq_init_none_context(&ei_data_signing_ctx);
+    ei_mic_ctx.signature_ctx = &ei_data_signing_ctx;
 
     headerOffset = end_of_header_ix;
     write_addr = 0;
@@ -299,7 +408,12 @@ static void finish_and_upload(char *filename, uint32_t sample_length_ms)
     ei_printf("Done sampling, total samples collected: %u\n", samples_required);
     ei_printf("[1/1] Uploading file to Edge Impulse...\n");
 
-    ei_printf("Not uploading file, not connected to WiFi. Used buffer, from=%d, to=%d.\n", 0, write_addr + headerOffset);
+    if (ei_uploader_enqueue_last()) {
+        ei_printf("Sample queued, uploading in the background over WiFi\n");
+    }
+    else {
+        ei_printf("Not uploading file, not connected to WiFi. Used buffer, from=%d, to=%d.\n", 0, write_addr + headerOffset);
+    }
 
     ei_printf("[1/1] Uploading file to Edge Impulse OK (took %d ms.)\n", 200);
 
@@ -307,16 +421,35 @@ static void finish_and_upload(char *filename, uint32_t sample_length_ms)
 }
 
 /**
- * @brief      Write samples to FLASH in CBOR format
+ * @brief      Collect samples and write them to FLASH in CBOR format,
+ *             EI_SAMPLER_BATCH_ROWS samples at a time
  *
  * @param[in]  sample_buf  The sample buffer
  * @param[in]  byteLength  The byte length
  *
- * @return     true if all required samples are received. Caller should stop sampling,
+ * @return     true if all required samples are received or writing failed.
+ *             Caller should stop sampling,
  */
 static bool sample_data_callback(const void *sample_buf, uint32_t byteLenght)
 {
-    sensor_aq_add_data(&ei_mic_ctx, (float *)sample_buf, byteLenght / sizeof(float));
+    if (sample_buf != NULL && byteLenght == batch_row_values * sizeof(float)) {
+        memcpy(&batch_buf[batch_len * batch_row_values], sample_buf, byteLenght);
+        batch_len++;
+    }
+
+    bool last_sample = (current_sample + 1 >= samples_required);
+
+    if (batch_len > 0 && (batch_len == EI_SAMPLER_BATCH_ROWS || last_sample)) {
+        int ret = sensor_aq_add_data_batch_f32(&ei_mic_ctx, batch_buf, batch_len * batch_row_values);
+        batch_len = 0;
+
+        if (ret != AQ_OK) {
+            // abort the sample, ei_sampler_start_sampling() reports it
+            sample_error = ret;
+            current_sample = samples_required;
+            return true;
+        }
+    }
 
     if (++current_sample >= samples_required) {
         return true;
@@ -37,32 +37,50 @@
  */
 
 #include <string.h>
-#include "firmware-sdk/sensor-aq/sensor_aq.h"
+#include "sensor_aq_mbedtls_hs256.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 
-typedef struct {
-    char hmac_key[33];
-} sensor_aq_mbedtls_hs256_ctx_t;
-
 static int sensor_aq_mbedtls_hs256_init(sensor_aq_signing_ctx_t *aq_ctx) {
     sensor_aq_mbedtls_hs256_ctx_t *hs_ctx = (sensor_aq_mbedtls_hs256_ctx_t*)aq_ctx->ctx;
 
+#if EI_SENSOR_AQ_HS256_ENABLED == 1
+    mbedtls_md_init(&hs_ctx->md_ctx);
+
+    int err = mbedtls_md_setup(&hs_ctx->md_ctx, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 1);
+    if (err != 0) {
+        return err;
+    }
+
+    return mbedtls_md_hmac_starts(&hs_ctx->md_ctx, (const unsigned char*)hs_ctx->hmac_key, strlen(hs_ctx->hmac_key));
+#else
     /* Signature disabled, return zero */
     return 0;
+#endif
 }
 
 static int sensor_aq_mbedtls_hs256_update(sensor_aq_signing_ctx_t *aq_ctx, const uint8_t *buffer, size_t buffer_size) {
     sensor_aq_mbedtls_hs256_ctx_t *hs_ctx = (sensor_aq_mbedtls_hs256_ctx_t*)aq_ctx->ctx;
 
+#if EI_SENSOR_AQ_HS256_ENABLED == 1
+    return mbedtls_md_hmac_update(&hs_ctx->md_ctx, buffer, buffer_size);
+#else
     /* Signature disabled, return zero */
     return 0;
+#endif
 }
 
 static int sensor_aq_mbedtls_hs256_finish(sensor_aq_signing_ctx_t *aq_ctx, uint8_t *buffer) {
     sensor_aq_mbedtls_hs256_ctx_t *hs_ctx = (sensor_aq_mbedtls_hs256_ctx_t*)aq_ctx->ctx;
 
+#if EI_SENSOR_AQ_HS256_ENABLED == 1
+    int err = mbedtls_md_hmac_finish(&hs_ctx->md_ctx, buffer);
+    mbedtls_md_free(&hs_ctx->md_ctx);
+
+    return err;
+#else
     /* Signature disabled, return zero */
     return 0;
+#endif
 }
 
 /**
@@ -82,7 +100,7 @@ void sensor_aq_init_mbedtls_hs256_context(sensor_aq_signing_ctx_t *aq_ctx, senso
 
     aq_ctx->alg = "HS256"; // JWS algorithm
     aq_ctx->signature_length = 32;
-    aq_ctx->ctx = (void*)NULL;
+    aq_ctx->ctx = (void*)hs_ctx;
     aq_ctx->init = &sensor_aq_mbedtls_hs256_init;
     aq_ctx->set_protected = NULL;
     aq_ctx->update = &sensor_aq_mbedtls_hs256_update;
@@ -40,8 +40,24 @@
  */
 #include "firmware-sdk/sensor-aq/sensor_aq.h"
 
+/**
+ * Set to 1 to compute the HMAC, otherwise the signature is left empty.
+ * ESP-IDF's Mbed TLS port runs SHA256 on the hardware accelerator when
+ * CONFIG_MBEDTLS_HARDWARE_SHA is set, so feed it large blocks.
+ */
+#ifndef EI_SENSOR_AQ_HS256_ENABLED
+#define EI_SENSOR_AQ_HS256_ENABLED 0
+#endif
+
+#if EI_SENSOR_AQ_HS256_ENABLED == 1
+#include "mbedtls/md.h"
+#endif
+
 typedef struct {
     char hmac_key[33];
+#if EI_SENSOR_AQ_HS256_ENABLED == 1
+    mbedtls_md_context_t md_ctx;
+#endif
 } sensor_aq_mbedtls_hs256_ctx_t;
 
 /**
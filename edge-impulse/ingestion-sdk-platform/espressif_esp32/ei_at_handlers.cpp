@@ -42,6 +42,11 @@
 #include "at_base64_lib.h"
 
 #include "ei_device_espressif_esp32.h"
+#include "flash_memory.h"
+#include "ei_uploader_esp32.h"
+#include "ei_readback_esp32.h"
+#include "ei_sample_timer_esp32.h"
+#include "ei_fusion_acquisition_esp32.h"
 
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 
@@ -49,6 +54,7 @@
 
 #include "model-parameters/model_metadata.h"
 
+#include <cmath>
 #include <string>
 using namespace std;
 
@@ -251,6 +257,88 @@ bool at_read_buffer(const char **argv, const int argc)
     return true;
 }
 
+bool at_list_files(void)
+{
+    EiFlashMemory *flash = static_cast<EiFlashMemory *>(mem);
+
+    for (auto &record : flash->get_records()) {
+        ei_printf(
+            "%lu, %s, %lu bytes, CRC %08lX%s\n",
+            record.sequence,
+            record.label,
+            record.length,
+            record.crc,
+            (record.flags & EI_SAMPLE_LOG_FLAG_UPLOADED) ? "" : ", uploaded");
+    }
+    ei_printf("%lu waiting for upload\n", ei_uploader_pending());
+
+    return true;
+}
+
+bool at_clear_files(void)
+{
+    EiFlashMemory *flash = static_cast<EiFlashMemory *>(mem);
+
+    flash->clear_records();
+    ei_printf("OK\n");
+
+    return true;
+}
+
+bool at_read_file(const char **argv, const int argc)
+{
+    EiFlashMemory *flash = static_cast<EiFlashMemory *>(mem);
+
+    if (argc < 1) {
+        ei_printf("Missing argument! Required: " AT_READFILE_ARGS "\n");
+        return true;
+    }
+
+    uint32_t sequence = (uint32_t)atoi(argv[0]);
+    uint32_t length = 0;
+
+    for (auto &record : flash->get_records()) {
+        if (record.sequence == sequence) {
+            length = record.length;
+        }
+    }
+
+    if (flash->select_record(sequence) == false) {
+        ei_printf("File '%s' not found\n", argv[0]);
+        return true;
+    }
+
+    bool use_max_baudrate = false;
+    if (argc >= 2 && argv[1][0] == 'y') {
+        use_max_baudrate = true;
+    }
+
+    if (use_max_baudrate) {
+        ei_printf("\r\nOK");
+        ei_sleep(100);
+        dev->set_max_data_output_baudrate();
+        ei_sleep(100);
+    }
+
+    bool success = read_encode_send_sample_buffer(0, length);
+
+    if (use_max_baudrate) {
+        ei_printf("\r\nOK\r\n");
+        ei_sleep(100);
+        dev->set_default_data_output_baudrate();
+        ei_sleep(100);
+    }
+
+    // AT+READBUFFER keeps serving the last recording
+    flash->select_record(flash->get_records().back().sequence);
+
+    if (!success) {
+        ei_printf("Failed to read file\n");
+    }
+
+    return true;
+}
+
 bool at_read_raw(const char **argv, const int argc)
 {
 
@@ -261,23 +349,40 @@ bool at_read_raw(const char **argv, const int argc)
     size_t start = (size_t)atoi(argv[0]);
     size_t length = (size_t)atoi(argv[1]);
 
-    uint8_t buffer[32];
+    if (ei_readback_hex(start, length) == false) {
+        ei_printf("Failed to read from buffer\n");
+        return true;
+    }
 
-    int count = 0;
-    int n_display_bytes = 16;
+    const ei_readback_stats_t *stats = ei_readback_get_stats();
+    if (stats->time_us > 0) {
+        ei_printf("Read %lu bytes in %lu ms (%lu bytes/s at %lu baud)\n",
+            stats->bytes,
+            stats->time_us / 1000,
+            (uint32_t)((uint64_t)stats->bytes * 1000000 / stats->time_us),
+            stats->baudrate);
+    }
 
-    for (; start < length; start += n_display_bytes) {
-        mem->read_sample_data(buffer, start, n_display_bytes);
+    return true;
+}
 
-        for (int i = 0; i < n_display_bytes; i++) {
-            ei_printf("%02X", buffer[i]);
-            if (i % n_display_bytes == n_display_bytes - 1)
-                ei_printf("\n");
-            else
-                ei_printf(" ");
-        }
+bool at_get_sample_timing(void)
+{
+    const ei_sample_timer_stats_t *stats = ei_sample_timer_get_stats();
+
+    ei_printf("Nominal:   %lu us\n", stats->nominal_us);
+    ei_printf("Samples:   %lu\n", stats->samples);
+    ei_printf("Missed:    %lu\n", stats->missed);
+
+    if (stats->samples > 1) {
+        uint32_t intervals = stats->samples - 1;
+        ei_printf("Mean:      %lu us\n", (uint32_t)(stats->sum_us / intervals));
+        ei_printf("Min:       %lu us\n", stats->min_us);
+        ei_printf("Max:       %lu us\n", stats->max_us);
+        ei_printf("Jitter:    %.1f us RMS\n", sqrt((double)stats->sum_sq_dev / intervals));
     }
-    ei_printf("\n");
+
+    ei_fusion_acquisition_print_stats();
 
     return true;
 }
@@ -304,7 +409,10 @@ bool at_sample_start(const char **argv, const int argc)
     }
 
     if (ei_connect_fusion_list(argv[0], SENSOR_FORMAT)) {
+        // sensors on different buses are read in parallel while recording
+        ei_fusion_acquisition_attach();
         if (!ei_fusion_setup_data_sampling()) {
+            ei_fusion_acquisition_detach();
             ei_printf("ERR: Failed to start sensor fusion sampling\n");
         }
     }
@@ -331,8 +439,12 @@ bool at_run_impulse_static_data(const char **argv, const int argc)
 
     bool debug = (argv[0][0] == 'y');
     size_t length = (size_t)atoi(argv[1]);
+    // optional, windows of a longer recording start this many frames apart
+    size_t stride = argc > 2 ? (size_t)atoi(argv[2]) : 0;
+    // optional, overlapping windows share features like continuous mode
+    bool per_slice = argc > 3 && argv[3][0] == 'y';
 
-    bool res = run_impulse_static_data(debug, length, TRANSFER_BUF_LEN);
+    bool res = run_impulse_static_data(debug, length, TRANSFER_BUF_LEN, stride, per_slice);
 
     return res;
 }
@@ -356,6 +468,28 @@ bool at_run_impulse_cont(void)
     return true;
 }
 
+#if defined(EI_CLASSIFIER_SENSOR) && EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_MICROPHONE
+bool at_run_impulse_scheduled(const char **argv, const int argc)
+{
+    if (check_args_num(1, argc) == false) {
+        return false;
+    }
+
+    int period_ms = atoi(argv[0]);
+    int deadline_ms = argc > 1 ? atoi(argv[1]) : 0;
+    bool debug = argc > 2 && argv[2][0] == 'y';
+
+    if (period_ms <= 0 || deadline_ms < 0) {
+        ei_printf("ERR: Invalid period or deadline\n");
+        return false;
+    }
+
+    ei_start_impulse_scheduled((uint32_t)period_ms, (uint32_t)deadline_ms, debug);
+
+    return true;
+}
+#endif
+
 bool at_stop_impulse(void)
 {
     ei_stop_impulse();
@@ -365,38 +499,35 @@ bool at_stop_impulse(void)
 
 static bool at_get_wifi(void)
 {
-    // TODO
-    /*
-    if !(dev->get_wifi_present_status()){
-        ei_printf("No Wifi available for device");
-        return false;
-    }
+    std::string ssid, password;
+    EiWiFiSecurity security;
+
+    dev->get_wifi_config(ssid, password, &security);
 
-    ei_printf("SSID:      %s\n", dev->wifi_ssid);
-    ei_printf("Password:  %s\n", dev->wifi_password);
-    ei_printf("Security:  %d\n", dev->wifi_security);
-    ei_printf("MAC:       %s\n", dev->get_device_id());
+    ei_printf("SSID:      %s\n", ssid.c_str());
+    ei_printf("Password:  %s\n", password.c_str());
+    ei_printf("Security:  %d\n", security);
+    ei_printf("MAC:       %s\n", dev->get_device_id().c_str());
     ei_printf("Connected: %d\n", dev->get_wifi_connection_status());
     ei_printf("Present:   %d\n", dev->get_wifi_present_status());
-    */
+
     return true;
 }
 
 static bool at_set_wifi(const char **argv, const int argc)
 {
-    // TODO
-    /*
-    ei_config_security_t security = (ei_config_security_t)atoi(argv[2]);
-
-    EI_CONFIG_ERROR r = ei_config_set_wifi(argv[0], argv[1], security);
-    if (r != EI_CONFIG_OK) {
-        ei_printf("Failed to persist WiFi config (%d)\n", r);
+    if (check_args_num(3, argc) == false) {
         return false;
     }
-    else {
-        ei_printf("OK\n");
+
+    if (dev->get_wifi_present_status() == false) {
+        ei_printf("No Wifi available for device\n");
+        return false;
     }
-    */
+
+    dev->set_wifi_config(argv[0], argv[1], (EiWiFiSecurity)atoi(argv[2]));
+    ei_printf("OK\n");
+
     return true;
 }
 
@@ -517,18 +648,8 @@ bool at_get_config(void)
 #endif
     ei_printf("Model type:       %s\r\n", model_type);
     ei_printf("\n");
-    // TO-DO NetworkDevice Interface
-    //ei_printf("===== WIFI =====\n");
-    //at_get_wifi();
-    //ei_printf("\n");
-
     ei_printf("===== WIFI =====\n");
-    ei_printf("SSID:      \n");
-    ei_printf("Password:  \n");
-    ei_printf("Security:  0\n");
-    ei_printf("MAC:       %s\n", dev->get_device_id().c_str());
-    ei_printf("Connected: 0\n");
-    ei_printf("Present:   0\n");
+    at_get_wifi();
     ei_printf("\n");
 
     ei_printf("===== Sampling parameters =====\n");
@@ -643,6 +764,15 @@ ATServer *ei_at_init(EiDeviceESP32 *device)
         nullptr,
         nullptr,
         nullptr);
+#if defined(EI_CLASSIFIER_SENSOR) && EI_CLASSIFIER_SENSOR == EI_CLASSIFIER_SENSOR_MICROPHONE
+    at->register_command(
+        AT_RUNIMPULSESCHED,
+        AT_RUNIMPULSESCHED_HELP_TEXT,
+        nullptr,
+        nullptr,
+        at_run_impulse_scheduled,
+        AT_RUNIMPULSESCHED_ARGS);
+#endif
     at->register_command(
         AT_RUNIMPULSESTATIC,
         AT_RUNIMPULSESTATIC_HELP_TEXT,
@@ -671,6 +801,34 @@ ATServer *ei_at_init(EiDeviceESP32 *device)
         nullptr,
         at_read_raw,
         AT_READRAW_ARS);
+    at->register_command(
+        AT_SAMPLETIMING,
+        AT_SAMPLETIMING_HELP_TEXT,
+        nullptr,
+        at_get_sample_timing,
+        nullptr,
+        nullptr);
+    at->register_command(
+        AT_LISTFILES,
+        AT_LISTFILES_HELP_TEXT,
+        at_list_files,
+        nullptr,
+        nullptr,
+        nullptr);
+    at->register_command(
+        AT_CLEARFILES,
+        AT_CLEARFILES_HELP_TEXT,
+        at_clear_files,
+        nullptr,
+        nullptr,
+        nullptr);
+    at->register_command(
+        AT_READFILE,
+        AT_READFILE_HELP_TEXT,
+        nullptr,
+        nullptr,
+        at_read_file,
+        AT_READFILE_ARGS);
     at->register_command(
         AT_WIFI,
         AT_WIFI_HELP_TEXT,
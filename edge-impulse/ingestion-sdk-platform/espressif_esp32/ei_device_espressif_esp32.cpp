@@ -43,6 +43,8 @@
 #include "ei_config_types.h"
 #include "ei_microphone.h"
 #include "flash_memory.h"
+#include "ei_sample_timer_esp32.h"
+#include "ei_fusion_acquisition_esp32.h"
 
 #include "esp_system.h"
 #include "driver/gpio.h"
@@ -50,7 +52,6 @@
 #include "esp_mac.h"
 
 #include <freertos/FreeRTOS.h>
-#include <freertos/timers.h>
 
 /* Constants --------------------------------------------------------------- */
 #define EI_RED_LED_OFF      gpio_set_level(GPIO_NUM_21, 0);
@@ -58,13 +59,6 @@
 #define EI_RED_LED_ON     gpio_set_level(GPIO_NUM_21, 1);
 #define EI_WHITE_LED_ON    gpio_set_level(GPIO_NUM_22, 1);
 
-/** Global objects */
-TimerHandle_t fusion_timer;
-void (*sample_cb_ptr)(void);
-
-/* Private function declarations ------------------------------------------- */
-void vTimerCallback(TimerHandle_t xTimer);
-
 /* Public functions -------------------------------------------------------- */
 
 EiDeviceESP32::EiDeviceESP32(EiDeviceMemory* mem)
@@ -81,10 +75,9 @@ EiDeviceESP32::EiDeviceESP32(EiDeviceMemory* mem)
     cam = static_cast<EiCameraESP32*>(EiCameraESP32::get_camera());
     camera_present = cam->is_camera_present();
 
-    // TODO
-    //net = static_cast<EiWifiESP32*>(EiWifiESP32::get_network_device());
-    // the absence of error on device init is success
-    //network_present = !(net->init());
+    // WiFi is brought up from app_main, see init_network()
+    network_present = false;
+    network_connected = false;
 
     // microphone is not handled by fusion system
     standalone_sensor_list[0].name = "Built-in microphone";
@@ -179,6 +172,34 @@ void EiDeviceESP32::set_state(EiState state)
     }
 }
 
+/**
+ * @brief      Start the WiFi station and connect to the stored network
+ *
+ * @return     true if WiFi is available
+ */
+bool EiDeviceESP32::init_network(void)
+{
+    network_present = ei_wifi_init();
+
+    if (network_present && wifi_ssid.c_str()[0] != 0) {
+        ei_wifi_connect(wifi_ssid.c_str(), wifi_password.c_str(), wifi_security);
+    }
+
+    return network_present;
+}
+
+/**
+ * @brief      Store the credentials and reconnect to the new network
+ */
+void EiDeviceESP32::set_wifi_config(std::string ssid, std::string password, EiWiFiSecurity security, bool save)
+{
+    EiDeviceInfo::set_wifi_config(ssid, password, security, save);
+
+    if (network_present) {
+        ei_wifi_connect(wifi_ssid.c_str(), wifi_password.c_str(), wifi_security);
+    }
+}
+
 /**
  * @brief      No Wifi available for device.
  *
@@ -190,19 +211,17 @@ bool EiDeviceESP32::scan_networks(void)
 }
 
 /**
- * @brief      No Wifi available for device.
- *
- * @return     Always return false
+ * @brief      Station is connected and has an IP address
  */
 bool EiDeviceESP32::get_wifi_connection_status(void)
 {
-    return false;
+    network_connected = ei_wifi_is_connected();
+
+    return network_connected;
 }
 
 /**
- * @brief      No Wifi available for device.
- *
- * @return     Always return false
+ * @brief      WiFi driver was started by init_network()
  */
 bool EiDeviceESP32::get_wifi_present_status(void)
 {
@@ -291,15 +310,14 @@ void EiDeviceESP32::set_max_data_output_baudrate(void)
  */
 bool EiDeviceESP32::start_sample_thread(void (*sample_read_cb)(void), float sample_interval_ms)
 {
-    sample_cb_ptr = sample_read_cb;
-    fusion_timer = xTimerCreate(
-                        "Fusion sampler",
-                        (uint32_t)sample_interval_ms / portTICK_RATE_MS,
-                        pdTRUE,
-                        (void *) 0,
-                        vTimerCallback
-                    );
-    xTimerStart(fusion_timer, 0);
+    uint32_t period_us = (uint32_t)(sample_interval_ms * 1000.0f + 0.5f);
+
+    ei_fusion_acquisition_reset_stats();
+
+    if (ei_sample_timer_start(sample_read_cb, period_us) == false) {
+        ei_printf("ERR: failed to start sample timer\n");
+        return false;
+    }
 
     return true;
 }
@@ -311,10 +329,8 @@ bool EiDeviceESP32::start_sample_thread(void (*sample_read_cb)(void), float samp
 bool EiDeviceESP32::stop_sample_thread(void)
 {
 
-    if (xTimerStop(fusion_timer, 0) != pdPASS)
-    {
-        ei_printf("ERR: timer has not been stopped \n");
-    }
+    ei_sample_timer_stop();
+    ei_fusion_acquisition_detach();
 
     return true;
 }
@@ -392,10 +408,3 @@ char ei_getchar()
     return ch;
 
 }
-
-/* Private functions ------------------------------------------------------- */
-
-void vTimerCallback(TimerHandle_t xTimer)
-{
-    sample_cb_ptr();
-}
\ No newline at end of file
@@ -95,9 +95,11 @@ public:
 
     void delay_ms(uint32_t milliseconds);
 
+    bool init_network(void);
     bool scan_networks(void);
     bool get_wifi_connection_status(void);
     bool get_wifi_present_status();
+    void set_wifi_config(std::string ssid, std::string password, EiWiFiSecurity security, bool save = true) override;
 
     std::string get_mac_address(void);
 
@@ -0,0 +1,465 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_fusion_acquisition_esp32.h"
+#include "ei_sample_timer_esp32.h"
+
+#include <string.h>
+
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "ei_fusion.h"
+
+/* Constants --------------------------------------------------------------- */
+/** Same priority as the sample task, bus tasks run while it waits for them */
+#define BUS_TASK_PRIO           (configMAX_PRIORITIES - 2)
+#define BUS_TASK_STACK          4096
+/** Sensors without a shared bus get a task each, so one per fusable sensor at most */
+#define MAX_BUS_TASKS           (EI_FUSION_BUS_I2S + NUM_MAX_FUSIONS)
+#define MAX_ACQ_SENSORS         (NUM_FUSION_SENSORS)
+/** Samples kept per sensor to pick the one read closest to a frame */
+#define ACQ_HISTORY             4
+
+static const char *TAG = "FusionAcq";
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    /** Middle of the read, when the sensor took the sample */
+    int64_t timestamp_us;
+    bool valid;
+    fusion_sample_format_t data[EI_MAX_SENSOR_AXES];
+} acq_sample_t;
+
+typedef struct {
+    const ei_device_fusion_sensor_t *sensor;
+    /** Sequence counter, odd while the bus task updates the history */
+    uint32_t seq;
+    /** Samples published by the bus task, the newest is history[(head - 1) % ACQ_HISTORY] */
+    acq_sample_t history[ACQ_HISTORY];
+    uint32_t head;
+    /** Copy handed to the fusion layer */
+    fusion_sample_format_t result[EI_MAX_SENSOR_AXES];
+    /* read statistics, only written by the bus task, zero unless bus_epoch == stats_epoch */
+    uint32_t bus_epoch;
+    uint32_t reads;
+    uint64_t sum_us;
+    uint32_t max_us;
+    /* frames that got no sample close to their time, only written by the
+       sampling task, zero unless late_epoch == stats_epoch */
+    uint32_t late_epoch;
+    uint32_t late;
+} acq_sensor_t;
+
+typedef struct {
+    int key;
+    TaskHandle_t task;
+    /** Set while the task works on a job, a busy bus is not handed a new one */
+    volatile bool busy;
+    acq_sensor_t *job[MAX_ACQ_SENSORS];
+    int job_count;
+} acq_bus_t;
+
+/* Private variables ------------------------------------------------------- */
+static acq_sensor_t sensors[MAX_ACQ_SENSORS];
+static int sensor_count = 0;
+static acq_bus_t buses[MAX_BUS_TASKS];
+static int bus_count = 0;
+static EventGroupHandle_t done_group = NULL;
+/** Bumped to reset the statistics, each counter is cleared by its own task */
+static uint32_t stats_epoch = 1;
+/* sampling task state */
+static int64_t last_tick_us = 0;
+static int64_t session_start_us = 0;
+
+/* Private functions ------------------------------------------------------- */
+
+static void bus_thread(void *arg)
+{
+    acq_bus_t *bus = (acq_bus_t *)arg;
+    const EventBits_t done_bit = 1 << (bus - buses);
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        for (int i = 0; i < bus->job_count; i++) {
+            acq_sensor_t *s = bus->job[i];
+            int64_t start = esp_timer_get_time();
+            fusion_sample_format_t *data = NULL;
+
+            if (s->sensor->read_data != NULL) {
+                data = s->sensor->read_data(s->sensor->num_axis);
+            }
+            uint32_t read_us = (uint32_t)(esp_timer_get_time() - start);
+
+            acq_sample_t *sample = &s->history[s->head % ACQ_HISTORY];
+
+            __atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELEASE);
+            if (data != NULL) {
+                memcpy(sample->data, data, s->sensor->num_axis * sizeof(fusion_sample_format_t));
+            }
+            sample->valid = (data != NULL);
+            sample->timestamp_us = start + read_us / 2;
+            s->head++;
+            __atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELEASE);
+
+            uint32_t epoch = __atomic_load_n(&stats_epoch, __ATOMIC_RELAXED);
+            if (s->bus_epoch != epoch) {
+                s->reads = 0;
+                s->sum_us = 0;
+                s->max_us = 0;
+                s->bus_epoch = epoch;
+            }
+            s->reads++;
+            s->sum_us += read_us;
+            if (read_us > s->max_us) {
+                s->max_us = read_us;
+            }
+        }
+
+        bus->busy = false;
+        xEventGroupSetBits(done_group, done_bit);
+    }
+}
+
+static acq_sensor_t *get_sensor(const ei_device_fusion_sensor_t *sensor)
+{
+    for (int i = 0; i < sensor_count; i++) {
+        if (sensors[i].sensor == sensor) {
+            return &sensors[i];
+        }
+    }
+
+    if (sensor_count == MAX_ACQ_SENSORS) {
+        return NULL;
+    }
+
+    acq_sensor_t *s = &sensors[sensor_count++];
+    *s = acq_sensor_t();
+    s->sensor = sensor;
+    return s;
+}
+
+/**
+ * @brief Task key of a sensor, sensors that share no bus get one of their own
+ */
+static int bus_key(const acq_sensor_t *s)
+{
+    return (s->sensor->bus != EI_FUSION_BUS_NONE) ? s->sensor->bus : EI_FUSION_BUS_I2S + 1 + (int)(s - sensors);
+}
+
+static acq_bus_t *get_bus(const acq_sensor_t *s)
+{
+    int key = bus_key(s);
+
+    for (int i = 0; i < bus_count; i++) {
+        if (buses[i].key == key) {
+            return &buses[i];
+        }
+    }
+
+    if (bus_count == MAX_BUS_TASKS) {
+        return NULL;
+    }
+
+    acq_bus_t *bus = &buses[bus_count];
+    *bus = acq_bus_t();
+    bus->key = key;
+
+    if (xTaskCreate(bus_thread, "ei_bus", BUS_TASK_STACK, bus, BUS_TASK_PRIO, &bus->task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create bus task");
+        return NULL;
+    }
+    bus_count++;
+
+    return bus;
+}
+
+/**
+ * @brief Copy the sample of this session read closest to frame_us, retried
+ * if the bus task publishes a new one meanwhile
+ *
+ * @return false if the session has no valid sample yet
+ */
+static bool copy_sample(acq_sensor_t *s, int64_t frame_us, int64_t *timestamp_us)
+{
+    uint32_t seq;
+    bool valid;
+
+    do {
+        seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            continue;
+        }
+
+        const acq_sample_t *best = NULL;
+        int64_t best_distance = 0;
+        uint32_t n = (s->head < ACQ_HISTORY) ? s->head : ACQ_HISTORY;
+
+        for (uint32_t i = 0; i < n; i++) {
+            const acq_sample_t *sample = &s->history[(s->head - 1 - i) % ACQ_HISTORY];
+            if (sample->valid == false || sample->timestamp_us < session_start_us) {
+                continue;
+            }
+            int64_t distance = sample->timestamp_us - frame_us;
+            if (distance < 0) {
+                distance = -distance;
+            }
+            if (best == NULL || distance < best_distance) {
+                best = sample;
+                best_distance = distance;
+            }
+        }
+
+        valid = (best != NULL);
+        if (valid) {
+            memcpy(s->result, best->data, s->sensor->num_axis * sizeof(fusion_sample_format_t));
+            *timestamp_us = best->timestamp_us;
+        }
+    } while ((seq & 1) || __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) != seq);
+
+    return valid;
+}
+
+static void count_late(acq_sensor_t *s)
+{
+    uint32_t epoch = __atomic_load_n(&stats_epoch, __ATOMIC_RELAXED);
+
+    if (s->late_epoch != epoch) {
+        s->late = 0;
+        s->late_epoch = epoch;
+    }
+    s->late++;
+}
+
+/**
+ * @brief Hand the sensors to their bus tasks, a bus still busy with earlier
+ * reads is skipped. Sensors that can't get a task are read right here.
+ *
+ * @return event bits of the buses that were started
+ */
+static EventBits_t start_reads(
+    ei_device_fusion_sensor_t **fusion_sensors,
+    fusion_sample_format_t **results,
+    acq_sensor_t **slots,
+    int count)
+{
+    EventBits_t started = 0;
+
+    for (int i = 0; i < bus_count; i++) {
+        if (buses[i].busy == false) {
+            buses[i].job_count = 0;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        acq_sensor_t *s = get_sensor(fusion_sensors[i]);
+        acq_bus_t *bus = (s != NULL) ? get_bus(s) : NULL;
+
+        slots[i] = s;
+        if (s == NULL || bus == NULL) {
+            // no room for a task, read it from here
+            slots[i] = NULL;
+            if (results != NULL && fusion_sensors[i]->read_data != NULL) {
+                results[i] = fusion_sensors[i]->read_data(fusion_sensors[i]->num_axis);
+            }
+            continue;
+        }
+
+        if (bus->busy == false) {
+            bus->job[bus->job_count++] = s;
+        }
+    }
+
+    for (int i = 0; i < bus_count; i++) {
+        if (buses[i].busy == false && buses[i].job_count > 0) {
+            EventBits_t bit = 1 << i;
+            xEventGroupClearBits(done_group, bit);
+            buses[i].busy = true;
+            started |= bit;
+            xTaskNotifyGive(buses[i].task);
+        }
+    }
+
+    return started;
+}
+
+/**
+ * @brief ei_fusion sensor reader. Every tick starts the reads on all idle
+ * buses and waits up to 3/4 of the interval for them, then assembles the
+ * frame from the sample of each sensor taken closest to the tick. A bus that
+ * is slower than that is not waited for, its sensors keep their nearest
+ * sample and are counted as late if it is more than half an interval away.
+ */
+static void read_sensors(ei_device_fusion_sensor_t **fusion_sensors, fusion_sample_format_t **results, int count)
+{
+    acq_sensor_t *slots[NUM_MAX_FUSIONS] = {};
+    const uint32_t interval_us = ei_sample_timer_get_stats()->nominal_us;
+    int64_t now = esp_timer_get_time();
+
+    for (int i = 0; i < count; i++) {
+        results[i] = NULL;
+    }
+
+    if (last_tick_us == 0 || now - last_tick_us > 4 * (int64_t)interval_us) {
+        session_start_us = now;
+    }
+    last_tick_us = now;
+
+    EventBits_t wait_bits = start_reads(fusion_sensors, results, slots, count);
+    if (wait_bits != 0) {
+        TickType_t timeout = pdMS_TO_TICKS(((interval_us * 3) / 4) / 1000);
+        xEventGroupWaitBits(done_group, wait_bits, pdTRUE, pdTRUE, timeout > 0 ? timeout : 1);
+    }
+
+    for (int i = 0; i < count; i++) {
+        acq_sensor_t *s = slots[i];
+        int64_t timestamp_us = 0;
+
+        if (s == NULL) {
+            continue;
+        }
+
+        bool valid = copy_sample(s, now, &timestamp_us);
+        if (valid) {
+            results[i] = s->result;
+        }
+
+        int64_t distance = timestamp_us - now;
+        if (valid == false || distance > (int64_t)interval_us / 2 || -distance > (int64_t)interval_us / 2) {
+            count_late(s);
+        }
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+
+/**
+ * @brief Set up reading fusion sensors from one task per bus, so sensors on
+ * different buses are sampled in parallel instead of one after the other.
+ * The bus tasks are only used once ei_fusion_acquisition_attach() is called.
+ */
+bool ei_fusion_acquisition_init(void)
+{
+    if (done_group == NULL) {
+        done_group = xEventGroupCreate();
+        if (done_group == NULL) {
+            ESP_LOGE(TAG, "Failed to create event group");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Read the sensors of the next fusion sampling session from the bus
+ * tasks, until ei_fusion_acquisition_detach()
+ *
+ * @return false if ei_fusion_acquisition_init() did not succeed
+ */
+bool ei_fusion_acquisition_attach(void)
+{
+    if (done_group == NULL) {
+        return false;
+    }
+
+    last_tick_us = 0;
+    ei_fusion_set_sensor_reader(read_sensors);
+
+    return true;
+}
+
+/**
+ * @brief Go back to reading the sensors one after the other from the sample task
+ */
+void ei_fusion_acquisition_detach(void)
+{
+    ei_fusion_set_sensor_reader(nullptr);
+}
+
+/**
+ * @brief Clear the statistics. The counters belong to the bus and sampling
+ * tasks, they clear them on their next update once they see the new epoch.
+ */
+void ei_fusion_acquisition_reset_stats(void)
+{
+    __atomic_add_fetch(&stats_epoch, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Print read times per sensor and the fused rate they allow. Buses run
+ * in parallel, so the slowest bus sets the limit instead of the sum of all reads.
+ */
+void ei_fusion_acquisition_print_stats(void)
+{
+    uint32_t slowest_bus_us = 0;
+    uint32_t all_us = 0;
+
+    for (int b = 0; b < bus_count; b++) {
+        uint32_t bus_us = 0;
+
+        for (int i = 0; i < sensor_count; i++) {
+            const acq_sensor_t *s = &sensors[i];
+            uint32_t epoch = __atomic_load_n(&stats_epoch, __ATOMIC_RELAXED);
+
+            if (bus_key(s) != buses[b].key || s->bus_epoch != epoch || s->reads == 0) {
+                continue;
+            }
+
+            uint32_t late = (s->late_epoch == epoch) ? s->late : 0;
+            uint32_t mean_us = (uint32_t)(s->sum_us / s->reads);
+            ei_printf("%s: %lu reads, mean %lu us, max %lu us, late %lu\n",
+                s->sensor->name, s->reads, mean_us, s->max_us, late);
+            bus_us += mean_us;
+        }
+
+        if (bus_us > slowest_bus_us) {
+            slowest_bus_us = bus_us;
+        }
+        all_us += bus_us;
+    }
+
+    if (slowest_bus_us > 0) {
+        ei_printf("Max fused rate: %.1f Hz (sequential reads: %.1f Hz)\n",
+            1000000.0f / slowest_bus_us, 1000000.0f / all_us);
+    }
+}
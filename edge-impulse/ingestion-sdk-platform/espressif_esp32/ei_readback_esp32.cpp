@@ -0,0 +1,212 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_readback_esp32.h"
+#include "firmware-sdk/ei_device_info_lib.h"
+#include "at_base64_lib.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "driver/uart.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+/* Constants --------------------------------------------------------------- */
+#define READBACK_UART           UART_NUM_0
+/** Three flash sectors, a multiple of 3 so base64 needs no carry between reads */
+#define READBACK_CHUNK_SIZE     (3 * 4096)
+#define READBACK_BASE64_SIZE    (READBACK_CHUNK_SIZE / 3 * 4)
+/** UART TX ring, drained by the driver while the next chunk is read and encoded */
+#define READBACK_TX_RING_SIZE   8192
+#define READBACK_HEX_LINE       16
+
+static const char *TAG = "Readback";
+
+/* Private variables ------------------------------------------------------- */
+static ei_readback_stats_t last_stats = { 0 };
+
+/* Private functions ------------------------------------------------------- */
+
+/**
+ * @brief Install the UART driver on the console for the duration of the
+ * transfer, uart_write_bytes then only copies into the TX ring.
+ * Console stdio is not using the driver, so it is released again afterwards.
+ */
+static bool readback_begin(void)
+{
+    fflush(stdout);
+    uart_wait_tx_idle_polling(READBACK_UART);
+
+    if (uart_driver_install(READBACK_UART, 256, READBACK_TX_RING_SIZE, 0, NULL, 0) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to install UART driver");
+        return false;
+    }
+
+    uart_get_baudrate(READBACK_UART, &last_stats.baudrate);
+    last_stats.bytes = 0;
+    last_stats.time_us = 0;
+
+    return true;
+}
+
+static void readback_end(uint64_t start_time)
+{
+    uart_wait_tx_done(READBACK_UART, portMAX_DELAY);
+    uart_driver_delete(READBACK_UART);
+
+    last_stats.time_us = (uint32_t)(esp_timer_get_time() - start_time);
+
+    ESP_LOGD(TAG, "%lu bytes in %lu us at %lu baud",
+        last_stats.bytes, last_stats.time_us, last_stats.baudrate);
+}
+
+/* Public functions -------------------------------------------------------- */
+
+/**
+ * @brief Send sample memory base64 encoded, replaces the byte by byte
+ * implementation of the firmware-sdk. Data is read in whole sector multiples,
+ * encoded in one go and queued to the UART, so reading the next chunk overlaps
+ * with transmitting the previous one.
+ *
+ * @param address address of samples
+ * @param length number of samples (bytes)
+ * @return false if reading from memory failed
+ */
+bool read_encode_send_sample_buffer(size_t address, size_t length)
+{
+    EiDeviceMemory *memory = EiDeviceInfo::get_device()->get_memory();
+    uint8_t *buffer = (uint8_t *)ei_malloc(READBACK_CHUNK_SIZE);
+    char *encoded = (char *)ei_malloc(READBACK_BASE64_SIZE);
+    bool ret = true;
+
+    if (buffer == NULL || encoded == NULL || readback_begin() == false) {
+        ei_free(buffer);
+        ei_free(encoded);
+        return false;
+    }
+
+    uint64_t start_time = esp_timer_get_time();
+
+    while (length > 0) {
+        size_t bytes_to_read = length < READBACK_CHUNK_SIZE ? length : READBACK_CHUNK_SIZE;
+
+        if (memory->read_sample_data(buffer, address, bytes_to_read) != bytes_to_read) {
+            ret = false;
+            break;
+        }
+
+        int n_encoded = base64_encode_buffer((const char *)buffer, bytes_to_read, encoded, READBACK_BASE64_SIZE);
+        if (n_encoded < 0) {
+            ret = false;
+            break;
+        }
+
+        uart_write_bytes(READBACK_UART, encoded, n_encoded);
+
+        last_stats.bytes += bytes_to_read;
+        address += bytes_to_read;
+        length -= bytes_to_read;
+    }
+
+    readback_end(start_time);
+
+    ei_free(buffer);
+    ei_free(encoded);
+
+    return ret;
+}
+
+/**
+ * @brief Hex dump of sample memory in the AT+READRAW format, 16 bytes per line
+ *
+ * @param address first byte to print
+ * @param end address to stop at
+ */
+bool ei_readback_hex(size_t address, size_t end)
+{
+    static const char hex_chars[] = "0123456789ABCDEF";
+    EiDeviceMemory *memory = EiDeviceInfo::get_device()->get_memory();
+    uint8_t *buffer = (uint8_t *)ei_malloc(READBACK_CHUNK_SIZE);
+    // "XX " or "XX\n" per byte
+    char *line = (char *)ei_malloc(READBACK_CHUNK_SIZE * 3);
+
+    if (buffer == NULL || line == NULL || readback_begin() == false) {
+        ei_free(buffer);
+        ei_free(line);
+        return false;
+    }
+
+    uint64_t start_time = esp_timer_get_time();
+
+    while (address < end) {
+        // whole lines only, the last line is filled with whatever memory holds
+        size_t bytes_to_read = end - address;
+        bytes_to_read = ((bytes_to_read + READBACK_HEX_LINE - 1) / READBACK_HEX_LINE) * READBACK_HEX_LINE;
+        if (bytes_to_read > READBACK_CHUNK_SIZE) {
+            bytes_to_read = READBACK_CHUNK_SIZE;
+        }
+
+        memset(buffer, 0, bytes_to_read);
+        memory->read_sample_data(buffer, address, bytes_to_read);
+
+        size_t pos = 0;
+        for (size_t i = 0; i < bytes_to_read; i++) {
+            line[pos++] = hex_chars[buffer[i] >> 4];
+            line[pos++] = hex_chars[buffer[i] & 0x0F];
+            line[pos++] = (i % READBACK_HEX_LINE == READBACK_HEX_LINE - 1) ? '\n' : ' ';
+        }
+
+        uart_write_bytes(READBACK_UART, line, pos);
+
+        last_stats.bytes += bytes_to_read;
+        address += bytes_to_read;
+    }
+
+    uart_write_bytes(READBACK_UART, "\n", 1);
+
+    readback_end(start_time);
+
+    ei_free(buffer);
+    ei_free(line);
+
+    return true;
+}
+
+const ei_readback_stats_t *ei_readback_get_stats(void)
+{
+    return &last_stats;
+}
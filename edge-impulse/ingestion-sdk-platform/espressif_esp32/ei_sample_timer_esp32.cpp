@@ -0,0 +1,169 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_sample_timer_esp32.h"
+
+#include <string.h>
+
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* Constants --------------------------------------------------------------- */
+/** Above the esp_timer task, so a sample is taken as soon as the timer fires */
+#define SAMPLE_TASK_PRIO        (configMAX_PRIORITIES - 2)
+#define SAMPLE_TASK_STACK       4096
+
+static const char *TAG = "SampleTimer";
+
+/* Private variables ------------------------------------------------------- */
+static esp_timer_handle_t sample_timer = NULL;
+static TaskHandle_t sample_task = NULL;
+static void (*volatile sample_cb_ptr)(void) = NULL;
+static ei_sample_timer_stats_t stats;
+static int64_t last_sample_us = 0;
+
+/* Private functions ------------------------------------------------------- */
+
+/**
+ * @brief esp_timer callback, periodic timers are rescheduled from the previous
+ * deadline so the sampling rate does not drift
+ */
+static void sample_timer_callback(void *arg)
+{
+    xTaskNotifyGive(sample_task);
+}
+
+static void update_stats(int64_t now)
+{
+    if (last_sample_us != 0) {
+        uint32_t interval = (uint32_t)(now - last_sample_us);
+        int64_t dev = (int64_t)interval - stats.nominal_us;
+
+        if (interval < stats.min_us) {
+            stats.min_us = interval;
+        }
+        if (interval > stats.max_us) {
+            stats.max_us = interval;
+        }
+        stats.sum_us += interval;
+        stats.sum_sq_dev += (uint64_t)(dev * dev);
+    }
+
+    stats.samples++;
+    last_sample_us = now;
+}
+
+static void sample_thread(void *arg)
+{
+    while (1) {
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        void (*cb)(void) = sample_cb_ptr;
+
+        if (cb == NULL) {
+            continue;
+        }
+
+        if (ticks > 1) {
+            stats.missed += ticks - 1;
+        }
+
+        update_stats(esp_timer_get_time());
+        cb();
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+
+/**
+ * @brief Call sample_cb every period_us from a high priority task
+ *
+ * @return false if the timer or task could not be created
+ */
+bool ei_sample_timer_start(void (*sample_cb)(void), uint32_t period_us)
+{
+    if (sample_task == NULL
+        && xTaskCreate(sample_thread, "ei_sampler", SAMPLE_TASK_STACK, NULL, SAMPLE_TASK_PRIO, &sample_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create sample task");
+        return false;
+    }
+
+    if (sample_timer == NULL) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = &sample_timer_callback,
+            .arg = NULL,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "ei_sample",
+            .skip_unhandled_events = false,
+        };
+
+        if (esp_timer_create(&timer_args, &sample_timer) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create sample timer");
+            return false;
+        }
+    }
+
+    ei_sample_timer_stop();
+    // a tick of the previous run that fired while stopping would count as missed
+    ulTaskNotifyValueClear(sample_task, UINT32_MAX);
+
+    memset(&stats, 0, sizeof(stats));
+    stats.nominal_us = period_us;
+    stats.min_us = UINT32_MAX;
+    last_sample_us = 0;
+    sample_cb_ptr = sample_cb;
+
+    return esp_timer_start_periodic(sample_timer, period_us) == ESP_OK;
+}
+
+/**
+ * @brief Stop sampling, may be called from the sample callback
+ */
+void ei_sample_timer_stop(void)
+{
+    sample_cb_ptr = NULL;
+
+    if (sample_timer != NULL) {
+        esp_timer_stop(sample_timer);
+    }
+}
+
+const ei_sample_timer_stats_t *ei_sample_timer_get_stats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,257 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_uploader_esp32.h"
+#include "ei_wifi_esp32.h"
+#include "ei_device_espressif_esp32.h"
+#include "flash_memory.h"
+
+#include <string>
+
+#include "esp_http_client.h"
+#include "esp_crt_bundle.h"
+#include "esp_log.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* Constants --------------------------------------------------------------- */
+#define UPLOADER_TASK_STACK      8192
+#define UPLOADER_TASK_PRIO       (tskIDLE_PRIORITY + 1)
+/** Bytes read from flash and sent per chunk of the HTTP body */
+#define UPLOADER_CHUNK_SIZE      1024
+#define UPLOADER_TIMEOUT_MS      10000
+/** Queue is checked at least this often, even without a notification */
+#define UPLOADER_POLL_MS         30000
+#define UPLOADER_BACKOFF_MIN_MS  2000
+#define UPLOADER_BACKOFF_MAX_MS  120000
+
+static const char *TAG = "Uploader";
+
+/* Private variables ------------------------------------------------------- */
+static TaskHandle_t uploader_task = NULL;
+
+/* Private functions ------------------------------------------------------- */
+
+static std::string upload_url(EiDeviceInfo *dev)
+{
+    std::string host = dev->get_upload_host().c_str();
+    std::string path = dev->get_upload_path().c_str();
+
+    if (host.find("://") == std::string::npos) {
+        host = "https://" + host;
+    }
+    if (path.size() > 0 && path[0] != '/') {
+        path = "/" + path;
+    }
+
+    return host + path;
+}
+
+/**
+ * @brief Stream one record from the storage partition as the request body
+ *
+ * @return true when the ingestion service accepted the sample
+ */
+static bool upload_record(EiFlashMemory *mem, const ei_sample_record_t &record, uint8_t *chunk)
+{
+    EiDeviceInfo *dev = EiDeviceInfo::get_device();
+    std::string url = upload_url(dev);
+    std::string file_name = std::string(record.label[0] ? record.label : "sample") + "." + std::to_string(record.sequence) + ".cbor";
+    bool ok = false;
+
+    esp_http_client_config_t config = {};
+    config.url = url.c_str();
+    config.method = HTTP_METHOD_POST;
+    config.timeout_ms = UPLOADER_TIMEOUT_MS;
+    config.crt_bundle_attach = esp_crt_bundle_attach;
+
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    if (client == NULL) {
+        return false;
+    }
+
+    esp_http_client_set_header(client, "x-api-key", dev->get_upload_api_key().c_str());
+    esp_http_client_set_header(client, "x-file-name", file_name.c_str());
+    if (record.label[0]) {
+        esp_http_client_set_header(client, "x-label", record.label);
+    }
+    esp_http_client_set_header(client, "Content-Type", "application/cbor");
+
+    if (esp_http_client_open(client, record.length) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to connect to %s", url.c_str());
+        esp_http_client_cleanup(client);
+        return false;
+    }
+
+    uint32_t pos = 0;
+    while (pos < record.length) {
+        uint32_t n = record.length - pos < UPLOADER_CHUNK_SIZE ? record.length - pos : UPLOADER_CHUNK_SIZE;
+
+        // zero once the record was evicted by a new recording
+        if (mem->read_record_data(record.sequence, chunk, pos, n) != n) {
+            ESP_LOGW(TAG, "Record %u no longer available", (unsigned)record.sequence);
+            break;
+        }
+        if (esp_http_client_write(client, (const char *)chunk, n) != (int)n) {
+            break;
+        }
+        pos += n;
+    }
+
+    if (pos == record.length && esp_http_client_fetch_headers(client) >= 0) {
+        int status = esp_http_client_get_status_code(client);
+        ok = (status == 200);
+        if (!ok) {
+            ESP_LOGW(TAG, "Upload of record %u failed, status %d", (unsigned)record.sequence, status);
+        }
+    }
+
+    esp_http_client_close(client);
+    esp_http_client_cleanup(client);
+
+    return ok;
+}
+
+/**
+ * @brief Upload completed records oldest first while sampling carries on.
+ * Failed uploads are retried with an exponential backoff.
+ */
+static void uploader_thread(void *arg)
+{
+    EiFlashMemory *mem = static_cast<EiFlashMemory *>(EiDeviceInfo::get_device()->get_memory());
+    uint8_t *chunk = (uint8_t *)ei_malloc(UPLOADER_CHUNK_SIZE);
+    uint32_t backoff_ms = UPLOADER_BACKOFF_MIN_MS;
+
+    if (chunk == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate upload buffer");
+        vTaskDelete(NULL);
+        return;
+    }
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(UPLOADER_POLL_MS));
+
+        while (ei_wifi_wait_connected(UPLOADER_POLL_MS)) {
+            bool uploaded_any = false;
+            bool failed = false;
+
+            for (auto &record : mem->get_records()) {
+                if ((record.flags & EI_SAMPLE_LOG_FLAG_UPLOADED) == 0) {
+                    continue;
+                }
+
+                ESP_LOGI(TAG, "Uploading record %u (%u bytes)", (unsigned)record.sequence, (unsigned)record.length);
+                if (upload_record(mem, record, chunk)) {
+                    mem->mark_record_uploaded(record.sequence);
+                    uploaded_any = true;
+                }
+                else {
+                    failed = true;
+                    break;
+                }
+            }
+
+            if (failed) {
+                vTaskDelay(pdMS_TO_TICKS(backoff_ms));
+                backoff_ms = backoff_ms * 2 > UPLOADER_BACKOFF_MAX_MS ? UPLOADER_BACKOFF_MAX_MS : backoff_ms * 2;
+                continue;
+            }
+
+            backoff_ms = UPLOADER_BACKOFF_MIN_MS;
+            // records may have been closed while uploading
+            if (!uploaded_any) {
+                break;
+            }
+        }
+    }
+}
+
+/* Public functions -------------------------------------------------------- */
+
+/**
+ * @brief Start the background uploader, records in the sample log that are
+ * not marked as uploaded are sent whenever WiFi is connected
+ */
+bool ei_uploader_init(void)
+{
+    if (uploader_task != NULL) {
+        return true;
+    }
+
+    return xTaskCreate(uploader_thread, "ei_uploader", UPLOADER_TASK_STACK, NULL, UPLOADER_TASK_PRIO, &uploader_task) == pdPASS;
+}
+
+/**
+ * @brief Hand the record closed last to the uploader. Without a WiFi network
+ * configured the sample is read back over serial instead, so the record is
+ * marked as uploaded and false is returned.
+ */
+bool ei_uploader_enqueue_last(void)
+{
+    EiFlashMemory *mem = static_cast<EiFlashMemory *>(EiDeviceInfo::get_device()->get_memory());
+    std::vector<ei_sample_record_t> records = mem->get_records();
+
+    if (records.size() == 0) {
+        return false;
+    }
+
+    if (uploader_task == NULL || ei_wifi_is_configured() == false) {
+        mem->mark_record_uploaded(records.back().sequence);
+        return false;
+    }
+
+    xTaskNotifyGive(uploader_task);
+
+    return true;
+}
+
+/**
+ * @brief Number of records waiting for upload
+ */
+uint32_t ei_uploader_pending(void)
+{
+    EiFlashMemory *mem = static_cast<EiFlashMemory *>(EiDeviceInfo::get_device()->get_memory());
+    uint32_t pending = 0;
+
+    for (auto &record : mem->get_records()) {
+        if (record.flags & EI_SAMPLE_LOG_FLAG_UPLOADED) {
+            pending++;
+        }
+    }
+
+    return pending;
+}
@@ -32,92 +32,175 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-/*
-#include "firmware-sdk/ei_device_interface.h"
 
+/* Include ----------------------------------------------------------------- */
 #include "ei_wifi_esp32.h"
 
-#include <errno.h>
-#include <fcntl.h>
-#include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 
 #include "esp_wifi.h"
+#include "esp_event.h"
+#include "esp_netif.h"
 #include "esp_log.h"
+#include "nvs_flash.h"
 
-#define DEFAULT_SCAN_LIST_SIZE 10
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+/* Constants --------------------------------------------------------------- */
+#define WIFI_CONNECTED_BIT  BIT0
 
 static const char *TAG = "NetworkDriver";
 
-EiWifiESP32::EiWifiESP32()
-{
+/* Private variables ------------------------------------------------------- */
+static EventGroupHandle_t wifi_event_group = NULL;
+static bool wifi_configured = false;
+
+/* Private functions ------------------------------------------------------- */
 
+/**
+ * @brief Keep the station connected, the driver is asked to reconnect on every disconnect
+ */
+static void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
+{
+    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
+        xEventGroupClearBits(wifi_event_group, WIFI_CONNECTED_BIT);
+        if (wifi_configured) {
+            esp_wifi_connect();
+        }
+    }
+    else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
+        ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
+        ESP_LOGI(TAG, "Got IP " IPSTR, IP2STR(&event->ip_info.ip));
+        xEventGroupSetBits(wifi_event_group, WIFI_CONNECTED_BIT);
+    }
 }
 
-int8_t EiWifiESP32::init() {
+/* Public functions -------------------------------------------------------- */
 
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    esp_err_t ret = esp_wifi_init(&cfg);
+/**
+ * @brief Bring up the WiFi driver in station mode
+ *
+ * @return true if the driver is available
+ */
+bool ei_wifi_init(void)
+{
+    esp_err_t ret = nvs_flash_init();
 
-    return ret;
-}
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        ret = nvs_flash_init();
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "NVS init failed (%d)", ret);
+        return false;
+    }
 
-int8_t EiWifiESP32::deinit() {
+    wifi_event_group = xEventGroupCreate();
 
-    esp_err_t ret = esp_wifi_deinit();
+    if (esp_netif_init() != ESP_OK) {
+        return false;
+    }
+    ret = esp_event_loop_create_default();
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        return false;
+    }
+    esp_netif_create_default_wifi_sta();
 
-    return ret;
-}
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    if (esp_wifi_init(&cfg) != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi init failed");
+        return false;
+    }
 
-int8_t EiWifiESP32::scan_networks(ei_device_network_list_t **networks, uint16_t *network_num) {
+    esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL, NULL);
+    esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &wifi_event_handler, NULL, NULL);
 
-    uint16_t number = DEFAULT_SCAN_LIST_SIZE;
-    wifi_ap_record_t ap_info[DEFAULT_SCAN_LIST_SIZE];
+    esp_wifi_set_storage(WIFI_STORAGE_RAM);
+    esp_wifi_set_mode(WIFI_MODE_STA);
 
-    esp_err_t ret = esp_wifi_set_mode(WIFI_MODE_STA);
+    return esp_wifi_start() == ESP_OK;
+}
 
-    ret = esp_wifi_start();
-    ret = esp_wifi_scan_start(NULL, true);
+/**
+ * @brief Connect to the access point, the connection is restored in the
+ * background whenever it drops
+ */
+bool ei_wifi_connect(const char *ssid, const char *password, ei_config_security_t security)
+{
+    wifi_config_t wifi_config;
 
-    ret = esp_wifi_scan_get_ap_records(&number, ap_info);
-    ret = esp_wifi_scan_get_ap_num(network_num);
-    ESP_LOGI(TAG, "Total APs scanned = %u", *network_num);
+    if (wifi_event_group == NULL || ssid == NULL || ssid[0] == 0) {
+        return false;
+    }
 
-    for (int i = 0; (i < DEFAULT_SCAN_LIST_SIZE) && (i < *network_num); i++) {
-        ESP_LOGI(TAG, "SSID \t\t%s", ap_info[i].ssid);
-        networks[i]->wifi_ssid = ap_info[i].ssid;
-        ESP_LOGI(TAG, "RSSI \t\t%d", ap_info[i].rssi);
-        networks[i]->signal_strength = ap_info[i].rssi;
+    memset(&wifi_config, 0, sizeof(wifi_config));
+    strncpy((char *)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid) - 1);
+    strncpy((char *)wifi_config.sta.password, password, sizeof(wifi_config.sta.password) - 1);
+
+    switch (security) {
+    case EI_SECURITY_NONE:
+        wifi_config.sta.threshold.authmode = WIFI_AUTH_OPEN;
+        break;
+    case EI_SECURITY_WEP:
+        wifi_config.sta.threshold.authmode = WIFI_AUTH_WEP;
+        break;
+    case EI_SECURITY_WPA:
+    case EI_SECURITY_WPA_WPA2:
+        wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA_PSK;
+        break;
+    default:
+        wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
+        break;
+    }
 
-        ESP_LOGI(TAG, "Auth mode \t\t%d", ap_info[i].authmode);
-        //networks[i]->wifi_security = ap_info[i].authmode;
+    wifi_configured = false;
+    esp_wifi_disconnect();
+    xEventGroupClearBits(wifi_event_group, WIFI_CONNECTED_BIT);
 
-        ESP_LOGI(TAG, "Channel \t\t%d\n", ap_info[i].primary);
+    if (esp_wifi_set_config(WIFI_IF_STA, &wifi_config) != ESP_OK) {
+        return false;
     }
 
-    return ret;
-}
-
-int8_t EiWifiESP32::connect_network(ei_config_t *config) {
+    wifi_configured = true;
 
-    return EI_CONFIG_OK;
+    return esp_wifi_connect() == ESP_OK;
 }
 
-int8_t EiWifiESP32::disconnect_network(void) {
-
-    return EI_CONFIG_OK;
+/**
+ * @brief An access point was set, the station may still be connecting
+ */
+bool ei_wifi_is_configured(void)
+{
+    return wifi_configured;
 }
 
-int8_t EiWifiESP32::send_sample(ei_config_t *config) {
+bool ei_wifi_is_connected(void)
+{
+    if (wifi_event_group == NULL) {
+        return false;
+    }
 
-    return EI_CONFIG_OK;
+    return (xEventGroupGetBits(wifi_event_group) & WIFI_CONNECTED_BIT) != 0;
 }
 
-
-EiNetworkDevice *EiNetworkDevice::get_network_device()
+/**
+ * @brief Block until the station has an IP address
+ *
+ * @return false on timeout
+ */
+bool ei_wifi_wait_connected(uint32_t timeout_ms)
 {
-    static EiWifiESP32 net;
-    return &net;
+    if (wifi_event_group == NULL) {
+        return false;
+    }
+
+    EventBits_t bits = xEventGroupWaitBits(
+        wifi_event_group,
+        WIFI_CONNECTED_BIT,
+        pdFALSE,
+        pdTRUE,
+        timeout_ms == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms));
+
+    return (bits & WIFI_CONNECTED_BIT) != 0;
 }
-*/
\ No newline at end of file
@@ -32,33 +32,20 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+
 #ifndef EI_WIFI_ESP32
 #define EI_WIFI_ESP32
 
 /* Include ----------------------------------------------------------------- */
-/*
-#include "firmware-sdk/ei_network_device_interface.h"
-
-class EiWifiESP32 : public EiNetworkDevice {
-private:
-
-    bool network_present;
-
-public:
-    EiWifiESP32();
-
-    int8_t init(void);
-
-    int8_t deinit(void);
-
-    int8_t scan_networks(ei_device_network_list_t **networks, uint16_t *network_num);
-
-    int8_t connect_network(ei_config_t *config);
+#include <stdint.h>
 
-    int8_t disconnect_network(void);
+#include "firmware-sdk/ei_config_types.h"
 
-    int8_t send_sample(ei_config_t *config);
+/* Function prototypes ----------------------------------------------------- */
+bool ei_wifi_init(void);
+bool ei_wifi_connect(const char *ssid, const char *password, ei_config_security_t security);
+bool ei_wifi_is_configured(void);
+bool ei_wifi_is_connected(void);
+bool ei_wifi_wait_connected(uint32_t timeout_ms);
 
-};
-*/
-#endif
\ No newline at end of file
+#endif
@@ -34,12 +34,32 @@
 
 /* Include ----------------------------------------------------------------- */
 #include "flash_memory.h"
+#include "esp_rom_crc.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 
 static const char *TAG = "FlashDriver";
 
 /** Align addres to given sector size */
 #define SECTOR_ALIGN(a, sec_size) ((a & (sec_size - 1)) ? (a & ~(sec_size - 1)) + sec_size : a)
 
+/** Chunk used for blank checks and CRC read back */
+#define CHECK_CHUNK_SIZE 256
+
+#define HEADER_SIZE (sizeof(ei_sample_record_header_t))
+
+/** Holds the record lock for the lifetime of the scope */
+class RecordLock {
+public:
+    RecordLock(SemaphoreHandle_t lock): lock(lock) { xSemaphoreTake(lock, portMAX_DELAY); }
+    ~RecordLock() { xSemaphoreGive(lock); }
+
+private:
+    SemaphoreHandle_t lock;
+};
+
 uint32_t EiFlashMemory::read_data(uint8_t *data, uint32_t address, uint32_t num_bytes)
 {
 
@@ -90,8 +110,453 @@ EiFlashMemory::EiFlashMemory(uint32_t config_size):
 
     ESP_LOGI(TAG, "Found partition '%s' at offset 0x%x with size 0x%x\n", partition->label, partition->address, partition->size);
 
-    memory_size = partition->size; 
+    memory_size = partition->size;
+    memory_blocks = memory_size / block_size;
 
     ESP_LOGI(TAG, "memory_size %d used_blocks %d\n", memory_size, used_blocks);
 
+    log_sectors = memory_blocks - used_blocks;
+    write_open = false;
+    memset(&read_record, 0, sizeof(read_record));
+    memset(next_label, 0, sizeof(next_label));
+    lock = xSemaphoreCreateMutex();
+    assert(lock != NULL);
+
+    scan_log();
+}
+
+uint32_t EiFlashMemory::get_available_sample_bytes(void)
+{
+    return log_sectors * block_size - HEADER_SIZE;
+}
+
+uint32_t EiFlashMemory::read_sample_data(uint8_t *sample_data, uint32_t address, uint32_t sample_data_size)
+{
+    RecordLock guard(lock);
+    const ei_sample_record_t *record = write_open ? &write_record : &read_record;
+
+    if (record->n_sectors == 0) {
+        return 0;
+    }
+
+    return record_io(record, sample_data, address, sample_data_size, false);
+}
+
+uint32_t EiFlashMemory::write_sample_data(const uint8_t *sample_data, uint32_t address, uint32_t sample_data_size)
+{
+    RecordLock guard(lock);
+
+    if (write_open == false) {
+        ESP_LOGE(TAG, "No record open for writing\n");
+        return 0;
+    }
+
+    uint32_t written = record_io(&write_record, (uint8_t *)sample_data, address, sample_data_size, true);
+
+    if (address + written > write_record.length) {
+        write_record.length = address + written;
+    }
+
+    return written;
+}
+
+/**
+ * @brief Erasing from the start of the sample area opens a new record with
+ * room for num_bytes, any other address is not supported by the log.
+ */
+uint32_t EiFlashMemory::erase_sample_data(uint32_t address, uint32_t num_bytes)
+{
+    if (address != 0) {
+        ESP_LOGE(TAG, "Erase is only supported from the record start\n");
+        return 0;
+    }
+
+    RecordLock guard(lock);
+
+    return open_record(num_bytes) ? num_bytes : 0;
+}
+
+/**
+ * @brief Remember the label, it is stored in the header of the next record
+ */
+bool EiFlashMemory::setup_sampling(const char* sensor_name, const char* lable_name)
+{
+    RecordLock guard(lock);
+
+    memset(next_label, 0, sizeof(next_label));
+    if (lable_name != NULL) {
+        strncpy(next_label, lable_name, sizeof(next_label) - 1);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Store length and CRC of the open record and release its unused sectors
+ */
+void EiFlashMemory::finalize_samplig(void)
+{
+    uint8_t chunk[CHECK_CHUNK_SIZE];
+    uint32_t crc = 0;
+    RecordLock guard(lock);
+
+    if (write_open == false) {
+        return;
+    }
+
+    for (uint32_t pos = 0; pos < write_record.length; pos += CHECK_CHUNK_SIZE) {
+        uint32_t n = std::min<uint32_t>(CHECK_CHUNK_SIZE, write_record.length - pos);
+        record_io(&write_record, chunk, pos, n, false);
+        crc = esp_rom_crc32_le(crc, chunk, n);
+    }
+
+    write_record.crc = crc;
+
+    uint32_t tail[2] = { write_record.length, write_record.crc };
+    write_data((const uint8_t *)tail, record_address(&write_record, 0) + offsetof(ei_sample_record_header_t, length), sizeof(tail));
+
+    // sectors past the payload stay erased and are used by the next record
+    write_record.n_sectors = (HEADER_SIZE + write_record.length + block_size - 1) / block_size;
+    log_head = (write_record.first_sector + write_record.n_sectors) % log_sectors;
+
+    records.push_back(write_record);
+    read_record = write_record;
+    write_open = false;
+
+    ESP_LOGI(TAG, "Record %d closed, %d bytes in %d sectors\n", write_record.sequence, write_record.length, write_record.n_sectors);
+}
+
+/**
+ * @brief Select the record served by read_sample_data
+ */
+bool EiFlashMemory::select_record(uint32_t sequence)
+{
+    RecordLock guard(lock);
+
+    for (auto it = records.begin(); it != records.end(); it++) {
+        if (it->sequence == sequence) {
+            read_record = *it;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool EiFlashMemory::mark_record_uploaded(uint32_t sequence)
+{
+    RecordLock guard(lock);
+
+    for (auto it = records.begin(); it != records.end(); it++) {
+        if (it->sequence == sequence) {
+            it->flags &= ~EI_SAMPLE_LOG_FLAG_UPLOADED;
+            return set_record_flag(&(*it), EI_SAMPLE_LOG_FLAG_UPLOADED);
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Drop all records without erasing, the sectors are erased again when the log reaches them
+ */
+void EiFlashMemory::clear_records(void)
+{
+    RecordLock guard(lock);
+
+    for (auto it = records.begin(); it != records.end(); it++) {
+        set_record_flag(&(*it), EI_SAMPLE_LOG_FLAG_DELETED);
+    }
+
+    records.clear();
+    memset(&read_record, 0, sizeof(read_record));
+}
+
+/**
+ * @brief Copy of the record list, oldest record first
+ */
+std::vector<ei_sample_record_t> EiFlashMemory::get_records(void)
+{
+    RecordLock guard(lock);
+
+    return records;
+}
+
+/**
+ * @brief Read payload of any closed record without changing the record
+ * selected for read_sample_data. Returns 0 once the record has been evicted.
+ */
+uint32_t EiFlashMemory::read_record_data(uint32_t sequence, uint8_t *data, uint32_t offset, uint32_t num_bytes)
+{
+    RecordLock guard(lock);
+
+    for (auto it = records.begin(); it != records.end(); it++) {
+        if (it->sequence == sequence) {
+            if (offset >= it->length) {
+                return 0;
+            }
+            return record_io(&(*it), data, offset, std::min(num_bytes, it->length - offset), false);
+        }
+    }
+
+    return 0;
+}
+
+/* Private functions ------------------------------------------------------- */
+
+/**
+ * @brief Rebuild the record list and the log head from the record headers
+ */
+void EiFlashMemory::scan_log(void)
+{
+    ei_sample_record_header_t header;
+    ei_sample_record_t newest = { 0 };
+    std::vector<ei_sample_record_t> found;
+
+    for (uint32_t sector = 0; sector < log_sectors; sector++) {
+        if (read_data((uint8_t *)&header, (used_blocks + sector) * block_size, HEADER_SIZE) != HEADER_SIZE) {
+            continue;
+        }
+
+        if (header.magic != EI_SAMPLE_LOG_MAGIC
+            || header.header_crc != header_crc(&header)
+            || header.n_sectors == 0
+            || header.n_sectors > log_sectors) {
+            continue;
+        }
+
+        ei_sample_record_t record = {
+            .sequence = header.sequence,
+            .first_sector = sector,
+            .n_sectors = header.n_sectors,
+            .length = header.length,
+            .crc = header.crc,
+            .flags = header.flags
+        };
+        memcpy(record.label, header.label, sizeof(record.label));
+        record.label[sizeof(record.label) - 1] = 0;
+
+        if (header.length != EI_SAMPLE_LOG_UNSET) {
+            record.n_sectors = (HEADER_SIZE + header.length + block_size - 1) / block_size;
+        }
+
+        // deleted records still tell where the log stopped
+        if (newest.n_sectors == 0 || record.sequence > newest.sequence) {
+            newest = record;
+        }
+
+        if (header.length == EI_SAMPLE_LOG_UNSET) {
+            ESP_LOGW(TAG, "Dropping unfinished record %d\n", header.sequence);
+            set_record_flag(&record, EI_SAMPLE_LOG_FLAG_DELETED);
+            continue;
+        }
+
+        if ((header.flags & EI_SAMPLE_LOG_FLAG_DELETED) == 0) {
+            continue;
+        }
+
+        found.push_back(record);
+    }
+
+    std::sort(found.begin(), found.end(), [](const ei_sample_record_t &a, const ei_sample_record_t &b) {
+        return a.sequence < b.sequence;
+    });
+
+    // keep newest records whose sectors were not reused by a later one
+    records.clear();
+    for (auto it = found.rbegin(); it != found.rend(); it++) {
+        bool overlaps = false;
+        for (auto &newer : records) {
+            uint32_t distance = (it->first_sector + log_sectors - newer.first_sector) % log_sectors;
+            uint32_t back_distance = (newer.first_sector + log_sectors - it->first_sector) % log_sectors;
+            if (distance < newer.n_sectors || back_distance < it->n_sectors) {
+                overlaps = true;
+                break;
+            }
+        }
+        if (!overlaps) {
+            records.insert(records.begin(), *it);
+        }
+    }
+
+    if (newest.n_sectors != 0) {
+        log_head = (newest.first_sector + newest.n_sectors) % log_sectors;
+        next_sequence = newest.sequence + 1;
+    }
+    else {
+        log_head = 0;
+        next_sequence = 1;
+    }
+
+    if (records.size() > 0) {
+        read_record = records.back();
+    }
+
+    ESP_LOGI(TAG, "Sample log: %d records, head at sector %d, next sequence %d\n", (int)records.size(), log_head, next_sequence);
+}
+
+/**
+ * @brief Reserve sectors for a new record at the log head. Records overlapping
+ * the reservation are dropped and only sectors that are not blank get erased.
+ */
+bool EiFlashMemory::open_record(uint32_t num_bytes)
+{
+    uint32_t n_sectors = (HEADER_SIZE + num_bytes + block_size - 1) / block_size;
+
+    if (n_sectors > log_sectors) {
+        ESP_LOGE(TAG, "Record of %d bytes does not fit in the log\n", num_bytes);
+        return false;
+    }
+
+    write_open = false;
+
+    for (auto it = records.begin(); it != records.end();) {
+        uint32_t distance = (it->first_sector + log_sectors - log_head) % log_sectors;
+        uint32_t back_distance = (log_head + log_sectors - it->first_sector) % log_sectors;
+
+        if (distance < n_sectors || back_distance < it->n_sectors) {
+            ESP_LOGI(TAG, "Evicting record %d\n", it->sequence);
+            set_record_flag(&(*it), EI_SAMPLE_LOG_FLAG_DELETED);
+            if (read_record.sequence == it->sequence) {
+                memset(&read_record, 0, sizeof(read_record));
+            }
+            it = records.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+
+    for (uint32_t i = 0; i < n_sectors; i++) {
+        uint32_t sector = (log_head + i) % log_sectors;
+
+        if (sector_is_blank(sector)) {
+            continue;
+        }
+
+        if (erase_data((used_blocks + sector) * block_size, block_size) != block_size) {
+            ESP_LOGE(TAG, "Failed to erase sector %d\n", sector);
+            return false;
+        }
+    }
+
+    write_record = {
+        .sequence = next_sequence++,
+        .first_sector = log_head,
+        .n_sectors = n_sectors,
+        .length = 0,
+        .crc = 0,
+        .flags = EI_SAMPLE_LOG_UNSET
+    };
+    memcpy(write_record.label, next_label, sizeof(write_record.label));
+
+    ei_sample_record_header_t header;
+    memset(&header, 0xFF, sizeof(header));
+    header.magic = EI_SAMPLE_LOG_MAGIC;
+    header.sequence = write_record.sequence;
+    header.n_sectors = n_sectors;
+    memcpy(header.label, next_label, sizeof(header.label));
+    header.header_crc = header_crc(&header);
+
+    // length, crc and flags are left erased and written later
+    if (write_data((const uint8_t *)&header, record_address(&write_record, 0), HEADER_SIZE) == 0) {
+        return false;
+    }
+
+    write_open = true;
+
+    return true;
+}
+
+bool EiFlashMemory::sector_is_blank(uint32_t sector)
+{
+    uint32_t chunk[CHECK_CHUNK_SIZE / sizeof(uint32_t)];
+    uint32_t address = (used_blocks + sector) * block_size;
+
+    for (uint32_t pos = 0; pos < block_size; pos += CHECK_CHUNK_SIZE) {
+        if (read_data((uint8_t *)chunk, address + pos, CHECK_CHUNK_SIZE) != CHECK_CHUNK_SIZE) {
+            return false;
+        }
+        for (uint32_t i = 0; i < CHECK_CHUNK_SIZE / sizeof(uint32_t); i++) {
+            if (chunk[i] != EI_SAMPLE_LOG_UNSET) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+uint32_t EiFlashMemory::header_crc(const ei_sample_record_header_t *header)
+{
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)header, offsetof(ei_sample_record_header_t, header_crc));
+
+    return esp_rom_crc32_le(crc, (const uint8_t *)header->label, sizeof(header->label));
+}
+
+/**
+ * @brief Clear a flag bit in the record header, flags are active low
+ */
+bool EiFlashMemory::set_record_flag(const ei_sample_record_t *record, uint32_t flag)
+{
+    uint32_t flags = record->flags & ~flag;
+    uint32_t address = record_address(record, 0) + offsetof(ei_sample_record_header_t, flags);
+
+    return write_data((const uint8_t *)&flags, address, sizeof(flags)) == sizeof(flags);
+}
+
+/**
+ * @brief Translate a payload offset of the record into a partition address
+ */
+uint32_t EiFlashMemory::record_address(const ei_sample_record_t *record, uint32_t offset)
+{
+    uint32_t sector = (record->first_sector + offset / block_size) % log_sectors;
+
+    return (used_blocks + sector) * block_size + (offset % block_size);
+}
+
+/**
+ * @brief Read or write record payload, splitting the access where the record wraps around the log
+ */
+uint32_t EiFlashMemory::record_io(
+    const ei_sample_record_t *record,
+    uint8_t *data,
+    uint32_t offset,
+    uint32_t num_bytes,
+    bool write)
+{
+    uint32_t capacity = record->n_sectors * block_size - HEADER_SIZE;
+    uint32_t done = 0;
+
+    if (offset >= capacity) {
+        return 0;
+    }
+
+    if (num_bytes > capacity - offset) {
+        num_bytes = capacity - offset;
+    }
+
+    offset += HEADER_SIZE;
+
+    while (done < num_bytes) {
+        // contiguous up to the end of the log, so bulk reads stay one flash access
+        uint32_t sector = (record->first_sector + offset / block_size) % log_sectors;
+        uint32_t chunk = (log_sectors - sector) * block_size - (offset % block_size);
+        uint32_t address = record_address(record, offset);
+        uint32_t ret;
+
+        if (chunk > num_bytes - done) {
+            chunk = num_bytes - done;
+        }
+
+        ret = write ? write_data(data + done, address, chunk) : read_data(data + done, address, chunk);
+        if (ret != chunk) {
+            break;
+        }
+
+        done += chunk;
+        offset += chunk;
+    }
+
+    return done;
 }
@@ -43,11 +43,60 @@
 #include "esp_log.h"
 #include <assert.h>
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include <vector>
+
 #define ESP32_FS_BLOCK_ERASE_TIME_MS 38
 
+/** Marks the first sector of every record in the sample log ("EILG") */
+#define EI_SAMPLE_LOG_MAGIC          0x474C4945
+/** Written (1 -> 0) into the header flags, flash allows it without an erase */
+#define EI_SAMPLE_LOG_FLAG_UPLOADED  (1 << 0)
+#define EI_SAMPLE_LOG_FLAG_DELETED   (1 << 1)
+/** Header fields that are not written yet read back as erased flash */
+#define EI_SAMPLE_LOG_UNSET          0xFFFFFFFF
+/** Space for the sample label in the record header, including the terminator */
+#define EI_SAMPLE_LOG_LABEL_SIZE     32
+
 /**
- * @brief
- *
+ * @brief On-flash header at the start of the first sector of every record.
+ * magic, sequence, n_sectors and label are written when the record is opened,
+ * length and crc when it is finalized, flags are cleared bit by bit afterwards.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t n_sectors;
+    uint32_t header_crc;    // over magic, sequence, n_sectors and label
+    uint32_t length;
+    uint32_t crc;
+    uint32_t flags;
+    uint32_t reserved;
+    char label[EI_SAMPLE_LOG_LABEL_SIZE];
+} ei_sample_record_header_t;
+
+/**
+ * @brief RAM copy of a record found in the sample log
+ */
+typedef struct {
+    uint32_t sequence;
+    uint32_t first_sector;  // relative to the start of the log
+    uint32_t n_sectors;     // sectors reserved, shrinks to the used ones on finalize
+    uint32_t length;        // payload bytes, without the header
+    uint32_t crc;
+    uint32_t flags;
+    char label[EI_SAMPLE_LOG_LABEL_SIZE];
+} ei_sample_record_t;
+
+/**
+ * @brief Storage partition driver. The first block(s) hold the device config,
+ * the remaining sectors form a circular log of sample records, so new
+ * recordings are appended after the last one and the erase cycles rotate over
+ * the whole partition. Sample addresses used by the samplers and AT+READBUFFER
+ * are relative to the payload of the current record.
+ * The record list is shared with the uploader task, so public methods lock.
  */
 class EiFlashMemory : public EiDeviceMemory {
 protected:
@@ -58,8 +107,45 @@ protected:
 private:
     const esp_partition_t *partition;
 
+    /** Number of sectors available for the sample log */
+    uint32_t log_sectors;
+    /** First sector of the next record */
+    uint32_t log_head;
+    uint32_t next_sequence;
+
+    /** Finalized records, oldest first */
+    std::vector<ei_sample_record_t> records;
+    /** Record being written (valid if write_open) and record used for reads */
+    ei_sample_record_t write_record;
+    ei_sample_record_t read_record;
+    bool write_open;
+    /** Label of the next record, see setup_sampling() */
+    char next_label[EI_SAMPLE_LOG_LABEL_SIZE];
+    SemaphoreHandle_t lock;
+
+    void scan_log(void);
+    bool open_record(uint32_t num_bytes);
+    bool sector_is_blank(uint32_t sector);
+    bool set_record_flag(const ei_sample_record_t *record, uint32_t flag);
+    uint32_t record_address(const ei_sample_record_t *record, uint32_t offset);
+    uint32_t record_io(const ei_sample_record_t *record, uint8_t *data, uint32_t offset, uint32_t num_bytes, bool write);
+    uint32_t header_crc(const ei_sample_record_header_t *header);
+
 public:
     EiFlashMemory(uint32_t config_size);
+
+    uint32_t get_available_sample_bytes(void) override;
+    uint32_t read_sample_data(uint8_t *sample_data, uint32_t address, uint32_t sample_data_size) override;
+    uint32_t write_sample_data(const uint8_t *sample_data, uint32_t address, uint32_t sample_data_size) override;
+    uint32_t erase_sample_data(uint32_t address, uint32_t num_bytes) override;
+    bool setup_sampling(const char* sensor_name, const char* lable_name) override;
+    void finalize_samplig(void) override;
+
+    std::vector<ei_sample_record_t> get_records(void);
+    uint32_t read_record_data(uint32_t sequence, uint8_t *data, uint32_t offset, uint32_t num_bytes);
+    bool select_record(uint32_t sequence);
+    bool mark_record_uploaded(uint32_t sequence);
+    void clear_records(void);
 };
 
-#endif /* EI_FLASH_MEMORY_H */
\ No newline at end of file
+#endif /* EI_FLASH_MEMORY_H */
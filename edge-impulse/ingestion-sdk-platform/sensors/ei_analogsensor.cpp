@@ -35,39 +35,362 @@
 /* Include ----------------------------------------------------------------- */
 #include <stdint.h>
 #include <stdlib.h>
+#include <math.h>
 
-#include "driver/adc.h"
-#include "esp_adc_cal.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
 
 #include "ei_device_espressif_esp32.h"
 #include "ei_analogsensor.h"
 #include "firmware-sdk/sensor-aq/sensor_aq.h"
 
-static esp_adc_cal_characteristics_t *adc_chars;
+#if ANALOG_SENSOR_SIMULATE == 0
+#include "esp_adc/adc_continuous.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+
+static adc_continuous_handle_t adc_handle = NULL;
+static adc_cali_handle_t cali_handle = NULL;
 #if CONFIG_IDF_TARGET_ESP32
 static const adc_channel_t channel = ADC_CHANNEL_6;     //GPIO34 if ADC1, GPIO14 if ADC2
-static const adc_bits_width_t width = ADC_WIDTH_BIT_12;
 #elif CONFIG_IDF_TARGET_ESP32S2
 static const adc_channel_t channel = ADC_CHANNEL_6;     // GPIO7 if ADC1, GPIO17 if ADC2
-static const adc_bits_width_t width = ADC_WIDTH_BIT_13;
 #endif
 static const adc_atten_t atten = ADC_ATTEN_DB_0;
 static const adc_unit_t unit = ADC_UNIT_1;
 
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+#define ANALOG_OUTPUT_FORMAT    ADC_DIGI_OUTPUT_FORMAT_TYPE1
+#define ANALOG_GET_CHANNEL(p)   ((p)->type1.channel)
+#define ANALOG_GET_DATA(p)      ((p)->type1.data)
+#else
+#define ANALOG_OUTPUT_FORMAT    ADC_DIGI_OUTPUT_FORMAT_TYPE2
+#define ANALOG_GET_CHANNEL(p)   ((p)->type2.channel)
+#define ANALOG_GET_DATA(p)      ((p)->type2.data)
+#endif
+#endif
+
 /* Constant defines -------------------------------------------------------- */
+/** Conversions kept between two reads, ~200 ms at 20 kHz. Must be a power of 2 */
+#define ANALOG_RING_SIZE        4096
+#define ANALOG_RING_MASK        (ANALOG_RING_SIZE - 1)
+/** Conversions handed over by the DMA per frame */
+#define ANALOG_FRAME_SAMPLES    256
+#define ANALOG_TASK_STACK       4096
+#define ANALOG_TASK_PRIO        (configMAX_PRIORITIES - 3)
+/** Stop converting when nobody has read for this long */
+#define ANALOG_IDLE_TIMEOUT_US  500000
+
+static const char *TAG = "analog";
+
 static float analog_data[ANALOG_AXIS_SAMPLED];
 
+/* Ring buffer filled by the acquisition task, free running indexes */
+static uint16_t ring[ANALOG_RING_SIZE];
+static uint32_t ring_write = 0;
+static uint32_t ring_read = 0;
+static uint32_t ring_dropped = 0;
+static portMUX_TYPE ring_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t analog_task_handle = NULL;
+static volatile bool running = false;
+static volatile int64_t last_read_us = 0;
+
+static void ring_push(const uint16_t *values, size_t n)
+{
+    taskENTER_CRITICAL(&ring_lock);
+    for (size_t i = 0; i < n; i++) {
+        ring[(ring_write + i) & ANALOG_RING_MASK] = values[i];
+    }
+    ring_write += n;
+
+    if (ring_write - ring_read > ANALOG_RING_SIZE) {
+        ring_dropped += ring_write - ring_read - ANALOG_RING_SIZE;
+        ring_read = ring_write - ANALOG_RING_SIZE;
+    }
+    taskEXIT_CRITICAL(&ring_lock);
+}
+
+#if ANALOG_SENSOR_SIMULATE == 1
+static uint64_t sim_produced;
+static int64_t sim_start;
+
+static bool analog_source_init(void)
+{
+    return true;
+}
+
+static bool analog_source_start(void)
+{
+    sim_produced = 0;
+    sim_start = esp_timer_get_time();
+
+    return true;
+}
+
+static void analog_source_stop(void)
+{
+}
+
+/**
+ * @brief Stand-in for the DMA on the target, synthesizes a 50 Hz tone with a
+ * 1 kHz component at the hardware conversion rate
+ */
+static size_t analog_source_read(uint16_t *values, size_t max_samples)
+{
+    uint64_t due;
+
+    for (;;) {
+        due = ((uint64_t)(esp_timer_get_time() - sim_start) * ANALOG_DMA_SAMPLE_FREQ_HZ) / 1000000;
+        if (due - sim_produced >= max_samples) {
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+
+    for (size_t i = 0; i < max_samples; i++, sim_produced++) {
+        float t = (float)(sim_produced % ANALOG_DMA_SAMPLE_FREQ_HZ) / ANALOG_DMA_SAMPLE_FREQ_HZ;
+        float v = 2048.0f + 1500.0f * sinf(2.0f * (float)M_PI * 50.0f * t)
+            + 300.0f * sinf(2.0f * (float)M_PI * 1000.0f * t);
+        values[i] = (uint16_t)v;
+    }
+
+    return max_samples;
+}
+#else
+static bool analog_source_init(void)
+{
+#if ANALOG_SENSOR_CALIBRATED == 1
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_curve_fitting_config_t cali_config = {};
+    cali_config.unit_id = unit;
+    cali_config.atten = atten;
+    cali_config.bitwidth = (adc_bitwidth_t)SOC_ADC_DIGI_MAX_BITWIDTH;
+    if (adc_cali_create_scheme_curve_fitting(&cali_config, &cali_handle) != ESP_OK) {
+        cali_handle = NULL;
+    }
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    adc_cali_line_fitting_config_t cali_config = {};
+    cali_config.unit_id = unit;
+    cali_config.atten = atten;
+    cali_config.bitwidth = (adc_bitwidth_t)SOC_ADC_DIGI_MAX_BITWIDTH;
+    if (adc_cali_create_scheme_line_fitting(&cali_config, &cali_handle) != ESP_OK) {
+        cali_handle = NULL;
+    }
+#endif
+    if (cali_handle == NULL) {
+        ESP_LOGW(TAG, "No ADC calibration available, reporting raw values");
+    }
+#endif
+
+    return true;
+}
+
+/**
+ * @brief The continuous driver claims I2S0 on the ESP32, which the camera
+ * needs as well. The handle only exists while conversions run.
+ */
+static bool analog_source_start(void)
+{
+    adc_continuous_handle_cfg_t handle_config = {};
+    handle_config.max_store_buf_size = ANALOG_FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES * 4;
+    handle_config.conv_frame_size = ANALOG_FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES;
+
+    if (adc_continuous_new_handle(&handle_config, &adc_handle) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create ADC continuous handle");
+        adc_handle = NULL;
+        return false;
+    }
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = atten;
+    pattern.channel = channel;
+    pattern.unit = unit;
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_continuous_config_t config = {};
+    config.pattern_num = 1;
+    config.adc_pattern = &pattern;
+    config.sample_freq_hz = ANALOG_DMA_SAMPLE_FREQ_HZ;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ANALOG_OUTPUT_FORMAT;
+
+    if (adc_continuous_config(adc_handle, &config) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to configure ADC continuous mode");
+        adc_continuous_deinit(adc_handle);
+        adc_handle = NULL;
+        return false;
+    }
+
+    if (adc_continuous_start(adc_handle) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start ADC continuous mode");
+        adc_continuous_deinit(adc_handle);
+        adc_handle = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+static void analog_source_stop(void)
+{
+    adc_continuous_stop(adc_handle);
+    adc_continuous_deinit(adc_handle);
+    adc_handle = NULL;
+}
+
+/**
+ * @brief Take one conversion frame from the DMA and convert it in bulk
+ */
+static size_t analog_source_read(uint16_t *values, size_t max_samples)
+{
+    uint8_t frame[ANALOG_FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES];
+    uint32_t length = 0;
+    size_t n = 0;
+
+    if (max_samples > ANALOG_FRAME_SAMPLES) {
+        max_samples = ANALOG_FRAME_SAMPLES;
+    }
+
+    if (adc_continuous_read(adc_handle, frame, max_samples * SOC_ADC_DIGI_RESULT_BYTES, &length, 100) != ESP_OK) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        adc_digi_output_data_t *p = (adc_digi_output_data_t *)&frame[i];
+        if (ANALOG_GET_CHANNEL(p) == channel) {
+            values[n++] = ANALOG_GET_DATA(p);
+        }
+    }
+
+#if ANALOG_SENSOR_CALIBRATED == 1
+    if (cali_handle != NULL) {
+        for (size_t i = 0; i < n; i++) {
+            int mv = 0;
+            adc_cali_raw_to_voltage(cali_handle, values[i], &mv);
+            values[i] = (uint16_t)mv;
+        }
+    }
+#endif
+
+    return n;
+}
+#endif
+
+/**
+ * @brief Acquisition task. Conversions only run while someone reads them:
+ * the first read wakes the task, which sets up the ADC driver, and the
+ * driver is released again once reads have stopped for
+ * ANALOG_IDLE_TIMEOUT_US. On the ESP32 the ADC DMA shares I2S0 with the
+ * camera, so it must not be held in the background.
+ */
+static void analog_task(void *arg)
+{
+    uint16_t values[ANALOG_FRAME_SAMPLES];
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // the next read asks again
+        if (analog_source_start() == false) {
+            continue;
+        }
+        running = true;
+
+        while (esp_timer_get_time() - last_read_us < ANALOG_IDLE_TIMEOUT_US) {
+            size_t n = analog_source_read(values, ANALOG_FRAME_SAMPLES);
+            ring_push(values, n);
+        }
+
+        running = false;
+        analog_source_stop();
+    }
+}
+
+/**
+ * @brief Drop every unread conversion
+ */
+static void analog_flush(void)
+{
+    taskENTER_CRITICAL(&ring_lock);
+    ring_read = ring_write;
+    taskEXIT_CRITICAL(&ring_lock);
+}
+
+static void analog_request_data(void)
+{
+    last_read_us = esp_timer_get_time();
+
+    /* whatever is left in the ring predates the idle stop, drop it before
+       the caller reads so the first read only returns fresh conversions */
+    if (running == false) {
+        analog_flush();
+        xTaskNotifyGive(analog_task_handle);
+    }
+}
+
 bool ei_analog_sensor_init(void)
 {
-    adc1_config_width(width);
+    if (analog_source_init() == false) {
+        return false;
+    }
+
+    if (xTaskCreate(analog_task, "ei_analog", ANALOG_TASK_STACK, NULL, ANALOG_TASK_PRIO, &analog_task_handle) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create analog task");
+        return false;
+    }
+
     ei_add_sensor_to_fusion_list(analog_sensor);
 
     return true;
 }
 
+/**
+ * @brief Fusion callback, returns the mean of all conversions made since the
+ * previous call. This low-pass filters the signal down to the fusion
+ * frequency instead of picking a single conversion at the timer instant.
+ */
 float *ei_fusion_analog_sensor_read_data(int n_samples)
 {
-    analog_data[0] = adc1_get_raw((adc1_channel_t)channel);
+    uint32_t sum = 0;
+    uint32_t start;
+    uint32_t count;
+
+    analog_request_data();
+
+    /* only claim the range under the lock, the task keeps pushing while we sum */
+    taskENTER_CRITICAL(&ring_lock);
+    start = ring_read;
+    count = ring_write - ring_read;
+    ring_read = ring_write;
+    taskEXIT_CRITICAL(&ring_lock);
+
+    for (uint32_t i = 0; i < count; i++) {
+        sum += ring[(start + i) & ANALOG_RING_MASK];
+    }
+
+    /* the task lapped the ring while we summed, part of the range is newer data */
+    taskENTER_CRITICAL(&ring_lock);
+    bool lapped = ring_write - start > ANALOG_RING_SIZE;
+    if (lapped) {
+        ring_dropped += count;
+    }
+    taskEXIT_CRITICAL(&ring_lock);
+
+    /* timer faster than the conversions, hold the previous value */
+    if (count > 0 && lapped == false) {
+        analog_data[0] = (float)sum / count;
+    }
 
     return analog_data;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Number of conversions overwritten before they were read
+ */
+uint32_t ei_analog_sensor_get_overruns(void)
+{
+    return ring_dropped;
+}
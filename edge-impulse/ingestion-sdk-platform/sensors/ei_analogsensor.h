@@ -43,9 +43,23 @@
 /** Number of axis used and sample data format */
 #define ANALOG_AXIS_SAMPLED 1
 
+/** Hardware (DMA) conversion rate, each fusion sample averages the conversions since the previous one */
+#define ANALOG_DMA_SAMPLE_FREQ_HZ   20000
+/** Report calibrated millivolts instead of raw ADC counts */
+#ifndef ANALOG_SENSOR_CALIBRATED
+#define ANALOG_SENSOR_CALIBRATED    0
+#endif
+/** Replace the ADC by a synthesized waveform fed through the same ring buffer.
+ * This still runs on the target (task, timer and ring are the real ones), it
+ * is meant for boards with nothing wired to the ADC pin. */
+#ifndef ANALOG_SENSOR_SIMULATE
+#define ANALOG_SENSOR_SIMULATE      0
+#endif
+
 /* Function prototypes ----------------------------------------------------- */
 bool ei_analog_sensor_init(void);
 float *ei_fusion_analog_sensor_read_data(int n_samples);
+uint32_t ei_analog_sensor_get_overruns(void);
 
 static const ei_device_fusion_sensor_t analog_sensor = {
     // name of sensor module to be displayed in fusion list
@@ -53,13 +67,20 @@ static const ei_device_fusion_sensor_t analog_sensor = {
     // number of sensor module axis
     ANALOG_AXIS_SAMPLED,
     // sampling frequencies
-    { 100.0f, 62.5f, 8.5f, 5.0f, 1.0f },
+    { 1000.0f, 100.0f, 62.5f, 5.0f, 1.0f },
     // axis name and units payload (must be same order as read in)
     {
+#if ANALOG_SENSOR_CALIBRATED == 1
+        { "adc", "mV" },
+#else
         { "adc", "na" },
+#endif
     },
     // reference to read data function
-    &ei_fusion_analog_sensor_read_data
+    &ei_fusion_analog_sensor_read_data,
+    0,
+    // bus the sensor is read over
+    EI_FUSION_BUS_ADC
 };
 
 #endif
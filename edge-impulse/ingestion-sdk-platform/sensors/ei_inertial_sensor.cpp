@@ -35,21 +35,113 @@
 /* Include ----------------------------------------------------------------- */
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ei_inertial_sensor.h"
 
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "edge-impulse-sdk/porting/ei_logging.h"
 
+#include "esp_timer.h"
+
 #include "LIS3DHTR.h"
 
 /* Constant defines -------------------------------------------------------- */
 #define CONVERT_G_TO_MS2    9.80665f
 
+/** Sensor output data rate, every fusion frequency is served from this rate */
+#define INERTIAL_ODR_PERIOD_US      2500
+/** Samples collected in the hardware FIFO before they are read in one burst */
+#define INERTIAL_FIFO_WATERMARK     8
+/** Local copy of the drained samples, must hold at least one full FIFO */
+#define INERTIAL_QUEUE_SIZE         (2 * LIS3DHTR_FIFO_DEPTH)
+
+typedef struct {
+    float xyz[INERTIAL_AXIS_SAMPLED];
+    int64_t timestamp_us;
+} inertial_sample_t;
+
 static float imu_data[INERTIAL_AXIS_SAMPLED];
 
 LIS3DHTR lis;
 
+static bool fifo_enabled = false;
+static inertial_sample_t queue[INERTIAL_QUEUE_SIZE];
+static int queue_head = 0;
+static int queue_count = 0;
+static int64_t last_drain_us = 0;
+/* measured ODR period, the sensor oscillator is only accurate to ~10% */
+static int64_t period_us = INERTIAL_ODR_PERIOD_US;
+/* samples read since rate_start_us, the period is measured over all of them */
+static int64_t rate_start_us = 0;
+static uint32_t rate_samples = 0;
+
+static void inertial_queue_reset(void)
+{
+    queue_head = 0;
+    queue_count = 0;
+    last_drain_us = 0;
+}
+
+/**
+ * @brief Read every sample waiting in the sensor FIFO with a single I2C
+ * transfer and timestamp them. The sensor does not timestamp samples, so
+ * the newest one is placed half a period before the read and the others
+ * are spaced by the measured output data rate.
+ */
+static void inertial_drain_fifo(int64_t now)
+{
+    float xyz[LIS3DHTR_FIFO_DEPTH * INERTIAL_AXIS_SAMPLED];
+    bool overrun = false;
+    int n = lis.readFifo(xyz, LIS3DHTR_FIFO_DEPTH, &overrun);
+
+    if (n == 0) {
+        return;
+    }
+
+    /* A single batch is off by up to a sample, so the period is measured
+     * from the first drain of a session. Lost samples restart the count. */
+    if (last_drain_us == 0 || overrun == true) {
+        rate_start_us = now;
+        rate_samples = 0;
+    }
+    else {
+        rate_samples += n;
+        if (rate_samples >= LIS3DHTR_FIFO_DEPTH) {
+            int64_t measured = (now - rate_start_us) / rate_samples;
+            if (measured > (INERTIAL_ODR_PERIOD_US * 8) / 10 && measured < (INERTIAL_ODR_PERIOD_US * 12) / 10) {
+                period_us = measured;
+            }
+        }
+    }
+
+    int64_t newest = now - period_us / 2;
+
+    /* stay continuous with the previous batch and only pull slowly towards
+     * the estimate, jumping to it would repeat or skip a sample */
+    if (queue_count > 0 && overrun == false) {
+        const inertial_sample_t *last = &queue[(queue_head + queue_count - 1) % INERTIAL_QUEUE_SIZE];
+        int64_t chained = last->timestamp_us + n * period_us;
+        if (chained - newest < 2 * period_us && newest - chained < 2 * period_us) {
+            newest = chained + (newest - chained) / 8;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (queue_count == INERTIAL_QUEUE_SIZE) {
+            queue_head = (queue_head + 1) % INERTIAL_QUEUE_SIZE;
+            queue_count--;
+        }
+
+        inertial_sample_t *sample = &queue[(queue_head + queue_count) % INERTIAL_QUEUE_SIZE];
+        memcpy(sample->xyz, &xyz[i * INERTIAL_AXIS_SAMPLED], sizeof(sample->xyz));
+        sample->timestamp_us = newest - (n - 1 - i) * period_us;
+        queue_count++;
+    }
+
+    last_drain_us = now;
+}
+
 bool ei_inertial_init(void) {
 
     lis.begin(LIS3DHTR_DEFAULT_ADDRESS);
@@ -61,7 +153,10 @@ bool ei_inertial_init(void) {
 
     ei_sleep(100);
     lis.setFullScaleRange(LIS3DHTR_RANGE_2G);
-    lis.setOutputDataRate(LIS3DHTR_DATARATE_100HZ);
+    lis.setOutputDataRate(LIS3DHTR_DATARATE_400HZ);
+    lis.setFifoMode(LIS3DHTR_FIFO_STREAM, INERTIAL_FIFO_WATERMARK);
+    fifo_enabled = true;
+    inertial_queue_reset();
 
     if(ei_add_sensor_to_fusion_list(inertial_sensor) == false) {
         EI_LOGE("Failed to register Inertial sensor!\n");
@@ -71,13 +166,52 @@ bool ei_inertial_init(void) {
     return true;
 }
 
+/**
+ * @brief Called on every fusion tick. Samples are pulled out of the sensor
+ * FIFO in batches of INERTIAL_FIFO_WATERMARK and the tick is answered from
+ * the local queue with the sample taken closest to a fixed delay in the
+ * past, so the output stays evenly spaced while the bus is only used once
+ * per batch.
+ */
 float *ei_fusion_inertial_read_data(int n_samples)
 {
-    
-    lis.getAcceleration(&imu_data[0], &imu_data[1], &imu_data[2]);
+    if (fifo_enabled == false) {
+        lis.getAcceleration(&imu_data[0], &imu_data[1], &imu_data[2]);
+    }
+    else {
+        int64_t now = esp_timer_get_time();
+        int64_t batch_us = INERTIAL_FIFO_WATERMARK * period_us;
+
+        /* first tick of a new sampling session, everything queued is stale */
+        if (last_drain_us != 0 && now - last_drain_us > LIS3DHTR_FIFO_DEPTH * period_us) {
+            inertial_queue_reset();
+        }
+
+        int64_t target = now - batch_us - period_us;
+
+        /* only touch the bus once the queue no longer covers the target */
+        if (queue_count == 0 ||
+            queue[(queue_head + queue_count - 1) % INERTIAL_QUEUE_SIZE].timestamp_us < target) {
+            inertial_drain_fifo(now);
+        }
+
+        if (queue_count == 0) {
+            lis.getAcceleration(&imu_data[0], &imu_data[1], &imu_data[2]);
+        }
+        else {
+            while (queue_count > 1 &&
+                queue[(queue_head + 1) % INERTIAL_QUEUE_SIZE].timestamp_us <= target) {
+                queue_head = (queue_head + 1) % INERTIAL_QUEUE_SIZE;
+                queue_count--;
+            }
+
+            memcpy(imu_data, queue[queue_head].xyz, sizeof(imu_data));
+        }
+    }
+
     imu_data[0] *= CONVERT_G_TO_MS2;
     imu_data[1] *= CONVERT_G_TO_MS2;
     imu_data[2] *= CONVERT_G_TO_MS2;
-    
+
     return imu_data;
-}
\ No newline at end of file
+}
@@ -51,12 +51,14 @@ static const ei_device_fusion_sensor_t inertial_sensor = {
     // number of sensor module axis
     INERTIAL_AXIS_SAMPLED,
     // sampling frequencies
-    { 20.0f, 62.5f, 100.0f },
+    { 20.0f, 62.5f, 100.0f, 200.0f, 400.0f },
     // axis name and units payload (must be same order as read in)
     { {"accX", "m/s2"}, {"accY", "m/s2"}, {"accZ", "m/s2"} }, 
     // reference to read data function
     &ei_fusion_inertial_read_data,
-    0
+    0,
+    // bus the sensor is read over
+    EI_FUSION_BUS_I2C
 };
 
 #endif /* EI_INERTIAL_SENSOR_H */
@@ -36,6 +36,7 @@
 #include "ei_microphone.h"
 
 #include "ei_device_espressif_esp32.h"
+#include "ei_uploader_esp32.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -46,17 +47,25 @@
 #include "esp_system.h"
 #include "esp_timer.h"
 
+#include <string.h>
+
 #include "ei_config_types.h"
 #include "sensor_aq_mbedtls_hs256.h"
+#include "ei_sample_signature.h"
 #include "firmware-sdk/sensor-aq/sensor_aq_none.h"
 #include "edge-impulse-sdk/dsp/numpy.hpp"
+#include "edge-impulse-sdk/porting/ei_memory_placement.h"
+#include "ei_slice_event.h"
+#include "ei_audio_gate.h"
 
 typedef struct {
     int16_t *buffers[2];
     uint8_t buf_select;
-    uint8_t buf_ready;
     uint32_t buf_count;
     uint32_t n_samples;
+    /* level of the buffers for the silence gate, only measured when it asks */
+    bool stats_enabled;
+    EiAudioSliceStats stats;
 } inference_t;
 
 /* Dummy functions for sensor_aq_ctx type */
@@ -80,6 +89,8 @@ static uint32_t current_sample;
 static uint32_t audio_sampling_frequency = 16000;
 
 static inference_t inference;
+/** Signalled by the capture task when a buffer is full */
+static EiSliceEvent slice_ready;
 
 static unsigned char ei_mic_ctx_buffer[1024];
 static sensor_aq_signing_ctx_t ei_mic_signing_ctx;
@@ -119,13 +130,30 @@ static void audio_write_callback(uint32_t n_bytes)
 
 static void audio_inference_callback(uint32_t n_bytes)
 {
-    for(int i = 0; i < n_bytes>>1; i++) {
-        inference.buffers[inference.buf_select][inference.buf_count++] = sampleBuffer[i];
+    const int16_t *samples = sampleBuffer;
+    uint32_t remaining = n_bytes >> 1;
+
+    while (remaining > 0) {
+        uint32_t n = inference.n_samples - inference.buf_count;
+        if (n > remaining) {
+            n = remaining;
+        }
+
+        memcpy(&inference.buffers[inference.buf_select][inference.buf_count], samples, n * sizeof(int16_t));
+        if (inference.stats_enabled) {
+            inference.stats.add(samples, n);
+        }
+        inference.buf_count += n;
+        samples += n;
+        remaining -= n;
 
         if(inference.buf_count >= inference.n_samples) {
+            if (inference.stats_enabled) {
+                inference.stats.finish();
+            }
             inference.buf_select ^= 1;
             inference.buf_count = 0;
-            inference.buf_ready = 1;
+            slice_ready.signal(esp_timer_get_time());
         }
     }
 }
@@ -181,7 +209,12 @@ static void finish_and_upload(char *filename, uint32_t sample_length_ms) {
 
     ei_printf("[1/1] Uploading file to Edge Impulse...\n");
 
-    ei_printf("Not uploading file, not connected to WiFi. Used buffer, from=%lu, to=%lu.\n", 0, current_sample + headerOffset);
+    if (ei_uploader_enqueue_last()) {
+        ei_printf("Sample queued, uploading in the background over WiFi\n");
+    }
+    else {
+        ei_printf("Not uploading file, not connected to WiFi. Used buffer, from=%lu, to=%lu.\n", 0, current_sample + headerOffset);
+    }
 
     ei_printf("[1/1] Uploading file to Edge Impulse OK (took %d ms.)\n", 0);
 
@@ -259,11 +292,9 @@ static bool create_header(void)
 
     end_of_header_ix += ref_size;
 
-    // Write to blockdevice
-    int ret = mem->write_sample_data((uint8_t*)ei_mic_ctx.cbor_buffer.ptr, 0, end_of_header_ix);
-
-    if (ret != end_of_header_ix) {
-        ei_printf("Failed to write to header blockdevice (%d)\n", ret);
+    // Write to blockdevice, the signature is written when the sample is complete
+    if (ei_sample_write_header(mem, &ei_mic_ctx, end_of_header_ix) == false) {
+        ei_printf("Failed to write to header blockdevice\n");
         return false;
     }
 
@@ -286,6 +317,8 @@ bool ei_microphone_record(uint32_t sample_length_ms, uint32_t start_delay_ms, bo
         ei_printf("Starting in %lu ms... (or until all flash was erased)\n", start_delay_ms);
     }
 
+    mem->setup_sampling("audio", dev->get_sample_label().c_str());
+
     if(mem->erase_sample_data(0, (samples_required << 1) + 4096) != ((samples_required << 1) + 4096)) {
         return false;
     }
@@ -307,15 +340,18 @@ bool ei_microphone_record(uint32_t sample_length_ms, uint32_t start_delay_ms, bo
 
 bool ei_microphone_inference_start(uint32_t n_samples, float interval_ms)
 {
-
-    inference.buffers[0] = (int16_t *)ei_malloc(n_samples * sizeof(int16_t));
+    {
+        // read once per window, keep internal RAM for DSP and the arena
+        EiMemoryPlacement placement(EI_MEMORY_CLASS_COLD);
+        inference.buffers[0] = (int16_t *)ei_malloc(n_samples * sizeof(int16_t));
+        inference.buffers[1] = (int16_t *)ei_malloc(n_samples * sizeof(int16_t));
+    }
 
     if(inference.buffers[0] == NULL) {
+        ei_free(inference.buffers[1]);
         return false;
     }
 
-    inference.buffers[1] = (int16_t *)ei_malloc(n_samples * sizeof(int16_t));
-
     if(inference.buffers[1] == NULL) {
         ei_free(inference.buffers[0]);
         return false;
@@ -330,10 +366,17 @@ bool ei_microphone_inference_start(uint32_t n_samples, float interval_ms)
         return false;
     }
 
+    if (slice_ready.init() == false) {
+        ei_free(inference.buffers[0]);
+        ei_free(inference.buffers[1]);
+        ei_free(sampleBuffer);
+        return false;
+    }
+
     inference.buf_select = 0;
     inference.buf_count  = 0;
     inference.n_samples  = n_samples;
-    inference.buf_ready  = 0;
+    inference.stats.reset();
 
     // Calculate sample rate from sample interval
     audio_sampling_frequency = (uint32_t)(1000.f / interval_ms);
@@ -352,6 +395,19 @@ bool ei_microphone_inference_start(uint32_t n_samples, float interval_ms)
 
 }
 
+/**
+ * @brief      Block until the capture task completed a buffer
+ *
+ * @param[in]  timeout_ms  maximum time to wait
+ * @param[out] ready_us    if not NULL, time the buffer was completed
+ *
+ * @return     false on timeout
+ */
+bool ei_microphone_inference_wait(uint32_t timeout_ms, int64_t *ready_us)
+{
+    return slice_ready.wait(timeout_ms, ready_us);
+}
+
 /**
  * @brief      Wait for a full buffer
  *
@@ -361,25 +417,57 @@ bool ei_microphone_inference_record(void)
 {
     bool ret = true;
 
-    if (inference.buf_ready == 1) {
+    if (slice_ready.pending()) {
         ei_printf(
             "Error sample buffer overrun. Decrease the number of slices per model window "
             "(EI_CLASSIFIER_SLICES_PER_MODEL_WINDOW)\n");
         ret = false;
     }
 
-    while (inference.buf_ready == 0) {
-        vTaskDelay(1 / portTICK_RATE_MS);
-    }
-
-    inference.buf_ready = 0;
+    slice_ready.wait(EI_SLICE_EVENT_WAIT_FOREVER, NULL);
 
     return ret;
 }
 
 bool ei_microphone_inference_is_recording(void)
 {
-    return inference.buf_ready == 0;
+    return slice_ready.pending() == false;
+}
+
+/**
+ * @brief      Number of buffers that were overwritten before being classified
+ */
+uint32_t ei_microphone_inference_get_overruns(void)
+{
+    return slice_ready.get_overruns();
+}
+
+/**
+ * @brief      Measure the level of every buffer while it is captured, for a
+ *             silence gate. Off by default, it costs a pass over each sample.
+ */
+void ei_microphone_inference_set_slice_stats(bool enable)
+{
+    inference.stats_enabled = enable;
+}
+
+/**
+ * @brief      RMS level and zero crossing rate (crossings per sample) of the
+ *             last completed buffer, zero unless enabled with
+ *             ei_microphone_inference_set_slice_stats()
+ */
+void ei_microphone_inference_get_slice_stats(float *rms, float *zcr)
+{
+    *rms = inference.stats.get_rms();
+    *zcr = inference.stats.get_zcr();
+}
+
+/**
+ * @brief      The last completed buffer as captured
+ */
+const int16_t *ei_microphone_inference_get_buffer(void)
+{
+    return inference.buffers[inference.buf_select ^ 1];
 }
 
 /**
@@ -387,8 +475,8 @@ bool ei_microphone_inference_is_recording(void)
  */
 void ei_microphone_inference_reset_buffers(void)
 {
-    inference.buf_ready = 0;
     inference.buf_count = 0;
+    slice_ready.clear();
 }
 
 /**
@@ -440,7 +528,10 @@ bool ei_microphone_sample_start(void)
 
     is_uploaded = false;
 
-    sampleBuffer = (int16_t *)ei_malloc(mem->block_size);
+    {
+        EiMemoryPlacement placement(EI_MEMORY_CLASS_COLD);
+        sampleBuffer = (int16_t *)ei_malloc(mem->block_size);
+    }
 
     if (sampleBuffer == NULL) {
         return false;
@@ -469,6 +560,14 @@ bool ei_microphone_sample_start(void)
         return false;
     }
 
+    // the record is only finalized (and uploaded) once it carries its signature
+    if (ei_sample_write_signature(mem, &ei_mic_ctx) == false) {
+        ei_printf("Failed to write the signature to flash\n");
+        return false;
+    }
+
+    mem->finalize_samplig();
+
     finish_and_upload((char*)dev->get_sample_label().c_str(), dev->get_sample_length_ms());
 
     return true;
@@ -45,7 +45,12 @@ bool ei_microphone_inference_start(uint32_t n_samples, float interval_ms);
 
 bool ei_microphone_sample_start(void);
 bool ei_microphone_inference_record(void);
+bool ei_microphone_inference_wait(uint32_t timeout_ms, int64_t *ready_us);
 bool ei_microphone_inference_is_recording(void);
+uint32_t ei_microphone_inference_get_overruns(void);
+void ei_microphone_inference_set_slice_stats(bool enable);
+void ei_microphone_inference_get_slice_stats(float *rms, float *zcr);
+const int16_t *ei_microphone_inference_get_buffer(void);
 void ei_microphone_inference_reset_buffers(void);
 int ei_microphone_inference_get_data(size_t offset, size_t length, float *out_ptr);
 bool ei_microphone_inference_end(void);
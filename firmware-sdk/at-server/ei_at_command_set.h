@@ -87,9 +87,12 @@
 #define AT_RUNIMPULSEDEBUG_HELP_TEXT "Run the impulse with additional debug output or live preview"
 #define AT_RUNIMPULSECONT            "RUNIMPULSECONT"
 #define AT_RUNIMPULSECONT_HELP_TEXT  "Run the impulse continuously"
+#define AT_RUNIMPULSESCHED           "RUNIMPULSESCHED"
+#define AT_RUNIMPULSESCHED_ARGS      "PERIOD_MS,DEADLINE_MS,DEBUG"
+#define AT_RUNIMPULSESCHED_HELP_TEXT "Run the impulse on the newest window every PERIOD_MS (optional: DEADLINE_MS, 0 = period, DEBUG)"
 #define AT_RUNIMPULSESTATIC          "RUNIMPULSESTATIC"
-#define AT_RUNIMPULSESTATIC_ARGS     "DEBUG,LENGTH"
-#define AT_RUNIMPULSESTATIC_HELP_TEXT "Run the impulse on static data (base64 encoded)"
+#define AT_RUNIMPULSESTATIC_ARGS     "DEBUG,LENGTH,STRIDE,PER_SLICE"
+#define AT_RUNIMPULSESTATIC_HELP_TEXT "Run the impulse on static data (base64 encoded), data longer than a window is classified window by window STRIDE frames apart (optional, default slice size); PER_SLICE=y shares features between windows like continuous mode"
 #define AT_INGESTIONCYCLESETTINGS            "INGESTIONCYCLESETTINGS"
 #define AT_INGESTIONCYCLESETTINGS_ARGS       "SENSOR_LABEL,TOTAL_INGESTION_TIME_MS,INTERVAL_TIME_MS"
 #define AT_INGESTIONCYCLESETTINGS_HELP_TEXT  "Set ingestion cycle settings"
@@ -122,6 +125,8 @@
 #define AT_READRAW                  "READRAW"
 #define AT_READRAW_ARS              "START,LENGTH"
 #define AT_READRAW_HELP_TEXT        "Read raw from flash"
+#define AT_SAMPLETIMING             "SAMPLETIMING"
+#define AT_SAMPLETIMING_HELP_TEXT   "Interval statistics and sensor read times of the last sampling"
 #define AT_BOOTMODE                 "BOOTMODE"
 #define AT_BOOTMODE_HELP_TEXT       "Jump to bootloader"
 #define AT_INFO                     "INFO"
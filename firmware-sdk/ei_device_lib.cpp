@@ -46,6 +46,15 @@ extern "C" EI_IMPULSE_ERROR run_classifier(
     ei_impulse_result_t *result,
     bool debug = false);
 
+extern "C" EI_IMPULSE_ERROR run_classifier_batch(
+    signal_t *signal,
+    size_t stride,
+    ei_impulse_result_t *results,
+    size_t max_results,
+    size_t *results_count,
+    bool debug = false,
+    bool per_slice = false);
+
 float *features;
 extern ei_impulse_handle_t& ei_default_impulse;
 
@@ -108,7 +117,7 @@ __attribute__((weak)) bool read_encode_send_sample_buffer(size_t address, size_t
     return true;
 }
 
-bool run_impulse_static_data(bool debug, size_t length, size_t buf_len)
+bool run_impulse_static_data(bool debug, size_t length, size_t buf_len, size_t stride, bool per_slice)
 {
     size_t cur_pos = 0;
     uint32_t buf_pos = 0;
@@ -171,7 +180,7 @@ bool run_impulse_static_data(bool debug, size_t length, size_t buf_len)
     }
 
     ei_printf("TRANSFER COMPLETED %d\r\n", (int)cur_pos);
-    uint32_t res = (uint32_t)ei_start_impulse_static_data(debug, data_pt, cur_pos);
+    uint32_t res = (uint32_t)ei_start_impulse_static_data(debug, data_pt, cur_pos, stride, per_slice);
     cur_pos = 0;
     ei_free(data_pt);
     ei_free(temp_buf);
@@ -189,10 +198,70 @@ int raw_feature_get_data(size_t offset, size_t length, float *out_ptr)
     return 0;
 }
 
-EI_IMPULSE_ERROR ei_start_impulse_static_data(bool debug, float* data, size_t size) {
+/**
+ * @brief Classify every window of a recording longer than one window and
+ * print one line per window
+ */
+static EI_IMPULSE_ERROR ei_start_impulse_static_batch(bool debug, size_t size, size_t stride, bool per_slice)
+{
+    if (stride == 0) {
+        stride = EI_CLASSIFIER_SLICE_SIZE;
+    }
+
+    size_t frames = size / EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME;
+    size_t max_windows = (frames - EI_CLASSIFIER_RAW_SAMPLE_COUNT) / stride + 1;
+
+    ei_impulse_result_t *results = (ei_impulse_result_t*)ei_calloc(max_windows, sizeof(ei_impulse_result_t));
+    if (results == NULL) {
+        ei_printf("ERR: Memory allocation for %d results failed\r\n", (int)max_windows);
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+
+    signal_t signal;
+    signal.total_length = size;
+    signal.get_data = &raw_feature_get_data;
+
+    size_t count = 0;
+    uint64_t start_us = ei_read_timer_us();
+    EI_IMPULSE_ERROR res = run_classifier_batch(&signal, stride, results, max_windows, &count, debug, per_slice);
+    uint64_t batch_us = ei_read_timer_us() - start_us;
+
+    ei_printf("Batch: %d windows, stride %d%s, %.3f ms total, %.3f ms per window\r\n",
+            (int)count,
+            (int)stride,
+            per_slice ? " (per slice)" : "",
+            batch_us / 1000.f,
+            count > 0 ? batch_us / 1000.f / count : 0.f);
+
+    for (size_t ix = 0; ix < count; ix++) {
+        ei_printf("Window %d (offset %d):", (int)ix, (int)(ix * stride));
+#if EI_CLASSIFIER_OBJECT_DETECTION == 1
+        ei_printf(" %d bounding boxes", (int)results[ix].bounding_boxes_count);
+#else
+        for (uint16_t i = 0; i < EI_CLASSIFIER_LABEL_COUNT; i++) {
+            ei_printf(" %s: ", ei_default_impulse.impulse->categories[i]);
+            ei_printf_float(results[ix].classification[i].value);
+        }
+#endif
+#if EI_CLASSIFIER_HAS_ANOMALY == 1
+        ei_printf(" anomaly: ");
+        ei_printf_float(results[ix].anomaly);
+#endif
+        ei_printf("\r\n");
+    }
+
+    ei_free(results);
+    return res;
+}
+
+EI_IMPULSE_ERROR ei_start_impulse_static_data(bool debug, float* data, size_t size, size_t stride, bool per_slice) {
 
     features = data;
 
+    if (size > EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE) {
+        return ei_start_impulse_static_batch(debug, size, stride, per_slice);
+    }
+
     signal_t signal;            // Wrapper for raw input buffer
     ei_impulse_result_t result = {0}; // Used to store inference output
     EI_IMPULSE_ERROR res;       // Return code from inference
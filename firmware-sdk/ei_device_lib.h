@@ -58,8 +58,15 @@ bool ei_user_invoke_stop_lib(void);
  */
 bool read_encode_send_sample_buffer(size_t address, size_t length);
 
-bool run_impulse_static_data(bool debug, size_t length, size_t buf_len);
+/**
+ * @brief Receive raw data over the serial port and classify it. Data longer
+ * than one window is classified as a batch of windows, stride frames apart
+ * (0 selects EI_CLASSIFIER_SLICE_SIZE). Each window runs the full DSP unless
+ * per_slice is set, then overlapping windows share features like continuous
+ * mode (see run_classifier_batch()).
+ */
+bool run_impulse_static_data(bool debug, size_t length, size_t buf_len, size_t stride = 0, bool per_slice = false);
 
-EI_IMPULSE_ERROR ei_start_impulse_static_data(bool debug, float* data, size_t size);
+EI_IMPULSE_ERROR ei_start_impulse_static_data(bool debug, float* data, size_t size, size_t stride = 0, bool per_slice = false);
 
 #endif /* EI_DEVICE_LIB_H */
@@ -34,6 +34,7 @@
 
 /* Include ----------------------------------------------------------------- */
 #include "ei_fusion.h"
+#include "ei_fusion_resampler.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
 #include "ei_device_info_lib.h"
 #include "ei_sampler.h"
@@ -67,6 +68,10 @@ vector<fused_sensors_t> fused_sensors;
 */
 static vector<ei_device_fusion_sensor_t *> fusion_sensors;
 int num_fusions, num_fusion_axis;
+/*
+** @brief platform reader, sensors are read one by one from the sample thread if not set
+*/
+static ei_fusion_sensor_reader_t sensor_reader = nullptr;
 #if MULTI_FREQ_ENABLED == 1
 #define MULTI_FREQ_MAX_FREQ_NOT_SET     (-1.0f)
 
@@ -79,6 +84,19 @@ static float multi_freq_combination[NUM_MAX_FUSIONS][EI_MAX_FREQUENCIES];
 static fusion_sample_format_t* old_data;    // store old samples for multi
 #endif
 
+/** Sensor read at its own rate and resampled to the fusion frequency */
+typedef struct {
+    ei_device_fusion_sensor_t *sensor;
+    uint32_t divider;       // read on every divider-th base tick
+    uint8_t n_axes;         // number of used axes
+    EiFusionResampler resampler;
+} native_sensor_t;
+
+static vector<native_sensor_t> native_sensors;
+static vector<fusion_sample_format_t> native_frame;
+static uint32_t native_tick;
+static uint64_t native_out_ix;
+
 /* Private function prototypes --------------------------------------------- */
 static void print_fusion_list(int r, uint32_t ingest_memory_size);
 static void print_all_combinations(
@@ -174,6 +192,32 @@ bool ei_connect_fusion_list(const char *input_list, ei_fusion_list_format format
     return is_fusion;
 }
 
+/**
+ * @brief Install a platform specific sensor reader, nullptr restores the default
+ */
+void ei_fusion_set_sensor_reader(ei_fusion_sensor_reader_t reader)
+{
+    sensor_reader = reader;
+}
+
+/**
+ * @brief Read a set of sensors through the platform reader, or one after the other
+ */
+static void read_sensors(ei_device_fusion_sensor_t **sensors, fusion_sample_format_t **results, int count)
+{
+    if (sensor_reader != nullptr) {
+        sensor_reader(sensors, results, count);
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        results[i] = NULL;
+        if (sensors[i]->read_data != NULL) {
+            results[i] = sensors[i]->read_data(sensors[i]->num_axis); // read sensor data from sensor file
+        }
+    }
+}
+
 /**
  * @brief Get sensor data and extract needed sensors
  * Callback function writes data to mem
@@ -182,6 +226,7 @@ void ei_fusion_read_axis_data(void)
 {
     EiDeviceInfo* dev = EiDeviceInfo::get_device();
     fusion_sample_format_t *sensor_data;
+    fusion_sample_format_t *results[NUM_MAX_FUSIONS];
     fusion_sample_format_t *data;
     uint32_t loc = 0;
 
@@ -190,13 +235,11 @@ void ei_fusion_read_axis_data(void)
         return;
     }
 
+    read_sensors(fusion_sensors.data(), results, num_fusions);
+
     for (int i = 0; i < num_fusions; i++) {
 
-        sensor_data = NULL;
-        if (fusion_sensors[i]->read_data != NULL) {
-            sensor_data = fusion_sensors[i]->read_data(
-                fusion_sensors[i]->num_axis); // read sensor data from sensor file
-        }
+        sensor_data = results[i];
 
         if (sensor_data != NULL) {
             for (int j = 0; j < fusion_sensors[i]->num_axis; j++) {
@@ -342,6 +385,200 @@ bool ei_multi_fusion_sample_start(sampler_callback callsampler, float multi_samp
 }
 #endif
 
+/**
+ * @brief Pick the rate a sensor is read at: the lowest listed frequency that
+ * still covers the fusion frequency, or its fastest one if none does
+ */
+static float native_frequency(const ei_device_fusion_sensor_t *sensor, float out_hz)
+{
+    float native = 0.0f;
+    float highest = 0.0f;
+
+    for (int i = 0; i < EI_MAX_FREQUENCIES; i++) {
+        float freq = sensor->frequencies[i];
+
+        if (freq > highest) {
+            highest = freq;
+        }
+        if (freq >= out_hz && (native == 0.0f || freq < native)) {
+            native = freq;
+        }
+    }
+
+    return native != 0.0f ? native : highest;
+}
+
+/**
+ * @brief Base tick of native rate sampling. Reads the sensors that are due,
+ * then hands every fusion sample that all resamplers can produce to the
+ * sampler callback.
+ */
+static void ei_fusion_resampled_read_axis_data(void)
+{
+    EiDeviceInfo* dev = EiDeviceInfo::get_device();
+    float axes[EI_MAX_SENSOR_AXES];
+
+    ei_device_fusion_sensor_t *due[NUM_MAX_FUSIONS];
+    fusion_sample_format_t *results[NUM_MAX_FUSIONS];
+    int n_due = 0;
+
+    for (auto &ns : native_sensors) {
+        if (native_tick % ns.divider == 0) {
+            due[n_due++] = ns.sensor;
+        }
+    }
+
+    read_sensors(due, results, n_due);
+
+    n_due = 0;
+    for (auto &ns : native_sensors) {
+        if (native_tick % ns.divider != 0) {
+            continue;
+        }
+
+        fusion_sample_format_t *sensor_data = results[n_due++];
+
+        int loc = 0;
+        for (int j = 0; j < ns.sensor->num_axis; j++) {
+            if (ns.sensor->axis_flag_used & (1 << j)) {
+                axes[loc++] = (sensor_data != nullptr) ? (float)sensor_data[j] : 0.0f;
+            }
+        }
+        ns.resampler.push(axes);
+    }
+    native_tick++;
+
+    for (;;) {
+        for (auto &ns : native_sensors) {
+            if (ns.resampler.ready(native_out_ix) == false) {
+                return;
+            }
+        }
+
+        size_t loc = 0;
+        for (auto &ns : native_sensors) {
+            ns.resampler.get(native_out_ix, axes);
+            for (int j = 0; j < ns.n_axes; j++) {
+                native_frame[loc++] = (fusion_sample_format_t)axes[j];
+            }
+        }
+        native_out_ix++;
+
+        if (fusion_cb_sampler(
+                (const void *)native_frame.data(),
+                (sizeof(fusion_sample_format_t) * num_fusion_axis))) {
+            dev->stop_sample_thread(); // if last sample detach
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Like ei_fusion_sample_start, but every sensor is read at its own
+ * rate instead of all of them at sample_interval_ms. Slow sensors are not
+ * polled repeatedly and fast ones keep their bandwidth; a polyphase
+ * resampler per sensor aligns the streams to sample_interval_ms before they
+ * reach the callback. The output is delayed by the filter lookahead of the
+ * slowest sensor. Falls back to ei_fusion_sample_start when all sensors can
+ * simply be read at the fusion frequency.
+ *
+ * @param[in]  callsampler          callback receiving one fused sample
+ * @param[in]  sample_interval_ms   interval of the fused samples
+ *
+ * @retval  false if initialisation failed
+ */
+bool ei_fusion_resampled_sample_start(sampler_callback callsampler, float sample_interval_ms)
+{
+    EiDeviceInfo* dev = EiDeviceInfo::get_device();
+    const float out_hz = 1000.0f / sample_interval_ms;
+    float base_hz = 0.0f;
+    bool resample = false;
+
+    if (callsampler == nullptr || num_fusions == 0) {
+        return false;
+    }
+
+    native_sensors.clear();
+    native_sensors.resize(num_fusions);
+
+    for (int i = 0; i < num_fusions; i++) {
+        native_sensors[i].sensor = fusion_sensors[i];
+        float native_hz = native_frequency(fusion_sensors[i], out_hz);
+        if (native_hz > base_hz) {
+            base_hz = native_hz;
+        }
+    }
+
+    if (base_hz <= 0.0f) {
+        return false;
+    }
+
+    // slower sensors are read on a whole number of base ticks, rounded down
+    // so a sensor is never read slower than the rate it was picked for
+    float max_delay_s = 0.0f;
+    for (auto &ns : native_sensors) {
+        float native_hz = native_frequency(ns.sensor, out_hz);
+        ns.divider = (uint32_t)floorf(base_hz / native_hz + 0.001f);
+        if (ns.divider == 0) {
+            ns.divider = 1;
+        }
+
+        float in_hz = base_hz / ns.divider;
+        if (in_hz < native_hz * 0.999f) {
+            ei_printf("ERR: %s would be read at ", ns.sensor->name);
+            ei_printf_float(in_hz);
+            ei_printf(" Hz, below its ");
+            ei_printf_float(native_hz);
+            ei_printf(" Hz\n");
+            return false;
+        }
+        if (fabsf(in_hz - out_hz) > out_hz * 0.001f) {
+            resample = true;
+        }
+
+        ns.n_axes = 0;
+        for (int j = 0; j < ns.sensor->num_axis; j++) {
+            if (ns.sensor->axis_flag_used & (1 << j)) {
+                ns.n_axes++;
+            }
+        }
+
+        if (ns.resampler.init(in_hz, out_hz, ns.n_axes, 0) == false) {
+            return false;
+        }
+        float delay_s = (ns.resampler.lookahead() + 1) / in_hz;
+        if (delay_s > max_delay_s) {
+            max_delay_s = delay_s;
+        }
+    }
+
+    if (resample == false) {
+        native_sensors.clear();
+        return ei_fusion_sample_start(callsampler, sample_interval_ms);
+    }
+
+    // keep enough history for the faster sensors while the slowest one catches up
+    for (auto &ns : native_sensors) {
+        float in_hz = base_hz / ns.divider;
+        size_t history = (size_t)ceilf((max_delay_s + 1.0f / out_hz) * in_hz) + 2 * ns.resampler.lookahead() + 2;
+
+        if (ns.resampler.init(in_hz, out_hz, ns.n_axes, history) == false) {
+            return false;
+        }
+        ei_printf("%s read at ", ns.sensor->name);
+        ei_printf_float(in_hz);
+        ei_printf(" Hz, resampled %lu/%lu\n",
+            (unsigned long)ns.resampler.get_up(), (unsigned long)ns.resampler.get_down());
+    }
+
+    native_frame.assign(num_fusion_axis, 0);
+    native_tick = 0;
+    native_out_ix = 0;
+    fusion_cb_sampler = callsampler;
+
+    return dev->start_sample_thread(ei_fusion_resampled_read_axis_data, 1000.0f / base_hz);
+}
+
 /**
  * @brief      Create payload for sampling list, pad, start sampling
  */
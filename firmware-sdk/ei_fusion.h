@@ -69,6 +69,17 @@ typedef enum
 
 } ei_fusion_list_format;
 
+/** Bus a sensor is read over, sensors on different buses can be read in parallel */
+typedef enum
+{
+    EI_FUSION_BUS_NONE = 0,
+    EI_FUSION_BUS_I2C,
+    EI_FUSION_BUS_SPI,
+    EI_FUSION_BUS_ADC,
+    EI_FUSION_BUS_I2S
+
+} ei_fusion_bus_t;
+
 /**
  * Information about the fusion structure, name, number of axis, sampling frequencies, axis name, and reference to read sensor function
  */
@@ -85,8 +96,19 @@ typedef struct {
     fusion_sample_format_t *(*read_data)(int n_samples);
     // Axis used
     int axis_flag_used;
+    // Bus the sensor is read over (ei_fusion_bus_t), EI_FUSION_BUS_NONE if it shares none
+    int bus;
 } ei_device_fusion_sensor_t;
 
+/**
+ * Reads the sensors of one fusion sample, results[i] receives the data of
+ * sensors[i] or nullptr. Lets a platform read sensors from its own tasks.
+ */
+typedef void (*ei_fusion_sensor_reader_t)(
+    ei_device_fusion_sensor_t **sensors,
+    fusion_sample_format_t **results,
+    int count);
+
 typedef struct {
     std::string name;
     unsigned int max_sample_length;
@@ -113,6 +135,8 @@ bool ei_connect_fusion_list(const char *input_list, ei_fusion_list_format format
 void ei_fusion_read_axis_data(void);
 bool ei_fusion_sample_start(sampler_callback callsampler, float sample_interval_ms);
 bool ei_fusion_setup_data_sampling(void);
+bool ei_fusion_resampled_sample_start(sampler_callback callsampler, float sample_interval_ms);
+void ei_fusion_set_sensor_reader(ei_fusion_sensor_reader_t reader);
 #if MULTI_FREQ_ENABLED == 1
 bool ei_multi_fusion_sample_start(sampler_callback callsampler, float multi_sample_interval_ms);
 void ei_fusion_multi_read_axis_data(uint8_t flag_read);
@@ -0,0 +1,204 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* Include ----------------------------------------------------------------- */
+#include "ei_fusion_resampler.h"
+
+#include <math.h>
+
+/**
+ * @brief Express out_hz / in_hz as up / down, using the continued fraction
+ * of the ratio so rates like 62.5 Hz or 100 / 12 Hz come out exact. Ratios
+ * that need more than EI_FUSION_RESAMPLER_MAX_PHASES phases are approximated.
+ */
+void EiFusionResampler::calc_ratio(float in_hz, float out_hz, uint32_t *up, uint32_t *down)
+{
+    double ratio = (double)out_hz / (double)in_hz;
+    double x = ratio;
+    uint64_t h0 = 0, h1 = 1, k0 = 1, k1 = 0;
+
+    *up = (uint32_t)lround(ratio) > 0 ? (uint32_t)lround(ratio) : 1;
+    *down = (uint32_t)lround(ratio) > 0 ? 1 : (uint32_t)lround(1.0 / ratio);
+
+    for (int i = 0; i < 32; i++) {
+        double a = floor(x);
+        uint64_t h2 = (uint64_t)a * h1 + h0;
+        uint64_t k2 = (uint64_t)a * k1 + k0;
+
+        if (h2 > EI_FUSION_RESAMPLER_MAX_PHASES || k2 > UINT32_MAX) {
+            break;
+        }
+        if (h2 != 0) {
+            *up = (uint32_t)h2;
+            *down = (uint32_t)k2;
+        }
+
+        // float rates are only exact to ~7 digits
+        if (fabs((double)h2 / k2 - ratio) < ratio * 1e-6 || x - a < 1e-9) {
+            break;
+        }
+        x = 1.0 / (x - a);
+        h0 = h1; h1 = h2;
+        k0 = k1; k1 = k2;
+    }
+}
+
+/**
+ * @brief Windowed-sinc taps for one phase, normalized to unity gain
+ */
+void EiFusionResampler::calc_phase(uint32_t phase, float *h) const
+{
+    const float half = this->taps / 2.0f;
+    float sum = 0.0f;
+
+    for (int j = 0; j < this->taps; j++) {
+        // distance between input sample and the output instant, in input samples
+        float t = (float)(j - this->taps / 2 + 1) - (float)phase / (float)this->up;
+        float x = (float)M_PI * this->cutoff * t;
+        float sinc = (fabsf(x) < 1e-6f) ? 1.0f : sinf(x) / x;
+        float window = (fabsf(t) < half) ? 0.5f * (1.0f + cosf((float)M_PI * t / half)) : 0.0f;
+
+        h[j] = sinc * window;
+        sum += h[j];
+    }
+
+    for (int j = 0; j < this->taps; j++) {
+        h[j] /= sum;
+    }
+}
+
+/**
+ * @brief Build the filter bank and the input history
+ *
+ * @param history  input samples to keep per axis, must cover the time the
+ *                 outputs of this sensor wait for the slowest sensor
+ */
+bool EiFusionResampler::init(float in_hz, float out_hz, uint8_t n_axes, size_t history)
+{
+    calc_ratio(in_hz, out_hz, &this->up, &this->down);
+
+    // cut off at the lower Nyquist frequency, wider kernel when decimating
+    this->cutoff = 1.0f;
+    this->taps = EI_FUSION_RESAMPLER_TAPS;
+    if (this->down > this->up) {
+        this->cutoff = (float)this->up / (float)this->down;
+        this->taps = (int)ceilf(EI_FUSION_RESAMPLER_TAPS / this->cutoff);
+        this->taps += this->taps & 1;
+        if (this->taps > EI_FUSION_RESAMPLER_MAX_TAPS) {
+            this->taps = EI_FUSION_RESAMPLER_MAX_TAPS;
+        }
+    }
+
+    this->n_axes = n_axes;
+    this->history = history < (size_t)this->taps ? this->taps : history;
+    this->n_inputs = 0;
+
+    this->samples.assign(this->history * n_axes, 0.0f);
+    this->coeffs.clear();
+    if (this->samples.size() != this->history * n_axes) {
+        return false;
+    }
+
+    if (this->up * this->taps <= EI_FUSION_RESAMPLER_MAX_COEFFS) {
+        this->coeffs.assign(this->up * this->taps, 0.0f);
+        for (uint32_t p = 0; p < this->up; p++) {
+            calc_phase(p, &this->coeffs[p * this->taps]);
+        }
+    }
+
+    return true;
+}
+
+void EiFusionResampler::push(const float *values)
+{
+    float *slot = &this->samples[(this->n_inputs % this->history) * this->n_axes];
+
+    for (uint8_t i = 0; i < this->n_axes; i++) {
+        slot[i] = values[i];
+    }
+    this->n_inputs++;
+}
+
+/**
+ * @brief True once every input sample the filter needs for output out_ix is in
+ */
+bool EiFusionResampler::ready(uint64_t out_ix) const
+{
+    uint64_t base = out_ix * this->down / this->up;
+
+    return base + this->taps / 2 < this->n_inputs;
+}
+
+void EiFusionResampler::get(uint64_t out_ix, float *out) const
+{
+    uint64_t position = out_ix * this->down;
+    uint64_t base = position / this->up;
+    float phase_taps[EI_FUSION_RESAMPLER_MAX_TAPS];
+    const float *h;
+
+    if (this->coeffs.empty()) {
+        calc_phase(position % this->up, phase_taps);
+        h = phase_taps;
+    }
+    else {
+        h = &this->coeffs[(position % this->up) * this->taps];
+    }
+    // history that already fell out of the ring is replaced by the oldest kept sample
+    int64_t oldest = (int64_t)this->n_inputs - (int64_t)this->history;
+
+    if (oldest < 0) {
+        oldest = 0;
+    }
+
+    for (uint8_t i = 0; i < this->n_axes; i++) {
+        out[i] = 0.0f;
+    }
+
+    for (int j = 0; j < this->taps; j++) {
+        int64_t ix = (int64_t)base + j - this->taps / 2 + 1;
+
+        if (ix < oldest) {
+            ix = oldest;
+        }
+        if (ix >= (int64_t)this->n_inputs) {
+            ix = this->n_inputs - 1;
+        }
+
+        const float *slot = &this->samples[(ix % this->history) * this->n_axes];
+        for (uint8_t i = 0; i < this->n_axes; i++) {
+            out[i] += h[j] * slot[i];
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef EI_FUSION_RESAMPLER_H
+#define EI_FUSION_RESAMPLER_H
+
+/* Include ----------------------------------------------------------------- */
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/** Largest interpolation factor, rate ratios needing more are approximated */
+#ifndef EI_FUSION_RESAMPLER_MAX_PHASES
+#define EI_FUSION_RESAMPLER_MAX_PHASES      1000
+#endif
+/** Largest precomputed filter bank, bigger banks are evaluated per output */
+#ifndef EI_FUSION_RESAMPLER_MAX_COEFFS
+#define EI_FUSION_RESAMPLER_MAX_COEFFS      1024
+#endif
+/** Filter taps per phase when interpolating, scaled up by the ratio when decimating */
+#ifndef EI_FUSION_RESAMPLER_TAPS
+#define EI_FUSION_RESAMPLER_TAPS            4
+#endif
+#ifndef EI_FUSION_RESAMPLER_MAX_TAPS
+#define EI_FUSION_RESAMPLER_MAX_TAPS        64
+#endif
+
+/**
+ * @brief Streaming polyphase resampler for one multi-axis sensor.
+ *
+ * Converts a stream sampled at in_hz to out_hz by the rational factor
+ * up / down, using a bank of windowed-sinc filters (one per phase). The
+ * filter is centred on the output instant, so output n is aligned in time
+ * with input n * in_hz / out_hz and different sensors can be merged
+ * sample by sample without extra delay compensation.
+ */
+class EiFusionResampler {
+public:
+    static void calc_ratio(float in_hz, float out_hz, uint32_t *up, uint32_t *down);
+
+    bool init(float in_hz, float out_hz, uint8_t n_axes, size_t history);
+    void push(const float *values);
+    bool ready(uint64_t out_ix) const;
+    void get(uint64_t out_ix, float *out) const;
+
+    /** Number of input samples that have to follow an output instant */
+    int lookahead(void) const { return taps / 2; }
+    uint32_t get_up(void) const { return up; }
+    uint32_t get_down(void) const { return down; }
+
+private:
+    void calc_phase(uint32_t phase, float *h) const;
+
+    uint32_t up = 1;
+    uint32_t down = 1;
+    int taps = 0;
+    float cutoff = 1.0f;
+    uint8_t n_axes = 0;
+    size_t history = 0;
+    uint64_t n_inputs = 0;
+    std::vector<float> coeffs;
+    std::vector<float> samples;
+};
+
+#endif /* EI_FUSION_RESAMPLER_H */
@@ -468,6 +468,70 @@ int sensor_aq_add_data_batch(sensor_aq_ctx *ctx, int16_t values[], size_t values
     return sensor_aq_flush_buffer(ctx);
 }
 
+/**
+ * Add data to the sensor file for many intervals at the same time
+ * Values are interleaved frames (axis_count values per interval). The array
+ * header of a frame is the same for every frame, so it's written directly
+ * instead of opening / closing a QCBOR array per interval, and the whole block
+ * goes through a single flush (and signature update) unless the CBOR buffer fills up.
+ * @param ctx The context
+ * @param values Values, values_size / axis_count intervals
+ * @param values_size Size of the values array
+ */
+int sensor_aq_add_data_batch_f32(sensor_aq_ctx *ctx, const float values[], size_t values_size) {
+    if (ctx->axis_count == 0 || values_size % ctx->axis_count != 0) {
+        return AQ_VALUES_SIZE_DOES_NOT_MATCH_AXIS_COUNT;
+    }
+
+    if (ctx->stream == NULL) {
+        return AQ_STREAM_IS_NULL;
+    }
+
+    // CBOR array header for a frame, single axis frames are emitted flattened (see sensor_aq_add_data)
+    uint8_t row_header[2];
+    size_t row_header_size = 0;
+    if (ctx->axis_count >= 24) {
+        row_header[row_header_size++] = CBOR_MAJOR_TYPE_ARRAY << 5 | LEN_IS_ONE_BYTE;
+        row_header[row_header_size++] = (uint8_t)ctx->axis_count;
+    }
+    else if (ctx->axis_count > 1) {
+        row_header[row_header_size++] = (uint8_t)(CBOR_MAJOR_TYPE_ARRAY << 5 | ctx->axis_count);
+    }
+    UsefulBufC row_header_buf = { row_header, row_header_size };
+
+    // worst case a frame is the header plus a double (1 + 8 bytes) per axis
+    const size_t max_row_size = row_header_size + ctx->axis_count * 9;
+
+    if (max_row_size >= ctx->cbor_buffer.len) {
+        return AQ_OUT_OF_MEM;
+    }
+
+    // clear memory
+    memset(ctx->cbor_buffer.ptr, 0, ctx->cbor_buffer.len);
+
+    // re-initialize
+    QCBOREncode_Init(&ctx->encode_context, ctx->cbor_buffer);
+
+    for (size_t ix = 0; ix < values_size; ix += ctx->axis_count) {
+        if (ctx->encode_context.OutBuf.data_len + max_row_size > ctx->cbor_buffer.len) {
+            int fr = sensor_aq_flush_buffer(ctx);
+            if (fr != AQ_OK) {
+                return fr;
+            }
+        }
+
+        if (row_header_size > 0) {
+            UsefulOutBuf_AppendUsefulBuf(&ctx->encode_context.OutBuf, row_header_buf);
+        }
+
+        for (size_t axis = 0; axis < ctx->axis_count; axis++) {
+            QCBOREncode_AddDouble(&ctx->encode_context, values[ix + axis]);
+        }
+    }
+
+    return sensor_aq_flush_buffer(ctx);
+}
+
 int sensor_aq_finish(sensor_aq_ctx *ctx) {
     uint8_t final_byte[] = { 0xff };
 
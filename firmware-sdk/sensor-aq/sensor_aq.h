@@ -206,6 +206,7 @@ int sensor_aq_init(sensor_aq_ctx *ctx, sensor_aq_payload_info *payload_info, EI_
 int sensor_aq_add_data(sensor_aq_ctx *ctx, float values[], size_t values_size);
 int sensor_aq_add_data_i16(sensor_aq_ctx *ctx, int16_t values[], size_t values_size);
 int sensor_aq_add_data_batch(sensor_aq_ctx *ctx, int16_t values[], size_t values_size);
+int sensor_aq_add_data_batch_f32(sensor_aq_ctx *ctx, const float values[], size_t values_size);
 int sensor_aq_finish(sensor_aq_ctx *ctx);
 
 #endif /* EI_SENSOR_AQ_H */
@@ -47,6 +47,8 @@
 
 #include "ei_analogsensor.h"
 #include "ei_inertial_sensor.h"
+#include "ei_uploader_esp32.h"
+#include "ei_fusion_acquisition_esp32.h"
 
 #define RED_LED_PIN GPIO_NUM_21
 #define WHITE_LED_PIN GPIO_NUM_22
@@ -94,6 +96,19 @@ extern "C" int app_main()
         ei_printf("ADC sensor initialization failed\r\n");
     }
 
+    /* Fusion sampling reads sensors on different buses from their own tasks */
+    if (ei_fusion_acquisition_init() == false) {
+        ei_printf("Failed to start sensor acquisition tasks\r\n");
+    }
+
+    /* Samples recorded while offline are uploaded once WiFi connects */
+    if (dev->init_network() == false) {
+        ei_printf("WiFi initialization failed\r\n");
+    }
+    else if (ei_uploader_init() == false) {
+        ei_printf("Failed to start uploader\r\n");
+    }
+
     at = ei_at_init(dev);
     ei_printf("Type AT+HELP to see a list of commands.\r\n");
     at->print_prompt();
@@ -89,6 +89,8 @@ const ei_config_tflite_eon_graph_t ei_config_graph_44_13 = {
     .model_reset = &tflite_learn_44_13_reset,
     .model_input = &tflite_learn_44_13_input,
     .model_output = &tflite_learn_44_13_output,
+    .model_profile = &tflite_learn_44_13_profile,
+    .model_release = &tflite_learn_44_13_release,
 };
 
 const uint8_t ei_output_tensors_indices_44_13[1] = { 0 };
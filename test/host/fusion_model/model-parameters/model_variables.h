@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ *
+ * Generated by Edge Impulse and licensed under the applicable Edge Impulse
+ * Terms of Service. Community and Professional Terms of Service
+ * (https://edgeimpulse.com/legal/terms-of-service) or Enterprise Terms of
+ * Service (https://edgeimpulse.com/legal/enterprise-terms-of-service),
+ * according to your product plan subscription (the “License”).
+ *
+ * This software, documentation and other associated files (collectively referred
+ * to as the “Software”) is a single SDK variation generated by the Edge Impulse
+ * platform and requires an active paid Edge Impulse subscription to use this
+ * Software for any purpose.
+ *
+ * You may NOT use this Software unless you have an active Edge Impulse subscription
+ * that meets the eligibility requirements for the applicable License, subject to
+ * your full and continued compliance with the terms and conditions of the License,
+ * including without limitation any usage restrictions under the applicable License.
+ *
+ * If you do not have an active Edge Impulse product plan subscription, or if use
+ * of this Software exceeds the usage limitations of your Edge Impulse product plan
+ * subscription, you are not permitted to use this Software and must immediately
+ * delete and erase all copies of this Software within your control or possession.
+ * Edge Impulse reserves all rights and remedies available to enforce its rights.
+ *
+ * Unless required by applicable law or agreed to in writing, the Software is
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language governing
+ * permissions, disclaimers and limitations under the License.
+ */
+
+#ifndef _EI_CLASSIFIER_MODEL_VARIABLES_H_
+#define _EI_CLASSIFIER_MODEL_VARIABLES_H_
+
+/**
+ * @file
+ *  Impulse for the host tests of the fusion runner: a raw DSP block over
+ *  three accelerometer axes at 100 Hz and a learning block implemented by
+ *  the test (host_fusion_infer), so no model has to be compiled.
+ */
+
+#include <stdint.h>
+#include "model_metadata.h"
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "edge-impulse-sdk/classifier/inferencing_engines/engines.h"
+#include "edge-impulse-sdk/classifier/postprocessing/ei_postprocessing_common.h"
+
+/** Implemented by the test, fills result->classification from the features */
+EI_IMPULSE_ERROR host_fusion_infer(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config, bool debug);
+
+const char* ei_classifier_inferencing_categories_1_1[] = { "idle", "shake" };
+
+EI_CLASSIFIER_DSP_AXES_INDEX_TYPE ei_dsp_config_1_2_axes[] = { 0, 1, 2 };
+const uint32_t ei_dsp_config_1_2_axes_size = 3;
+ei_dsp_config_raw_t ei_dsp_config_1_2 = {
+    2, // uint32_t blockId
+    1, // int implementationVersion
+    3, // int length of axes
+    1.0f // float scale_axes
+};
+
+const uint8_t ei_dsp_blocks_1_1_size = 1;
+ei_model_dsp_t ei_dsp_blocks_1_1[ei_dsp_blocks_1_1_size] = {
+    { // DSP block 2
+        2,
+        300, // output size
+        &extract_raw_features, // DSP function pointer
+        (void*)&ei_dsp_config_1_2, // pointer to config struct
+        ei_dsp_config_1_2_axes, // array of offsets into the input stream, one for each axis
+        ei_dsp_config_1_2_axes_size, // number of axes
+        1, // version
+        nullptr, // factory function
+        nullptr, // data normalization config
+    }
+};
+
+const uint8_t ei_learning_blocks_1_1_size = 1;
+const uint32_t ei_learning_block_1_3_inputs[1] = { 2 };
+const uint8_t ei_learning_block_1_3_inputs_size = 1;
+const ei_learning_block_t ei_learning_blocks_1_1[ei_learning_blocks_1_1_size] = {
+    {
+        3,
+        &host_fusion_infer,
+        nullptr,
+        EI_CLASSIFIER_IMAGE_SCALING_NONE,
+        ei_learning_block_1_3_inputs,
+        ei_learning_block_1_3_inputs_size,
+    },
+};
+
+const size_t ei_postprocessing_blocks_1_1_size = 0;
+const ei_postprocessing_block_t *ei_postprocessing_blocks_1_1 = nullptr;
+
+const uint8_t freeform_outputs_1_1_size = 0;
+
+uint32_t *freeform_outputs_1_1 = nullptr;
+
+const ei_impulse_t impulse_1_1 = {
+    .project_id = 1,
+    .project_owner = "Host tests",
+    .project_name = "Host test: fusion",
+    .impulse_id = 1,
+    .impulse_name = "Impulse #1",
+    .deploy_version = 1,
+
+    .nn_input_frame_size = 300,
+    .raw_sample_count = 100,
+    .raw_samples_per_frame = 3,
+    .dsp_input_frame_size = 100 * 3,
+    .input_width = 0,
+    .input_height = 0,
+    .input_frames = 0,
+    .interval_ms = 10,
+    .frequency = 100,
+
+    .dsp_blocks_size = ei_dsp_blocks_1_1_size,
+    .dsp_blocks = ei_dsp_blocks_1_1,
+
+    .learning_blocks_size = ei_learning_blocks_1_1_size,
+    .learning_blocks = ei_learning_blocks_1_1,
+
+    .postprocessing_blocks_size = ei_postprocessing_blocks_1_1_size,
+    .postprocessing_blocks = ei_postprocessing_blocks_1_1,
+
+    .output_tensors_size = 1,
+
+    .inferencing_engine = EI_CLASSIFIER_NONE,
+
+    .sensor = EI_CLASSIFIER_SENSOR_FUSION,
+    .fusion_string = "accX + accY + accZ",
+    .slice_size = (100/4),
+    .slices_per_model_window = 4,
+
+    .has_anomaly = EI_ANOMALY_TYPE_UNKNOWN,
+    .label_count = 2,
+    .categories = ei_classifier_inferencing_categories_1_1,
+    .results_type = EI_CLASSIFIER_TYPE_CLASSIFICATION,
+    .freeform_outputs_size = freeform_outputs_1_1_size,
+    .freeform_outputs = freeform_outputs_1_1
+};
+
+ei_impulse_handle_t impulse_handle_1_1 = ei_impulse_handle_t( &impulse_1_1 );
+
+ei_impulse_handle_t& ei_default_impulse = impulse_handle_1_1;
+constexpr auto& ei_classifier_inferencing_categories = ei_classifier_inferencing_categories_1_1;
+const auto ei_dsp_blocks_size = ei_dsp_blocks_1_1_size;
+ei_model_dsp_t *ei_dsp_blocks = ei_dsp_blocks_1_1;
+#endif // _EI_CLASSIFIER_MODEL_VARIABLES_H_
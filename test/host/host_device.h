@@ -0,0 +1,117 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EI_HOST_DEVICE_H
+#define EI_HOST_DEVICE_H
+
+/* Include ----------------------------------------------------------------- */
+#include "firmware-sdk/ei_device_info_lib.h"
+#include "firmware-sdk/ei_device_memory.h"
+#include <vector>
+
+/**
+ * @brief RAM backed sample memory with NOR flash semantics: erase sets
+ * bytes to 0xFF and a write can only clear bits, the same as the
+ * ESP32 data partition
+ */
+class EiHostFlash : public EiDeviceMemory {
+protected:
+    std::vector<uint8_t> flash;
+
+    uint32_t read_data(uint8_t *data, uint32_t address, uint32_t num_bytes) override
+    {
+        if (address + num_bytes > flash.size()) {
+            return 0;
+        }
+        memcpy(data, &flash[address], num_bytes);
+        return num_bytes;
+    }
+
+    uint32_t write_data(const uint8_t *data, uint32_t address, uint32_t num_bytes) override
+    {
+        if (address + num_bytes > flash.size()) {
+            return 0;
+        }
+        for (uint32_t ix = 0; ix < num_bytes; ix++) {
+            flash[address + ix] &= data[ix];
+        }
+        return num_bytes;
+    }
+
+    uint32_t erase_data(uint32_t address, uint32_t num_bytes) override
+    {
+        uint32_t start = address - (address % block_size);
+        uint32_t end = ((address + num_bytes + block_size - 1) / block_size) * block_size;
+
+        if (end > flash.size()) {
+            return 0;
+        }
+        memset(&flash[start], 0xff, end - start);
+        return num_bytes;
+    }
+
+public:
+    /** Sample data as it was when finalize_samplig() was called */
+    std::vector<uint8_t> finalized;
+    int finalize_count = 0;
+
+    EiHostFlash(uint32_t memory_size, uint32_t block_size = 4096)
+        : EiDeviceMemory(0, 45, memory_size, block_size)
+        , flash(memory_size, 0xff)
+    {
+    }
+
+    void finalize_samplig(void) override
+    {
+        finalized.assign(flash.begin() + used_blocks * block_size, flash.end());
+        finalize_count++;
+    }
+};
+
+/**
+ * @brief Device returned by EiDeviceInfo::get_device() in the host tests
+ */
+class EiHostDevice : public EiDeviceInfo {
+public:
+    EiHostDevice(EiDeviceMemory *mem)
+    {
+        memory = mem;
+    }
+
+    void init_device_id(void) override
+    {
+    }
+};
+
+#endif /* EI_HOST_DEVICE_H */
@@ -0,0 +1,198 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "esp_adc/adc_continuous.h"
+#include "esp_timer.h"
+
+#include <math.h>
+#include <mutex>
+#include <thread>
+
+struct ei_host_adc_continuous {
+    uint32_t pool_entries;
+    uint32_t rate_hz = 0;
+    uint8_t channel = 0;
+    bool configured = false;
+    bool started = false;
+    int64_t start_us = 0;
+    /** Conversions made since start, including the ones the full pool lost */
+    uint64_t produced = 0;
+};
+
+static std::mutex adc_mutex;
+static uint32_t live_handles = 0;
+static uint32_t created_handles = 0;
+
+static uint16_t default_signal(uint64_t n, uint32_t rate_hz)
+{
+    float t = (float)(n % rate_hz) / rate_hz;
+
+    return (uint16_t)(2048.0f + 1500.0f * sinf(2.0f * (float)M_PI * 50.0f * t)
+        + 300.0f * sinf(2.0f * (float)M_PI * 1000.0f * t));
+}
+
+static esp_adc_host_signal_t signal_fn = default_signal;
+
+esp_err_t adc_continuous_new_handle(const adc_continuous_handle_cfg_t *hdl_config, adc_continuous_handle_t *ret_handle)
+{
+    std::lock_guard<std::mutex> lock(adc_mutex);
+
+    // there is one digital controller, and on the ESP32 it takes I2S0
+    if (live_handles != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ei_host_adc_continuous *handle = new ei_host_adc_continuous();
+    handle->pool_entries = hdl_config->max_store_buf_size / SOC_ADC_DIGI_RESULT_BYTES;
+    live_handles++;
+    created_handles++;
+    *ret_handle = handle;
+
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_config(adc_continuous_handle_t handle, const adc_continuous_config_t *config)
+{
+    if (handle->started || config->pattern_num != 1) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    handle->rate_hz = config->sample_freq_hz;
+    handle->channel = config->adc_pattern[0].channel;
+    handle->configured = true;
+
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_start(adc_continuous_handle_t handle)
+{
+    if (!handle->configured || handle->started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    handle->started = true;
+    handle->start_us = esp_timer_get_time();
+    handle->produced = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_stop(adc_continuous_handle_t handle)
+{
+    if (!handle->started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    handle->started = false;
+
+    return ESP_OK;
+}
+
+/**
+ * Waits until length_max bytes of conversions are due or the timeout
+ * passed, conversions beyond the pool size are lost as on the target
+ */
+esp_err_t adc_continuous_read(adc_continuous_handle_t handle, uint8_t *buf, uint32_t length_max, uint32_t *out_length, uint32_t timeout_ms)
+{
+    const uint64_t wanted = length_max / SOC_ADC_DIGI_RESULT_BYTES;
+    const int64_t until = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    uint64_t due;
+
+    if (!handle->started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    for (;;) {
+        int64_t now = esp_timer_get_time();
+
+        due = (uint64_t)(now - handle->start_us) * handle->rate_hz / 1000000 - handle->produced;
+        if (due >= wanted || now >= until) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+
+    if (due > handle->pool_entries) {
+        handle->produced += due - handle->pool_entries;
+        due = handle->pool_entries;
+    }
+    if (due == 0) {
+        *out_length = 0;
+        return ESP_ERR_TIMEOUT;
+    }
+    if (due > wanted) {
+        due = wanted;
+    }
+
+    for (uint64_t i = 0; i < due; i++) {
+        adc_digi_output_data_t *p = (adc_digi_output_data_t *)&buf[i * SOC_ADC_DIGI_RESULT_BYTES];
+        p->type1.data = signal_fn(handle->produced++, handle->rate_hz) & 0xfff;
+        p->type1.channel = handle->channel;
+    }
+    *out_length = due * SOC_ADC_DIGI_RESULT_BYTES;
+
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_deinit(adc_continuous_handle_t handle)
+{
+    std::lock_guard<std::mutex> lock(adc_mutex);
+
+    if (handle == NULL || handle->started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    delete handle;
+    live_handles--;
+
+    return ESP_OK;
+}
+
+void esp_adc_host_set_signal(esp_adc_host_signal_t signal)
+{
+    signal_fn = signal ? signal : default_signal;
+}
+
+uint32_t esp_adc_host_live_handles(void)
+{
+    std::lock_guard<std::mutex> lock(adc_mutex);
+    return live_handles;
+}
+
+uint32_t esp_adc_host_created_handles(void)
+{
+    std::lock_guard<std::mutex> lock(adc_mutex);
+    return created_handles;
+}
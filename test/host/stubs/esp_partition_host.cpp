@@ -0,0 +1,170 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "esp_partition.h"
+#include "esp_spi_flash.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    esp_partition_t partition;
+    FILE *file;
+} host_partition_t;
+
+/* Private variables ------------------------------------------------------- */
+static std::vector<host_partition_t *> partitions;
+static uint64_t read_bytes = 0;
+static uint32_t read_calls = 0;
+
+static FILE *partition_file(const esp_partition_t *partition)
+{
+    for (auto p : partitions) {
+        if (&p->partition == partition) {
+            return p->file;
+        }
+    }
+    return NULL;
+}
+
+static bool in_range(const esp_partition_t *partition, size_t offset, size_t size)
+{
+    return partition != NULL && offset <= partition->size && size <= partition->size - offset;
+}
+
+/* Public functions -------------------------------------------------------- */
+const esp_partition_t *esp_partition_host_add(const char *label, const char *path, uint32_t size)
+{
+    FILE *file = fopen(path, "r+b");
+    long file_size = -1;
+
+    if (file) {
+        fseek(file, 0, SEEK_END);
+        file_size = ftell(file);
+    }
+
+    if (file == NULL || file_size != (long)size) {
+        std::vector<uint8_t> erased(size, 0xff);
+
+        if (file) {
+            fclose(file);
+        }
+        file = fopen(path, "w+b");
+        if (file == NULL || fwrite(erased.data(), 1, size, file) != size) {
+            return NULL;
+        }
+    }
+
+    host_partition_t *p = new host_partition_t();
+    p->partition.type = ESP_PARTITION_TYPE_DATA;
+    p->partition.subtype = ESP_PARTITION_SUBTYPE_ANY;
+    p->partition.address = 0x110000;
+    p->partition.size = size;
+    p->partition.erase_size = SPI_FLASH_SEC_SIZE;
+    strncpy(p->partition.label, label, sizeof(p->partition.label) - 1);
+    p->file = file;
+    partitions.push_back(p);
+
+    return &p->partition;
+}
+
+void esp_partition_host_read_stats(uint64_t *bytes, uint32_t *calls)
+{
+    *bytes = read_bytes;
+    *calls = read_calls;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label)
+{
+    for (auto p : partitions) {
+        if (p->partition.type == type && (label == NULL || strcmp(p->partition.label, label) == 0)) {
+            return &p->partition;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    FILE *file = partition_file(partition);
+
+    if (file == NULL || !in_range(partition, src_offset, size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    read_bytes += size;
+    read_calls++;
+
+    fseek(file, src_offset, SEEK_SET);
+    return fread(dst, 1, size, file) == size ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size)
+{
+    FILE *file = partition_file(partition);
+    std::vector<uint8_t> data(size);
+
+    if (file == NULL || !in_range(partition, dst_offset, size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // NOR flash, bits can only be cleared
+    fseek(file, dst_offset, SEEK_SET);
+    if (fread(data.data(), 1, size, file) != size) {
+        return ESP_FAIL;
+    }
+    for (size_t ix = 0; ix < size; ix++) {
+        data[ix] &= ((const uint8_t *)src)[ix];
+    }
+
+    fseek(file, dst_offset, SEEK_SET);
+    return fwrite(data.data(), 1, size, file) == size ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size)
+{
+    FILE *file = partition_file(partition);
+
+    if (file == NULL || !in_range(partition, offset, size)
+        || offset % SPI_FLASH_SEC_SIZE != 0 || size % SPI_FLASH_SEC_SIZE != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    std::vector<uint8_t> erased(size, 0xff);
+    fseek(file, offset, SEEK_SET);
+    return fwrite(erased.data(), 1, size, file) == size ? ESP_OK : ESP_FAIL;
+}
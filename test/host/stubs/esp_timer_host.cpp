@@ -0,0 +1,162 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "esp_timer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+typedef std::chrono::steady_clock host_clock;
+
+/**
+ * Every timer has its own thread that sleeps until the next deadline on the
+ * monotonic clock. Like esp_timer, a periodic timer is rescheduled from its
+ * previous deadline, so a late callback delays the next one but not the rate.
+ */
+struct ei_host_esp_timer {
+    esp_timer_create_args_t args;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread thread;
+    bool running = false;
+    bool deleted = false;
+    /** Bumped on every start and stop so a sleeping thread notices */
+    uint32_t generation = 0;
+    host_clock::duration period;
+    host_clock::time_point deadline;
+};
+
+static const host_clock::time_point boot_time = host_clock::now();
+
+static void timer_thread(ei_host_esp_timer *timer)
+{
+    std::unique_lock<std::mutex> lock(timer->mutex);
+
+    while (!timer->deleted) {
+        if (!timer->running) {
+            timer->changed.wait(lock);
+            continue;
+        }
+
+        uint32_t generation = timer->generation;
+        if (timer->changed.wait_until(lock, timer->deadline, [timer, generation] {
+                return timer->generation != generation || timer->deleted;
+            })) {
+            continue;
+        }
+
+        timer->deadline += timer->period;
+        if (timer->args.skip_unhandled_events) {
+            while (timer->deadline <= host_clock::now()) {
+                timer->deadline += timer->period;
+            }
+        }
+
+        lock.unlock();
+        timer->args.callback(timer->args.arg);
+        lock.lock();
+    }
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(host_clock::now() - boot_time).count();
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ei_host_esp_timer *timer = new ei_host_esp_timer();
+    timer->args = *create_args;
+    timer->thread = std::thread(timer_thread, timer);
+    *out_handle = timer;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    std::lock_guard<std::mutex> lock(timer->mutex);
+
+    if (timer->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    timer->period = std::chrono::microseconds(period);
+    timer->deadline = host_clock::now() + timer->period;
+    timer->running = true;
+    timer->generation++;
+    timer->changed.notify_all();
+
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    std::lock_guard<std::mutex> lock(timer->mutex);
+
+    if (!timer->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    timer->running = false;
+    timer->generation++;
+    timer->changed.notify_all();
+
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    {
+        std::lock_guard<std::mutex> lock(timer->mutex);
+
+        if (timer->running) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        timer->deleted = true;
+        timer->changed.notify_all();
+    }
+
+    timer->thread.join();
+    delete timer;
+
+    return ESP_OK;
+}
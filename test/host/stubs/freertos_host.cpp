@@ -0,0 +1,213 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct ei_host_semaphore {
+    std::timed_mutex mutex;
+};
+
+struct ei_host_event_group {
+    std::mutex mutex;
+    std::condition_variable changed;
+    EventBits_t bits = 0;
+};
+
+/** The thread is detached, the handle only carries the notification value */
+struct ei_host_task {
+    std::mutex mutex;
+    std::condition_variable notified;
+    uint32_t notification = 0;
+};
+
+/** Handle of the task running on this thread, NULL for threads not created by xTaskCreate */
+static thread_local ei_host_task *current_task = NULL;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return new ei_host_semaphore();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    if (ticks_to_wait == portMAX_DELAY) {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+
+    return semaphore->mutex.try_lock_for(std::chrono::milliseconds(ticks_to_wait * portTICK_PERIOD_MS)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    semaphore->mutex.unlock();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    delete semaphore;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char *name, uint32_t stack_depth, void *parameters, UBaseType_t priority, TaskHandle_t *created_task)
+{
+    ei_host_task *handle = new ei_host_task();
+    std::thread thread([handle, task, parameters] {
+        current_task = handle;
+        task(parameters);
+    });
+
+    if (created_task) {
+        *created_task = handle;
+    }
+    thread.detach();
+
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stack_depth, void *parameters, UBaseType_t priority, TaskHandle_t *created_task, BaseType_t core_id)
+{
+    return xTaskCreate(task, name, stack_depth, parameters, priority, created_task);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    static const auto start = std::chrono::steady_clock::now();
+
+    return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() / portTICK_PERIOD_MS;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    std::lock_guard<std::mutex> lock(task->mutex);
+
+    task->notification++;
+    task->notified.notify_one();
+
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    ei_host_task *task = current_task;
+    std::unique_lock<std::mutex> lock(task->mutex);
+    auto has_notification = [task] { return task->notification != 0; };
+
+    if (ticks_to_wait == portMAX_DELAY) {
+        task->notified.wait(lock, has_notification);
+    }
+    else if (!task->notified.wait_for(lock, std::chrono::milliseconds(ticks_to_wait * portTICK_PERIOD_MS), has_notification)) {
+        return 0;
+    }
+
+    uint32_t value = task->notification;
+    task->notification = clear_on_exit ? 0 : value - 1;
+
+    return value;
+}
+
+uint32_t ulTaskNotifyValueClear(TaskHandle_t task, uint32_t bits_to_clear)
+{
+    std::lock_guard<std::mutex> lock(task->mutex);
+    uint32_t value = task->notification;
+
+    task->notification &= ~bits_to_clear;
+
+    return value;
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return new ei_host_event_group();
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    std::lock_guard<std::mutex> lock(group->mutex);
+
+    group->bits |= bits;
+    group->changed.notify_all();
+
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    std::lock_guard<std::mutex> lock(group->mutex);
+    EventBits_t value = group->bits;
+
+    group->bits &= ~bits;
+
+    return value;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit, BaseType_t wait_for_all, TickType_t ticks_to_wait)
+{
+    std::unique_lock<std::mutex> lock(group->mutex);
+    auto satisfied = [group, bits, wait_for_all] {
+        return wait_for_all ? (group->bits & bits) == bits : (group->bits & bits) != 0;
+    };
+
+    if (ticks_to_wait == portMAX_DELAY) {
+        group->changed.wait(lock, satisfied);
+    }
+    else {
+        group->changed.wait_for(lock, std::chrono::milliseconds(ticks_to_wait * portTICK_PERIOD_MS), satisfied);
+    }
+
+    EventBits_t value = group->bits;
+    if (clear_on_exit && satisfied()) {
+        group->bits &= ~bits;
+    }
+
+    return value;
+}
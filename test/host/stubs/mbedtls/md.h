@@ -0,0 +1,115 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Host stand-in for the Mbed TLS message digest API used by
+ * sensor_aq_mbedtls_hs256.cpp, HMAC SHA256 only, backed by OpenSSL
+ */
+#ifndef EI_HOST_MBEDTLS_MD_H
+#define EI_HOST_MBEDTLS_MD_H
+
+#include <stddef.h>
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
+
+typedef enum {
+    MBEDTLS_MD_NONE = 0,
+    MBEDTLS_MD_SHA256 = 6,
+} mbedtls_md_type_t;
+
+typedef struct {
+    mbedtls_md_type_t type;
+} mbedtls_md_info_t;
+
+typedef struct {
+    EVP_MAC *mac;
+    EVP_MAC_CTX *ctx;
+} mbedtls_md_context_t;
+
+static inline const mbedtls_md_info_t *mbedtls_md_info_from_type(mbedtls_md_type_t type)
+{
+    static const mbedtls_md_info_t sha256 = { MBEDTLS_MD_SHA256 };
+
+    return type == MBEDTLS_MD_SHA256 ? &sha256 : NULL;
+}
+
+static inline void mbedtls_md_init(mbedtls_md_context_t *ctx)
+{
+    ctx->mac = NULL;
+    ctx->ctx = NULL;
+}
+
+static inline int mbedtls_md_setup(mbedtls_md_context_t *ctx, const mbedtls_md_info_t *info, int hmac)
+{
+    if (info == NULL || hmac == 0) {
+        return -1;
+    }
+
+    ctx->mac = EVP_MAC_fetch(NULL, "HMAC", NULL);
+    ctx->ctx = ctx->mac ? EVP_MAC_CTX_new(ctx->mac) : NULL;
+
+    return ctx->ctx ? 0 : -1;
+}
+
+static inline int mbedtls_md_hmac_starts(mbedtls_md_context_t *ctx, const unsigned char *key, size_t keylen)
+{
+    char digest[] = "SHA256";
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+        OSSL_PARAM_construct_end()
+    };
+
+    return EVP_MAC_init(ctx->ctx, key, keylen, params) == 1 ? 0 : -1;
+}
+
+static inline int mbedtls_md_hmac_update(mbedtls_md_context_t *ctx, const unsigned char *input, size_t ilen)
+{
+    return EVP_MAC_update(ctx->ctx, input, ilen) == 1 ? 0 : -1;
+}
+
+static inline int mbedtls_md_hmac_finish(mbedtls_md_context_t *ctx, unsigned char *output)
+{
+    size_t out_len = 0;
+
+    return EVP_MAC_final(ctx->ctx, output, &out_len, 32) == 1 ? 0 : -1;
+}
+
+static inline void mbedtls_md_free(mbedtls_md_context_t *ctx)
+{
+    EVP_MAC_CTX_free(ctx->ctx);
+    EVP_MAC_free(ctx->mac);
+    mbedtls_md_init(ctx);
+}
+
+#endif /* EI_HOST_MBEDTLS_MD_H */
@@ -0,0 +1,159 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * ADC sensor on the host ADC driver stand-in. The acquisition task, the ring
+ * and the fusion read are the firmware code; the driver synthesizes the
+ * conversions. Checks that the averaged reads follow the waveform and
+ * that the driver handle, which holds I2S0 on the ESP32, only exists while
+ * someone reads.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "ei_analogsensor.h"
+
+#include "esp_adc/adc_continuous.h"
+#include "esp_timer.h"
+
+#include <chrono>
+#include <math.h>
+#include <thread>
+#include <vector>
+
+/* Constants --------------------------------------------------------------- */
+/** Longer than the idle timeout of the acquisition task */
+#define TEST_IDLE_MS        800
+#define TEST_LEVEL          1000
+/** Frames of conversions the acquisition task takes from the driver, 12.8 ms */
+#define TEST_FRAME_MS       13
+
+/* Private functions ------------------------------------------------------- */
+
+bool ei_add_sensor_to_fusion_list(ei_device_fusion_sensor_t sensor)
+{
+    return true;
+}
+
+/**
+ * @brief 2 Hz tone of 1500 counts with 300 counts of 1 kHz on top, which
+ * the averaging over a read period has to remove
+ */
+static uint16_t tone_signal(uint64_t n, uint32_t rate_hz)
+{
+    float t = (float)(n % rate_hz) / rate_hz;
+
+    return (uint16_t)(2048.0f + 1500.0f * sinf(2.0f * (float)M_PI * 2.0f * t)
+        + 300.0f * sinf(2.0f * (float)M_PI * 1000.0f * t));
+}
+
+static uint16_t level_signal(uint64_t n, uint32_t rate_hz)
+{
+    return TEST_LEVEL;
+}
+
+static void sleep_ms(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+/**
+ * @brief Read the sensor like the fusion timer does, every period_ms
+ */
+static std::vector<float> read_for(uint32_t period_ms, uint32_t duration_ms)
+{
+    std::vector<float> values;
+    int64_t until = esp_timer_get_time() + (int64_t)duration_ms * 1000;
+
+    while (esp_timer_get_time() < until) {
+        values.push_back(ei_fusion_analog_sensor_read_data(ANALOG_AXIS_SAMPLED)[0]);
+        sleep_ms(period_ms);
+    }
+
+    return values;
+}
+
+int main(int argc, char **argv)
+{
+    esp_adc_host_set_signal(tone_signal);
+
+    EI_HOST_CHECK(ei_analog_sensor_init(), "init failed");
+    sleep_ms(50);
+    EI_HOST_CHECK(esp_adc_host_live_handles() == 0, "ADC driver set up before the first read");
+
+    // 100 Hz reads, one frame or none per read
+    ei_fusion_analog_sensor_read_data(ANALOG_AXIS_SAMPLED);
+    sleep_ms(2 * TEST_FRAME_MS);
+    uint32_t overruns = ei_analog_sensor_get_overruns();
+    std::vector<float> values = read_for(10, 1100);
+    EI_HOST_CHECK(esp_adc_host_live_handles() == 1, "no ADC driver while reading");
+    EI_HOST_CHECK(ei_analog_sensor_get_overruns() == overruns, "%u conversions lost while reading",
+        ei_analog_sensor_get_overruns() - overruns);
+
+    float min = 4096.0f, max = 0.0f, max_step = 0.0f;
+    uint32_t rising = 0;
+    for (size_t ix = 1; ix < values.size(); ix++) {
+        float step = fabsf(values[ix] - values[ix - 1]);
+        min = values[ix] < min ? values[ix] : min;
+        max = values[ix] > max ? values[ix] : max;
+        max_step = step > max_step ? step : max_step;
+        if (values[ix - 1] < 2048.0f && values[ix] >= 2048.0f) {
+            rising++;
+        }
+    }
+    printf("%zu reads, %.0f..%.0f, largest step %.0f, %u rising crossings\n", values.size(), min, max, max_step, rising);
+    EI_HOST_CHECK(fabsf(max - 3548.0f) < 80.0f && fabsf(min - 548.0f) < 80.0f, "reads range %.0f..%.0f", min, max);
+    // the 2 Hz tone moves at most ~250 counts per frame, the 1 kHz one is averaged out
+    EI_HOST_CHECK(max_step < 550.0f, "reads jump by %.0f", max_step);
+    EI_HOST_CHECK(rising >= 1 && rising <= 3, "%u periods of the 2 Hz tone in 1.1 s", rising);
+
+    // no reader, the driver is released for the camera
+    sleep_ms(TEST_IDLE_MS);
+    EI_HOST_CHECK(esp_adc_host_live_handles() == 0, "ADC driver kept after reads stopped");
+
+    // the next session sets the driver up again and drops what the ring held,
+    // reads before its first frame hold the previous value
+    esp_adc_host_set_signal(level_signal);
+    values = read_for(5, 150);
+    EI_HOST_CHECK(esp_adc_host_created_handles() == 2, "%u ADC drivers created for two sessions", esp_adc_host_created_handles());
+    EI_HOST_CHECK(esp_adc_host_live_handles() == 1, "no ADC driver in the second session");
+    for (size_t ix = values.size() / 2; ix < values.size(); ix++) {
+        EI_HOST_CHECK(values[ix] == TEST_LEVEL, "read %zu of the second session is %.0f", ix, values[ix]);
+    }
+
+    sleep_ms(TEST_IDLE_MS);
+    EI_HOST_CHECK(esp_adc_host_live_handles() == 0, "ADC driver kept after the second session");
+
+    return ei_host_test_result("test_analog_sensor");
+}
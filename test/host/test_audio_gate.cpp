@@ -0,0 +1,189 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Silence gate of continuous keyword spotting on a recording, data/gate_speech.wav:
+ * 16 kHz mono, quiet room noise with a voiced word at 1.5 .. 2.5 s and a
+ * quiet fricative at 4.0 .. 4.5 s. The slices are measured in I2S sized
+ * chunks like the capture task does. Checks that the speech slices are
+ * classified, the fricative opens the gate through its zero crossing rate,
+ * and the silence after the hangover is skipped.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "ei_audio_gate.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_FREQUENCY      16000
+/** Slice of the 1 s KWS window in 4 slices */
+#define TEST_SLICE          4000
+#define TEST_SLICES_PER_WINDOW  4
+/** Samples per I2S read of the capture task */
+#define TEST_CHUNK          512
+
+/** Slices of the recording that hold speech */
+#define TEST_VOICED_FIRST   6
+#define TEST_VOICED_LAST    9
+#define TEST_FRICATIVE_FIRST    16
+#define TEST_FRICATIVE_LAST     17
+
+/* Private functions ------------------------------------------------------- */
+
+/**
+ * @brief Read a 16 bit mono PCM WAV file
+ */
+static bool read_wav(const char *path, std::vector<int16_t> *samples, uint32_t *rate)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t header[12];
+    bool format_ok = false;
+
+    if (file == NULL) {
+        return false;
+    }
+
+    if (fread(header, 1, 12, file) != 12 || memcmp(header, "RIFF", 4) != 0 || memcmp(&header[8], "WAVE", 4) != 0) {
+        fclose(file);
+        return false;
+    }
+
+    uint8_t chunk[8];
+    while (fread(chunk, 1, 8, file) == 8) {
+        uint32_t size = chunk[4] | (chunk[5] << 8) | (chunk[6] << 16) | ((uint32_t)chunk[7] << 24);
+        std::vector<uint8_t> body(size);
+
+        if (fread(body.data(), 1, size, file) != size) {
+            break;
+        }
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            uint16_t format = body[0] | (body[1] << 8);
+            uint16_t channels = body[2] | (body[3] << 8);
+            uint16_t bits = body[14] | (body[15] << 8);
+            *rate = body[4] | (body[5] << 8) | (body[6] << 16) | ((uint32_t)body[7] << 24);
+            format_ok = (format == 1 && channels == 1 && bits == 16);
+        }
+        else if (memcmp(chunk, "data", 4) == 0 && format_ok) {
+            samples->resize(size / 2);
+            memcpy(samples->data(), body.data(), samples->size() * sizeof(int16_t));
+            fclose(file);
+            return true;
+        }
+    }
+
+    fclose(file);
+    return false;
+}
+
+static bool is_speech(uint32_t slice)
+{
+    return (slice >= TEST_VOICED_FIRST && slice <= TEST_VOICED_LAST) ||
+        (slice >= TEST_FRICATIVE_FIRST && slice <= TEST_FRICATIVE_LAST);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int16_t> samples;
+    uint32_t rate = 0;
+
+    if (argc < 2 || read_wav(argv[1], &samples, &rate) == false) {
+        printf("usage: test_audio_gate <16 bit mono wav>\n");
+        return 1;
+    }
+    EI_HOST_CHECK(rate == TEST_FREQUENCY, "recording at %u Hz", rate);
+
+    EiAudioSliceStats stats;
+    EiAudioGate gate;
+    uint32_t n_slices = samples.size() / TEST_SLICE;
+    uint32_t last_active = 0;
+    bool seen_active = false;
+
+    stats.reset();
+    gate.start(TEST_SLICES_PER_WINDOW, TEST_SLICES_PER_WINDOW);
+
+    for (uint32_t slice = 0; slice < n_slices; slice++) {
+        const int16_t *data = &samples[slice * TEST_SLICE];
+        double energy = 0.0;
+        uint32_t crossings = 0;
+
+        for (uint32_t offset = 0; offset < TEST_SLICE; offset += TEST_CHUNK) {
+            uint32_t n = (TEST_SLICE - offset < TEST_CHUNK) ? TEST_SLICE - offset : TEST_CHUNK;
+            stats.add(&data[offset], n);
+        }
+        stats.finish();
+
+        // the same over the whole slice at once
+        for (uint32_t ix = 0; ix < TEST_SLICE; ix++) {
+            int16_t prev = ix > 0 ? data[ix - 1] : (slice > 0 ? data[-1] : 0);
+            energy += (double)data[ix] * data[ix];
+            crossings += ((data[ix] ^ prev) < 0);
+        }
+        float rms = (float)sqrt(energy / TEST_SLICE);
+        EI_HOST_CHECK(fabsf(stats.get_rms() - rms) < 0.01f * rms + 0.01f, "slice %u: rms %.2f in chunks, %.2f at once", slice, stats.get_rms(), rms);
+        EI_HOST_CHECK(stats.get_zcr() == (float)crossings / TEST_SLICE, "slice %u: zcr %.4f in chunks", slice, stats.get_zcr());
+
+        float floor = gate.get_noise_floor();
+        bool classify = gate.update(stats.get_rms(), stats.get_zcr());
+        printf("slice %2u %4.2f s: rms %7.1f zcr %.3f floor %6.1f %-6s %s%s\n", slice, (float)slice * TEST_SLICE / rate,
+            stats.get_rms(), stats.get_zcr(), floor, gate.active() ? "active" : "silent",
+            classify ? "classified" : "skipped", gate.opened() ? ", opened" : "");
+
+        if (is_speech(slice)) {
+            EI_HOST_CHECK(gate.active() && classify, "speech slice %u not classified", slice);
+        }
+        else if (slice >= TEST_SLICES_PER_WINDOW && (seen_active == false || slice - last_active >= TEST_SLICES_PER_WINDOW)) {
+            EI_HOST_CHECK(classify == false, "silent slice %u classified", slice);
+        }
+        else if (slice > 0) {
+            EI_HOST_CHECK(gate.active() == false, "silent slice %u counted as active", slice);
+        }
+        if (slice >= TEST_FRICATIVE_FIRST && slice <= TEST_FRICATIVE_LAST) {
+            EI_HOST_CHECK(stats.get_rms() < floor * EI_AUDIO_GATE_RATIO, "fricative slice %u opened on level alone", slice);
+        }
+        if (gate.active()) {
+            last_active = slice;
+            seen_active = true;
+        }
+    }
+
+    printf("%u of %u slices skipped, opened %u times\n", gate.get_skipped(), gate.get_slices(), gate.get_openings());
+    EI_HOST_CHECK(gate.get_openings() == 2, "gate opened %u times for a word and a fricative", gate.get_openings());
+
+    return ei_host_test_result("test_audio_gate");
+}
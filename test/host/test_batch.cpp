@@ -0,0 +1,112 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * run_classifier_batch over a recording of several windows, on the impulse
+ * in fusion_model/. Built with EI_DSP_RESULT_OVERRIDE, so the classification
+ * is not part of the result struct and every result would otherwise point
+ * at the handle's array. The learning block reports the first feature of
+ * the window, which is its start frame. Checks that every result keeps the
+ * classification of its own window.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+static_assert(EI_IMPULSE_RESULT_CLASSIFICATION_IS_STATICALLY_ALLOCATED == 0,
+    "the test covers results without a classification array");
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_FRAMES         (EI_CLASSIFIER_RAW_SAMPLE_COUNT * 3)
+#define TEST_STRIDE         (EI_CLASSIFIER_RAW_SAMPLE_COUNT / 2)
+#define TEST_WINDOWS        ((TEST_FRAMES - EI_CLASSIFIER_RAW_SAMPLE_COUNT) / TEST_STRIDE + 1)
+
+/* Private variables ------------------------------------------------------- */
+static float recording[TEST_FRAMES * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME];
+
+/* Private functions ------------------------------------------------------- */
+
+EI_IMPULSE_ERROR run_nn_inference(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config_ptr, bool debug)
+{
+    return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+}
+
+EI_IMPULSE_ERROR host_fusion_infer(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config, bool debug)
+{
+    const ei::matrix_t *features = fmatrix[0].matrix;
+
+    result->classification[0].value = features->buffer[0];
+    result->classification[1].value = -features->buffer[0];
+
+    return EI_IMPULSE_OK;
+}
+
+static void check_batch(size_t max_results)
+{
+    signal_t signal;
+    ei_impulse_result_t results[TEST_WINDOWS];
+    size_t results_count = 0;
+
+    numpy::signal_from_buffer(recording, TEST_FRAMES * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME, &signal);
+
+    EI_IMPULSE_ERROR res = run_classifier_batch(&signal, TEST_STRIDE, results, max_results, &results_count);
+    EI_HOST_CHECK(res == EI_IMPULSE_OK, "batch failed (%d)", res);
+    EI_HOST_CHECK(results_count == max_results, "%zu windows classified, expected %zu", results_count, max_results);
+
+    for (size_t ix = 0; ix < results_count; ix++) {
+        float start = (float)(ix * TEST_STRIDE);
+        EI_HOST_CHECK(results[ix].classification[0].value == start && results[ix].classification[1].value == -start,
+            "window %zu reports %.0f, expected %.0f", ix, results[ix].classification[0].value, start);
+        EI_HOST_CHECK(results[ix].classification != ei_default_impulse.arena.classification,
+            "window %zu points at the handle's classification", ix);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    for (size_t frame = 0; frame < TEST_FRAMES; frame++) {
+        for (size_t axis = 0; axis < EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME; axis++) {
+            recording[frame * EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME + axis] = (float)frame;
+        }
+    }
+
+    check_batch(TEST_WINDOWS);
+    // a smaller batch reuses the per-window storage of the first one
+    check_batch(2);
+    check_batch(TEST_WINDOWS);
+
+    return ei_host_test_result("test_batch");
+}
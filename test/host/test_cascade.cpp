@@ -0,0 +1,191 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Two stage cascade on the impulse in fusion_model/, with a gate learning
+ * block and a stage two block that each fill the classification through
+ * process_classification_f32. The gate score is the first feature of the
+ * window. Checks that stage two and its postprocessing only run above the
+ * threshold, and that a rejected window reports every class at 0 instead
+ * of the gate's own output.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+
+/* Constants --------------------------------------------------------------- */
+#define GATE_BLOCK_ID       3
+#define STAGE_TWO_BLOCK_ID  4
+#define STAGE_TWO_SCORE     0.75f
+
+/* Private variables ------------------------------------------------------- */
+static float window[EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE];
+static uint32_t stage_two_runs = 0;
+
+/* Private functions ------------------------------------------------------- */
+
+EI_IMPULSE_ERROR run_nn_inference(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config_ptr, bool debug)
+{
+    return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+}
+
+EI_IMPULSE_ERROR host_fusion_infer(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config, bool debug)
+{
+    return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+}
+
+/**
+ * @brief Write a two class raw output, like a classifier's output tensor
+ */
+static void write_raw_output(ei_impulse_result_t *result, uint32_t learn_block_index, uint32_t block_id, float score)
+{
+    result->_raw_outputs[learn_block_index].matrix = new ei::matrix_t(1, 2);
+    result->_raw_outputs[learn_block_index].blockId = block_id;
+    result->_raw_outputs[learn_block_index].matrix->buffer[0] = 1.0f - score;
+    result->_raw_outputs[learn_block_index].matrix->buffer[1] = score;
+}
+
+static EI_IMPULSE_ERROR gate_infer(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config, bool debug)
+{
+    write_raw_output(result, learn_block_index, GATE_BLOCK_ID, fmatrix[0].matrix->buffer[0]);
+    return EI_IMPULSE_OK;
+}
+
+static EI_IMPULSE_ERROR stage_two_infer(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config, bool debug)
+{
+    stage_two_runs++;
+    write_raw_output(result, learn_block_index, STAGE_TWO_BLOCK_ID, STAGE_TWO_SCORE);
+    return EI_IMPULSE_OK;
+}
+
+static const ei_learning_block_t cascade_learning_blocks[2] = {
+    { GATE_BLOCK_ID, &gate_infer, nullptr, EI_CLASSIFIER_IMAGE_SCALING_NONE,
+      ei_learning_block_1_3_inputs, ei_learning_block_1_3_inputs_size },
+    { STAGE_TWO_BLOCK_ID, &stage_two_infer, nullptr, EI_CLASSIFIER_IMAGE_SCALING_NONE,
+      ei_learning_block_1_3_inputs, ei_learning_block_1_3_inputs_size },
+};
+
+static const ei_postprocessing_block_t cascade_postprocessing_blocks[2] = {
+    {
+        .block_id = GATE_BLOCK_ID,
+        .type = EI_CLASSIFIER_MODE_CLASSIFICATION,
+        .init_fn = NULL,
+        .deinit_fn = NULL,
+        .postprocess_fn = &process_classification_f32,
+        .display_fn = NULL,
+        .config = NULL,
+        .input_block_id = GATE_BLOCK_ID
+    },
+    {
+        .block_id = STAGE_TWO_BLOCK_ID,
+        .type = EI_CLASSIFIER_MODE_CLASSIFICATION,
+        .init_fn = NULL,
+        .deinit_fn = NULL,
+        .postprocess_fn = &process_classification_f32,
+        .display_fn = NULL,
+        .config = NULL,
+        .input_block_id = STAGE_TWO_BLOCK_ID
+    },
+};
+
+static const ei_cascade_config_t cascade_config = {
+    GATE_BLOCK_ID,
+    1, // score_index
+    0.5f, // threshold
+    EI_CLASSIFIER_DATATYPE_FLOAT32,
+    1.0f, // scale
+    0 // zero_point
+};
+
+/**
+ * @brief Classify a window whose gate score is `score`
+ */
+static void classify(ei_impulse_handle_t *handle, float score, ei_impulse_result_t *result)
+{
+    signal_t signal;
+
+    for (size_t ix = 0; ix < EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE; ix++) {
+        window[ix] = score;
+    }
+    numpy::signal_from_buffer(window, EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE, &signal);
+
+    EI_IMPULSE_ERROR res = process_impulse(handle, &signal, result, false);
+    EI_HOST_CHECK(res == EI_IMPULSE_OK, "score %.2f: inference failed (%d)", score, res);
+}
+
+int main(int argc, char **argv)
+{
+    ei_impulse_t impulse = *ei_default_impulse.impulse;
+    ei_impulse_result_t result;
+
+    impulse.learning_blocks_size = 2;
+    impulse.learning_blocks = cascade_learning_blocks;
+    impulse.postprocessing_blocks_size = 2;
+    impulse.postprocessing_blocks = cascade_postprocessing_blocks;
+    impulse.output_tensors_size = 2;
+    impulse.cascade = &cascade_config;
+
+    ei_impulse_handle_t handle(&impulse);
+
+    // above the threshold stage two runs and its output is the result
+    classify(&handle, 0.9f, &result);
+    EI_HOST_CHECK(!handle.cascade.rejected, "accepted window marked rejected");
+    EI_HOST_CHECK(stage_two_runs == 1, "stage two ran %u times", stage_two_runs);
+    EI_HOST_CHECK(result.classification[1].value == STAGE_TWO_SCORE,
+        "result %.2f is not the stage two output", result.classification[1].value);
+
+    // below it only the gate runs, and no postprocessing overwrites the zeros
+    classify(&handle, 0.2f, &result);
+    EI_HOST_CHECK(handle.cascade.rejected, "window below the threshold not rejected");
+    EI_HOST_CHECK(stage_two_runs == 1, "stage two ran on a rejected window");
+    for (uint16_t ix = 0; ix < impulse.label_count; ix++) {
+        EI_HOST_CHECK(result.classification[ix].value == 0.0f, "rejected window reports %s at %.2f",
+            result.classification[ix].label, result.classification[ix].value);
+        EI_HOST_CHECK(result.classification[ix].label == impulse.categories[ix], "class %u has no label", ix);
+    }
+    EI_HOST_CHECK(handle.cascade.last_score == 0.2f, "gate score %.2f", handle.cascade.last_score);
+
+    // the next accepted window is not affected by the rejection
+    classify(&handle, 0.6f, &result);
+    EI_HOST_CHECK(!handle.cascade.rejected && stage_two_runs == 2, "stage two did not run again");
+    EI_HOST_CHECK(result.classification[1].value == STAGE_TWO_SCORE,
+        "result %.2f is not the stage two output", result.classification[1].value);
+
+    EI_HOST_CHECK(handle.cascade.gate_runs == 3 && handle.cascade.stage_two_runs == 2,
+        "counted %u gate and %u stage two runs", handle.cascade.gate_runs, handle.cascade.stage_two_runs);
+
+    return ei_host_test_result("test_cascade");
+}
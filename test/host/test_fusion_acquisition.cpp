@@ -0,0 +1,254 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Parallel fusion acquisition of the ESP32 on simulated sensors with
+ * configurable read latencies. The sample timer, the bus tasks and the
+ * fusion layer are the firmware code. Every sensor returns the time it was
+ * read at, so the frames show how old each sample is when it reaches the
+ * sampler callback.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "ei_fusion.h"
+#include "ei_device_info_lib.h"
+#include "ei_sampler.h"
+#include "ei_fusion_acquisition_esp32.h"
+#include "ei_sample_timer_esp32.h"
+#include "esp_timer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_INTERVAL_MS    10
+#define TEST_FRAMES         200
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    uint32_t latency_us;
+    float value;
+    std::thread::id thread;
+} test_sensor_t;
+
+/* Private variables ------------------------------------------------------- */
+static test_sensor_t test_sensors[2];
+static std::vector<int64_t> frame_times;
+static std::vector<float> frame_values[NUM_MAX_FUSIONS];
+static std::thread::id sampler_thread;
+static std::atomic<bool> done;
+
+/**
+ * @brief Device that samples on the ESP32 sample timer, like EiDeviceESP32
+ */
+class EiTimerDevice : public EiDeviceInfo {
+public:
+    void init_device_id(void) override
+    {
+    }
+
+    bool start_sample_thread(void (*sample_read_cb)(void), float sample_interval_ms) override
+    {
+        ei_fusion_acquisition_reset_stats();
+        return ei_sample_timer_start(sample_read_cb, (uint32_t)(sample_interval_ms * 1000.0f + 0.5f));
+    }
+
+    bool stop_sample_thread(void) override
+    {
+        ei_sample_timer_stop();
+        ei_fusion_acquisition_detach();
+        done = true;
+        return true;
+    }
+};
+
+static EiTimerDevice device;
+
+EiDeviceInfo *EiDeviceInfo::get_device(void)
+{
+    return &device;
+}
+
+/** Sampling to flash is not tested here */
+bool ei_sampler_start_sampling(void *v_ptr_payload, starter_callback ei_sample_start, uint32_t sample_size)
+{
+    return false;
+}
+
+/* Private functions ------------------------------------------------------- */
+
+static float to_ms(int64_t time_us)
+{
+    return (float)time_us / 1000.0f;
+}
+
+/**
+ * @brief Takes latency_us and returns the middle of the read in ms
+ */
+template<int ix>
+static float *read_simulated(int n_samples)
+{
+    test_sensor_t *sensor = &test_sensors[ix];
+    int64_t start = esp_timer_get_time();
+
+    std::this_thread::sleep_for(std::chrono::microseconds(sensor->latency_us));
+    sensor->value = to_ms((start + esp_timer_get_time()) / 2);
+    sensor->thread = std::this_thread::get_id();
+
+    return &sensor->value;
+}
+
+static ei_device_fusion_sensor_t make_sensor(const char *name, float *(*read_data)(int), int bus)
+{
+    ei_device_fusion_sensor_t sensor = {};
+
+    sensor.name = name;
+    sensor.num_axis = 1;
+    sensor.frequencies[0] = 1000.0f / TEST_INTERVAL_MS;
+    sensor.sensors[0] = { name, "ms" };
+    sensor.read_data = read_data;
+    sensor.bus = bus;
+
+    return sensor;
+}
+
+static bool record_frame(const void *sample, uint32_t size)
+{
+    const fusion_sample_format_t *values = (const fusion_sample_format_t *)sample;
+
+    sampler_thread = std::this_thread::get_id();
+    frame_times.push_back(esp_timer_get_time());
+    for (uint32_t ix = 0; ix < size / sizeof(fusion_sample_format_t); ix++) {
+        frame_values[ix].push_back(values[ix]);
+    }
+
+    return frame_times.size() == TEST_FRAMES;
+}
+
+/**
+ * @brief Sample TEST_FRAMES frames of the list, from the bus tasks if parallel
+ *
+ * @return periods the sample timer missed
+ */
+static uint32_t run_session(const char *list, bool parallel)
+{
+    frame_times.clear();
+    for (auto &values : frame_values) {
+        values.clear();
+    }
+    done = false;
+
+    EI_HOST_CHECK(ei_connect_fusion_list(list, SENSOR_FORMAT), "%s: not a fusion", list);
+    if (parallel) {
+        EI_HOST_CHECK(ei_fusion_acquisition_attach(), "%s: attach failed", list);
+    }
+    EI_HOST_CHECK(ei_fusion_sample_start(record_frame, TEST_INTERVAL_MS), "%s: start failed", list);
+
+    int64_t until = esp_timer_get_time() + TEST_FRAMES * TEST_INTERVAL_MS * 1000 * 3;
+    while (done == false && esp_timer_get_time() < until) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EI_HOST_CHECK(done, "%s: %zu of %d frames", list, frame_times.size(), TEST_FRAMES);
+    if (done == false) {
+        device.stop_sample_thread();
+    }
+
+    return ei_sample_timer_get_stats()->missed;
+}
+
+/**
+ * @brief Median age in ms of the samples of one sensor when the frame reached the sampler
+ */
+static float median_age_ms(int sensor)
+{
+    std::vector<float> ages;
+
+    for (size_t ix = 0; ix < frame_times.size(); ix++) {
+        ages.push_back(to_ms(frame_times[ix]) - frame_values[sensor][ix]);
+    }
+    if (ages.empty()) {
+        return 0.0f;
+    }
+    std::sort(ages.begin(), ages.end());
+
+    return ages[ages.size() / 2];
+}
+
+int main(int argc, char **argv)
+{
+    // as many sensors as the firmware registers, the latencies change per session
+    ei_add_sensor_to_fusion_list(make_sensor("I2C", read_simulated<0>, EI_FUSION_BUS_I2C));
+    ei_add_sensor_to_fusion_list(make_sensor("ADC", read_simulated<1>, EI_FUSION_BUS_ADC));
+
+    EI_HOST_CHECK(ei_fusion_acquisition_init(), "init failed");
+
+    // without attach the sensors are read from the sample task itself
+    test_sensors[1].latency_us = 200;
+    run_session("ADC", false);
+    EI_HOST_CHECK(test_sensors[1].thread == sampler_thread, "read from a bus task without attach");
+
+    // 6 ms on each bus, one after the other they don't fit in 10 ms
+    test_sensors[0].latency_us = 6000;
+    test_sensors[1].latency_us = 6000;
+    uint32_t sequential_missed = run_session("I2C+ADC", false);
+    uint32_t parallel_missed = run_session("I2C+ADC", true);
+    printf("6 ms I2C + 6 ms ADC at %d ms: %lu periods missed sequential, %lu parallel, age %.1f / %.1f ms\n",
+        TEST_INTERVAL_MS, (unsigned long)sequential_missed, (unsigned long)parallel_missed, median_age_ms(0), median_age_ms(1));
+    ei_fusion_acquisition_print_stats();
+    EI_HOST_CHECK(test_sensors[0].thread != sampler_thread, "read from the sample task after attach");
+    EI_HOST_CHECK(sequential_missed >= TEST_FRAMES / 10, "sequential reads missed %lu periods", (unsigned long)sequential_missed);
+    EI_HOST_CHECK(parallel_missed < TEST_FRAMES / 20, "parallel reads missed %lu periods", (unsigned long)parallel_missed);
+    // each frame holds the reads of its own tick, not of the previous one
+    for (int ix = 0; ix < 2; ix++) {
+        EI_HOST_CHECK(median_age_ms(ix) > 0.0f && median_age_ms(ix) < TEST_INTERVAL_MS / 2.0f,
+            "sensor %d is %.1f ms old in the frame", ix, median_age_ms(ix));
+    }
+
+    // a 25 ms read is not waited for, the ADC next to it stays current
+    test_sensors[0].latency_us = 25000;
+    test_sensors[1].latency_us = 200;
+    uint32_t slow_missed = run_session("ADC+I2C", true);
+    printf("0.2 ms ADC + 25 ms I2C at %d ms: %lu periods missed, age %.1f / %.1f ms\n",
+        TEST_INTERVAL_MS, (unsigned long)slow_missed, median_age_ms(0), median_age_ms(1));
+    ei_fusion_acquisition_print_stats();
+    EI_HOST_CHECK(slow_missed < TEST_FRAMES / 20, "slow bus made the sample timer miss %lu periods", (unsigned long)slow_missed);
+    EI_HOST_CHECK(median_age_ms(0) < TEST_INTERVAL_MS / 2.0f, "ADC is %.1f ms old next to the slow sensor", median_age_ms(0));
+    EI_HOST_CHECK(median_age_ms(1) < 25.0f + 2 * TEST_INTERVAL_MS, "slow sensor is %.1f ms old", median_age_ms(1));
+
+    return ei_host_test_result("test_fusion_acquisition");
+}
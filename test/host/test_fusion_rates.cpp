@@ -0,0 +1,187 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Native rate fusion sampling, ei_fusion_resampled_sample_start. The sample
+ * thread is driven tick by tick, the sensors count their reads. Checks that
+ * every sensor is read at least at the rate it was picked for, also when the
+ * base rate is not a whole multiple of it.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "ei_fusion.h"
+#include "ei_device_info_lib.h"
+#include "ei_sampler.h"
+
+#include <string.h>
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_TICKS          2000
+
+/* Private variables ------------------------------------------------------- */
+static void (*tick_cb)(void) = nullptr;
+static float tick_interval_ms = 0.0f;
+static uint32_t fused_samples = 0;
+
+/**
+ * @brief Device that hands the sample thread callback to the test
+ */
+class EiTickDevice : public EiDeviceInfo {
+public:
+    void init_device_id(void) override
+    {
+    }
+
+    bool start_sample_thread(void (*sample_read_cb)(void), float sample_interval_ms) override
+    {
+        tick_cb = sample_read_cb;
+        tick_interval_ms = sample_interval_ms;
+        return true;
+    }
+
+    bool stop_sample_thread(void) override
+    {
+        tick_cb = nullptr;
+        return true;
+    }
+};
+
+static EiTickDevice device;
+
+EiDeviceInfo *EiDeviceInfo::get_device(void)
+{
+    return &device;
+}
+
+/** Sampling to flash is not tested here */
+bool ei_sampler_start_sampling(void *v_ptr_payload, starter_callback ei_sample_start, uint32_t sample_size)
+{
+    return false;
+}
+
+/* Sensors, one axis each that counts its reads */
+static uint32_t reads[4];
+static float values[4];
+
+template<int ix>
+static float *read_counted(int n_samples)
+{
+    reads[ix]++;
+    values[ix] = (float)reads[ix];
+    return &values[ix];
+}
+
+static ei_device_fusion_sensor_t make_sensor(const char *name, float *(*read_data)(int), float hz)
+{
+    ei_device_fusion_sensor_t sensor = {};
+
+    sensor.name = name;
+    sensor.num_axis = 1;
+    sensor.frequencies[0] = hz;
+    sensor.sensors[0] = { name, "u" };
+    sensor.read_data = read_data;
+
+    return sensor;
+}
+
+static bool count_fused(const void *sample, uint32_t size)
+{
+    fused_samples++;
+    return false;
+}
+
+/* Private functions ------------------------------------------------------- */
+
+/**
+ * @brief Start native rate sampling of the list at out_hz and run TEST_TICKS
+ * base ticks, check the effective read rate of sensors[i] against requested_hz[i]
+ */
+static void check_rates(const char *list, float out_hz, const int *sensors, const float *requested_hz, int n)
+{
+    memset(reads, 0, sizeof(reads));
+    fused_samples = 0;
+
+    EI_HOST_CHECK(ei_connect_fusion_list(list, SENSOR_FORMAT), "%s: not a fusion", list);
+    EI_HOST_CHECK(ei_fusion_resampled_sample_start(count_fused, 1000.0f / out_hz), "%s at %.1f Hz: start failed", list, out_hz);
+    if (tick_cb == nullptr) {
+        return;
+    }
+
+    for (int ix = 0; ix < TEST_TICKS && tick_cb != nullptr; ix++) {
+        tick_cb();
+    }
+    device.stop_sample_thread();
+
+    float elapsed_s = TEST_TICKS * tick_interval_ms / 1000.0f;
+    for (int ix = 0; ix < n; ix++) {
+        float effective_hz = reads[sensors[ix]] / elapsed_s;
+
+        printf("%-12s %5.1f Hz out, sensor %d read at %6.1f Hz for %6.1f Hz\n", list, out_hz, ix, effective_hz, requested_hz[ix]);
+        EI_HOST_CHECK(effective_hz >= requested_hz[ix] * 0.999f, "%s: sensor %d read at %.1f Hz, below %.1f Hz",
+            list, ix, effective_hz, requested_hz[ix]);
+    }
+    EI_HOST_CHECK(fused_samples >= (uint32_t)(elapsed_s * out_hz) - 10, "%s: %u fused samples in %.1f s at %.1f Hz",
+        list, fused_samples, elapsed_s, out_hz);
+}
+
+int main(int argc, char **argv)
+{
+    ei_add_sensor_to_fusion_list(make_sensor("Fast", read_counted<0>, 100.0f));
+    ei_add_sensor_to_fusion_list(make_sensor("Mid", read_counted<1>, 60.0f));
+    ei_add_sensor_to_fusion_list(make_sensor("Slow", read_counted<2>, 40.0f));
+    ei_add_sensor_to_fusion_list(make_sensor("Half", read_counted<3>, 50.0f));
+
+    // 100 / 60 and 100 / 40 are not whole, rounding to the nearest divider
+    // read them at 50 and 33 Hz
+    {
+        const int sensors[] = { 0, 1 };
+        const float requested[] = { 100.0f, 60.0f };
+        check_rates("Fast+Mid", 40.0f, sensors, requested, 2);
+    }
+    {
+        const int sensors[] = { 0, 2 };
+        const float requested[] = { 100.0f, 40.0f };
+        check_rates("Fast+Slow", 25.0f, sensors, requested, 2);
+    }
+
+    // whole divider
+    {
+        const int sensors[] = { 0, 3 };
+        const float requested[] = { 100.0f, 50.0f };
+        check_rates("Fast+Half", 50.0f, sensors, requested, 2);
+    }
+
+    return ei_host_test_result("test_fusion_rates");
+}
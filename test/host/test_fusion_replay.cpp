@@ -0,0 +1,306 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Continuous fusion inference fed from a CSV recording. The replay source
+ * stands in for the fusion sampler and hands every row to samples_callback
+ * of ei_run_fusion_impulse.cpp. The impulse (fusion_model/) has a raw DSP
+ * block, so every classified window can be compared with the CSV rows.
+ *
+ * - paced: the replay waits for each slide to be classified, every window
+ *   must be the newest EI_CLASSIFIER_RAW_SAMPLE_COUNT rows at a slide boundary
+ * - slow: inference takes longer than two slides, the runner has to report
+ *   missed slides and must not print the windows sampling overwrote
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/classifier/ei_model_types.h"
+#include "ei_device_espressif_esp32.h"
+#include "ei_run_impulse.h"
+#include "firmware-sdk/ei_fusion.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_AXES           EI_CLASSIFIER_RAW_SAMPLES_PER_FRAME
+#define TEST_WINDOW_ROWS    EI_CLASSIFIER_RAW_SAMPLE_COUNT
+#define TEST_SLIDE_ROWS     EI_CLASSIFIER_SLICE_SIZE
+/** Rows the slow inference waits for, more than two slides */
+#define TEST_SLOW_ROWS      (TEST_SLIDE_ROWS * 2 + TEST_SLIDE_ROWS / 2)
+
+typedef std::array<float, TEST_AXES> csv_row_t;
+
+typedef enum {
+    REPLAY_PACED,
+    REPLAY_SLOW
+} replay_mode_t;
+
+/* Private variables ------------------------------------------------------- */
+static std::vector<csv_row_t> csv_rows;
+static replay_mode_t replay_mode;
+static std::thread replay_thread;
+static std::mutex replay_mutex;
+static std::condition_variable replay_cv;
+static size_t rows_fed = 0;
+static bool replay_done = false;
+static bool infer_busy = false;
+/** Windows seen by the learning block, with the rows fed when it ran */
+static std::vector<std::vector<float>> windows;
+static std::vector<size_t> windows_fed;
+
+/* CSV --------------------------------------------------------------------- */
+
+/**
+ * @brief Read an Edge Impulse CSV export: timestamp followed by the axes
+ */
+static bool load_csv(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[256];
+
+    if (file == NULL) {
+        return false;
+    }
+
+    csv_rows.clear();
+    while (fgets(line, sizeof(line), file)) {
+        float timestamp;
+        csv_row_t row;
+
+        if (sscanf(line, "%f,%f,%f,%f", &timestamp, &row[0], &row[1], &row[2]) == 1 + TEST_AXES) {
+            csv_rows.push_back(row);
+        }
+    }
+    fclose(file);
+
+    return csv_rows.size() > TEST_WINDOW_ROWS;
+}
+
+/* Replay source, replaces the fusion sampler ------------------------------ */
+
+static void replay(sampler_callback callback)
+{
+    for (size_t ix = 0; ix < csv_rows.size(); ix++) {
+        callback(csv_rows[ix].data(), sizeof(csv_row_t));
+
+        std::unique_lock<std::mutex> lock(replay_mutex);
+        rows_fed = ix + 1;
+        replay_cv.notify_all();
+
+        if (replay_mode == REPLAY_PACED) {
+            // a completed slide is classified before the next row arrives
+            if (rows_fed >= TEST_WINDOW_ROWS && (rows_fed - TEST_WINDOW_ROWS) % TEST_SLIDE_ROWS == 0) {
+                size_t expected = (rows_fed - TEST_WINDOW_ROWS) / TEST_SLIDE_ROWS + 1;
+                bool done = replay_cv.wait_for(lock, std::chrono::seconds(2),
+                    [expected] { return windows.size() >= expected && !infer_busy; });
+                EI_HOST_CHECK(done, "slide at row %zu not classified", rows_fed);
+            }
+        }
+        else {
+            lock.unlock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    replay_done = true;
+    replay_cv.notify_all();
+}
+
+bool ei_connect_fusion_list(const char *input_list, ei_fusion_list_format format)
+{
+    return true;
+}
+
+bool ei_fusion_resampled_sample_start(sampler_callback callsampler, float sample_interval_ms)
+{
+    EI_HOST_CHECK(sample_interval_ms == EI_CLASSIFIER_INTERVAL_MS, "sampling at %f ms", sample_interval_ms);
+    replay_thread = std::thread(replay, callsampler);
+    return true;
+}
+
+bool ei_user_invoke_stop(void)
+{
+    std::lock_guard<std::mutex> lock(replay_mutex);
+    return replay_done && !infer_busy;
+}
+
+/* Learning blocks of fusion_model ----------------------------------------- */
+
+/* referenced by the quantized image path of ei_run_classifier.h */
+EI_IMPULSE_ERROR run_nn_inference(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config_ptr, bool debug)
+{
+    return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+}
+
+EI_IMPULSE_ERROR host_fusion_infer(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config, bool debug)
+{
+    ei::matrix_t *features = fmatrix[0].matrix;
+    std::vector<float> window(features->buffer, features->buffer + features->rows * features->cols);
+    std::unique_lock<std::mutex> lock(replay_mutex);
+
+    infer_busy = true;
+    windows.push_back(window);
+    windows_fed.push_back(rows_fed);
+
+    if (replay_mode == REPLAY_SLOW) {
+        size_t until = rows_fed + TEST_SLOW_ROWS;
+        replay_cv.wait(lock, [until] { return rows_fed >= until || replay_done; });
+    }
+
+    // shake when the horizontal axes move
+    float level = 0.0f;
+    for (size_t ix = 0; ix < window.size(); ix += TEST_AXES) {
+        level += fabsf(window[ix]) + fabsf(window[ix + 1]);
+    }
+    level /= (window.size() / TEST_AXES) * 4.0f;
+    float shake = level > 1.0f ? 1.0f : level;
+
+    result->classification[0].label = impulse->categories[0];
+    result->classification[0].value = 1.0f - shake;
+    result->classification[1].label = impulse->categories[1];
+    result->classification[1].value = shake;
+
+    infer_busy = false;
+    replay_cv.notify_all();
+
+    return EI_IMPULSE_OK;
+}
+
+/* Test -------------------------------------------------------------------- */
+
+/**
+ * @brief Run AT+RUNIMPULSECONT over the CSV
+ *
+ * @return everything the runner printed
+ */
+static std::string run_continuous(replay_mode_t mode)
+{
+    char path[] = "/tmp/ei_fusion_replay_XXXXXX";
+    int capture = mkstemp(path);
+    int saved_stdout = dup(STDOUT_FILENO);
+
+    replay_mode = mode;
+    rows_fed = 0;
+    replay_done = false;
+    windows.clear();
+    windows_fed.clear();
+
+    fflush(stdout);
+    dup2(capture, STDOUT_FILENO);
+
+    ei_start_impulse(true, false, false);
+    replay_thread.join();
+
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+
+    std::string output;
+    char buffer[512];
+    ssize_t n;
+    lseek(capture, 0, SEEK_SET);
+    while ((n = read(capture, buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, n);
+    }
+    close(capture);
+    unlink(path);
+
+    return output;
+}
+
+static size_t count(const std::string &text, const char *what)
+{
+    size_t n = 0;
+    for (size_t pos = text.find(what); pos != std::string::npos; pos = text.find(what, pos + 1)) {
+        n++;
+    }
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "data/fusion_replay.csv";
+
+    if (load_csv(path) == false) {
+        printf("Can't read %s\n", path);
+        return 1;
+    }
+
+    // every slide is classified over the newest window
+    std::string output = run_continuous(REPLAY_PACED);
+    size_t slides = (csv_rows.size() - TEST_WINDOW_ROWS) / TEST_SLIDE_ROWS + 1;
+
+    EI_HOST_CHECK(windows.size() == slides, "%zu windows classified, expected %zu", windows.size(), slides);
+    EI_HOST_CHECK(count(output, "#Classification predictions") == windows.size(),
+        "%zu results printed for %zu windows", count(output, "#Classification predictions"), windows.size());
+    EI_HOST_CHECK(count(output, "slides missed") == 0, "missed slides reported while paced");
+
+    for (size_t w = 0; w < windows.size(); w++) {
+        size_t end = TEST_WINDOW_ROWS + w * TEST_SLIDE_ROWS;
+        size_t mismatch = 0;
+
+        EI_HOST_CHECK(windows_fed[w] == end, "window %zu classified at row %zu, expected %zu", w, windows_fed[w], end);
+        for (size_t row = 0; row < TEST_WINDOW_ROWS; row++) {
+            for (size_t axis = 0; axis < TEST_AXES; axis++) {
+                if (windows[w][row * TEST_AXES + axis] != csv_rows[end - TEST_WINDOW_ROWS + row][axis]) {
+                    mismatch++;
+                }
+            }
+        }
+        EI_HOST_CHECK(mismatch == 0, "window %zu differs from rows %zu..%zu in %zu values", w, end - TEST_WINDOW_ROWS, end, mismatch);
+    }
+    printf("paced: %zu rows, %zu windows classified\n", csv_rows.size(), windows.size());
+
+    // inference slower than the slide
+    output = run_continuous(REPLAY_SLOW);
+    size_t printed = count(output, "#Classification predictions");
+
+    EI_HOST_CHECK(windows.size() > 0 && windows.size() < slides, "%zu windows classified with slow inference", windows.size());
+    EI_HOST_CHECK(count(output, "slides missed") > 0, "missed slides not reported");
+    EI_HOST_CHECK(printed < windows.size(), "all %zu windows printed, sampling overwrote them", printed);
+    printf("slow: %zu windows classified, %zu printed\n", windows.size(), printed);
+
+    return ei_host_test_result("test_fusion_replay");
+}
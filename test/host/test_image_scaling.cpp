@@ -0,0 +1,248 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Image scaling of float features (ei_image_scaling.h) on 96x96 and 320x320
+ * RGB images, every scaling mode. The fused per-channel pass is checked
+ * against the per-mode passes it replaced, and both are timed over a scale
+ * and unscale round trip, best of TEST_ROUNDS. The timings are printed only,
+ * a loaded host would make a speed check flaky.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "edge-impulse-sdk/classifier/ei_image_scaling.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_ROUNDS     20
+
+/* Private variables ------------------------------------------------------- */
+static const float torch_mean[] = { 0.485, 0.456, 0.406 };
+static const float torch_std[] = { 0.229, 0.224, 0.225 };
+// This is ordered BGR
+static const float tao_mean[] = { 103.939, 116.779, 123.68 };
+
+static const struct {
+    int scaling;
+    const char *name;
+} scaling_modes[] = {
+    { EI_CLASSIFIER_IMAGE_SCALING_0_255, "0_255" },
+    { EI_CLASSIFIER_IMAGE_SCALING_TORCH, "TORCH" },
+    { EI_CLASSIFIER_IMAGE_SCALING_MIN1_1, "MIN1_1" },
+    { EI_CLASSIFIER_IMAGE_SCALING_MIN128_127, "MIN128_127" },
+    { EI_CLASSIFIER_IMAGE_SCALING_BGR_SUBTRACT_IMAGENET_MEAN, "BGR_IMAGENET" },
+};
+
+/* Private functions ------------------------------------------------------- */
+
+/**
+ * @brief ei_scale_fmatrix() before the fused pass, one pass per operation
+ */
+static void reference_scale(int scaling, float *buffer, size_t count)
+{
+    switch (scaling) {
+        case EI_CLASSIFIER_IMAGE_SCALING_TORCH:
+            for (size_t ix = 0; ix < count; ix += 3) {
+                buffer[ix + 0] = (buffer[ix + 0] - torch_mean[0]) / torch_std[0];
+                buffer[ix + 1] = (buffer[ix + 1] - torch_mean[1]) / torch_std[1];
+                buffer[ix + 2] = (buffer[ix + 2] - torch_mean[2]) / torch_std[2];
+            }
+            break;
+        case EI_CLASSIFIER_IMAGE_SCALING_0_255:
+            for (size_t ix = 0; ix < count; ix++) {
+                buffer[ix] *= 255.0f;
+            }
+            break;
+        case EI_CLASSIFIER_IMAGE_SCALING_MIN128_127:
+            for (size_t ix = 0; ix < count; ix++) {
+                buffer[ix] = buffer[ix] * 255.0f + -128.0f;
+            }
+            break;
+        case EI_CLASSIFIER_IMAGE_SCALING_MIN1_1:
+            for (size_t ix = 0; ix < count; ix++) {
+                buffer[ix] = buffer[ix] * 2.0f + -1.0f;
+            }
+            break;
+        case EI_CLASSIFIER_IMAGE_SCALING_BGR_SUBTRACT_IMAGENET_MEAN:
+            for (size_t ix = 0; ix < count; ix++) {
+                buffer[ix] *= 255.0f;
+            }
+            for (size_t ix = 0; ix < count; ix += 3) {
+                float r = buffer[ix + 0];
+                buffer[ix + 0] = buffer[ix + 2] - tao_mean[0];
+                buffer[ix + 1] -= tao_mean[1];
+                buffer[ix + 2] = r - tao_mean[2];
+            }
+            break;
+    }
+}
+
+/**
+ * @brief ei_unscale_fmatrix() before the fused pass
+ */
+static void reference_unscale(int scaling, float *buffer, size_t count)
+{
+    switch (scaling) {
+        case EI_CLASSIFIER_IMAGE_SCALING_TORCH:
+            for (size_t ix = 0; ix < count; ix += 3) {
+                buffer[ix + 0] = (buffer[ix + 0] * torch_std[0]) + torch_mean[0];
+                buffer[ix + 1] = (buffer[ix + 1] * torch_std[1]) + torch_mean[1];
+                buffer[ix + 2] = (buffer[ix + 2] * torch_std[2]) + torch_mean[2];
+            }
+            break;
+        case EI_CLASSIFIER_IMAGE_SCALING_MIN128_127:
+            for (size_t ix = 0; ix < count; ix++) {
+                buffer[ix] = buffer[ix] * (1.0f / 255.0f) + (128.0f / 255.0f);
+            }
+            break;
+        case EI_CLASSIFIER_IMAGE_SCALING_MIN1_1:
+            for (size_t ix = 0; ix < count; ix++) {
+                buffer[ix] = buffer[ix] * (1.0f / 2.0f) + (1.0f / 2.0f);
+            }
+            break;
+        case EI_CLASSIFIER_IMAGE_SCALING_0_255:
+            for (size_t ix = 0; ix < count; ix++) {
+                buffer[ix] *= 1 / 255.0f;
+            }
+            break;
+        case EI_CLASSIFIER_IMAGE_SCALING_BGR_SUBTRACT_IMAGENET_MEAN:
+            for (size_t ix = 0; ix < count; ix += 3) {
+                float b = buffer[ix + 0];
+                buffer[ix + 0] = buffer[ix + 2] + tao_mean[2];
+                buffer[ix + 1] += tao_mean[1];
+                buffer[ix + 2] = b + tao_mean[0];
+            }
+            for (size_t ix = 0; ix < count; ix++) {
+                buffer[ix] *= 1 / 255.0f;
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Scale and unscale as ei_scale_fmatrix() and ei_unscale_fmatrix() do now
+ */
+static void fused_scale(int scaling, float *buffer, size_t count)
+{
+    ei_input_affine_t affine;
+    if (ei_input_affine_from_scaling(scaling, &affine)) {
+        ei_apply_input_affine(buffer, count, &affine);
+    }
+}
+
+static void fused_unscale(int scaling, float *buffer, size_t count)
+{
+    ei_input_affine_t affine, inverse;
+    if (ei_input_affine_from_scaling(scaling, &affine)) {
+        ei_input_affine_invert(&affine, &inverse);
+        ei_apply_input_affine(buffer, count, &inverse);
+    }
+}
+
+/**
+ * @brief Largest difference relative to max(|a|, 1)
+ */
+static float max_difference(const std::vector<float> &a, const std::vector<float> &b)
+{
+    float worst = 0.0f;
+    for (size_t ix = 0; ix < a.size(); ix++) {
+        float diff = fabsf(a[ix] - b[ix]) / fmaxf(fabsf(a[ix]), 1.0f);
+        worst = fmaxf(worst, diff);
+    }
+    return worst;
+}
+
+/**
+ * @brief Best time of a scale and unscale round trip, in microseconds
+ */
+static double time_round_trip(void (*scale)(int, float *, size_t), void (*unscale)(int, float *, size_t),
+    int scaling, std::vector<float> &buffer)
+{
+    double best = 1e12;
+    for (int round = 0; round < TEST_ROUNDS; round++) {
+        auto start = std::chrono::steady_clock::now();
+        scale(scaling, buffer.data(), buffer.size());
+        unscale(scaling, buffer.data(), buffer.size());
+        auto end = std::chrono::steady_clock::now();
+        best = fmin(best, std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    return best;
+}
+
+static void test_size(size_t width, size_t height)
+{
+    std::vector<float> image(width * height * 3);
+    srand(42);
+    for (float &pixel : image) {
+        pixel = (float)(rand() % 256) / 255.0f;
+    }
+
+    printf("%zux%zu RGB, best of %d round trips\n", width, height, TEST_ROUNDS);
+    for (const auto &mode : scaling_modes) {
+        std::vector<float> reference(image), fused(image);
+        reference_scale(mode.scaling, reference.data(), reference.size());
+        fused_scale(mode.scaling, fused.data(), fused.size());
+        float scale_diff = max_difference(reference, fused);
+
+        fused_unscale(mode.scaling, fused.data(), fused.size());
+        float round_trip_diff = max_difference(image, fused);
+
+        // a multiply by 1/std replaces the divide, every other mode is exact
+        float tolerance = mode.scaling == EI_CLASSIFIER_IMAGE_SCALING_TORCH ? 1e-6f : 0.0f;
+        EI_HOST_CHECK(scale_diff <= tolerance, "%zux%zu %s scaled features differ by %g",
+            width, height, mode.name, scale_diff);
+        EI_HOST_CHECK(round_trip_diff < 1e-5f, "%zux%zu %s round trip differs by %g",
+            width, height, mode.name, round_trip_diff);
+
+        std::vector<float> buffer(image);
+        double reference_us = time_round_trip(reference_scale, reference_unscale, mode.scaling, buffer);
+        double fused_us = time_round_trip(fused_scale, fused_unscale, mode.scaling, buffer);
+        printf("  %-12s %9.1f us -> %9.1f us (%.2fx), scaled diff %.1e\n",
+            mode.name, reference_us, fused_us, reference_us / fused_us, scale_diff);
+    }
+}
+
+int main(void)
+{
+    test_size(96, 96);
+    test_size(320, 320);
+
+    return ei_host_test_result("test_image_scaling");
+}
@@ -0,0 +1,241 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Two impulses on ei_impulse_scheduler, the way AT+RUNIMPULSESCHED drives
+ * it: a slow "kws" impulse and a fast "imu" impulse, both built from the
+ * impulse in fusion_model/ with their own learning block. The blocks spin
+ * for their inference time (the POSIX timer counts process CPU time) and
+ * take their tensor arena from the scheduler, like an EON model does
+ * through ei_set_eon_arena_allocator. Checks that
+ * the earliest deadline runs first, both impulses run at their period and
+ * share one arena, and an impulse that keeps the CPU too long makes the
+ * other one miss its deadlines.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "ei_impulse_scheduler.h"
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_RUN_MS         1000
+#define KWS_ARENA_SIZE      (48 * 1024)
+#define IMU_ARENA_SIZE      (16 * 1024)
+
+/* Private types ----------------------------------------------------------- */
+typedef struct {
+    const char *name;
+    uint32_t infer_ms;
+    size_t arena_size;
+    /** Arena of the last inference */
+    void *arena;
+    uint32_t results;
+} test_model_t;
+
+/* Private variables ------------------------------------------------------- */
+static float window[EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE];
+static test_model_t kws_model = { "kws", 0, KWS_ARENA_SIZE, nullptr, 0 };
+static test_model_t imu_model = { "imu", 0, IMU_ARENA_SIZE, nullptr, 0 };
+/** Order of the first results, 'k' or 'i' */
+static char run_order[4];
+static uint32_t run_order_count;
+
+/* Private functions ------------------------------------------------------- */
+
+/**
+ * @brief Keep the CPU busy, ei_read_timer_us() does not advance while sleeping
+ */
+static void spin_ms(uint32_t time_ms)
+{
+    uint64_t end_us = ei_read_timer_us() + time_ms * 1000ULL;
+
+    while (ei_read_timer_us() < end_us) {
+    }
+}
+
+EI_IMPULSE_ERROR run_nn_inference(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config_ptr, bool debug)
+{
+    return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+}
+
+/**
+ * @brief Learning block of both test models, config is the test_model_t
+ */
+static EI_IMPULSE_ERROR host_model_infer(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config, bool debug)
+{
+    test_model_t *model = (test_model_t *)config;
+
+    model->arena = ei_scheduler_arena_alloc(16, model->arena_size);
+    if (model->arena == nullptr) {
+        return EI_IMPULSE_ALLOC_FAILED;
+    }
+    spin_ms(model->infer_ms);
+    ei_scheduler_arena_free(model->arena);
+
+    result->classification[0].label = impulse->categories[0];
+    result->classification[0].value = 1.0f;
+    result->classification[1].label = impulse->categories[1];
+    result->classification[1].value = 0.0f;
+
+    return EI_IMPULSE_OK;
+}
+
+EI_IMPULSE_ERROR host_fusion_infer(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config, bool debug)
+{
+    return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+}
+
+static const ei_learning_block_t kws_learning_blocks[1] = {
+    { 3, &host_model_infer, &kws_model, EI_CLASSIFIER_IMAGE_SCALING_NONE,
+      ei_learning_block_1_3_inputs, ei_learning_block_1_3_inputs_size },
+};
+static const ei_learning_block_t imu_learning_blocks[1] = {
+    { 3, &host_model_infer, &imu_model, EI_CLASSIFIER_IMAGE_SCALING_NONE,
+      ei_learning_block_1_3_inputs, ei_learning_block_1_3_inputs_size },
+};
+
+static bool get_window(void *ctx, ei::signal_t *signal)
+{
+    return numpy::signal_from_buffer(window, EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE, signal) == EIDSP_OK;
+}
+
+static void on_result(void *ctx, ei_impulse_handle_t *handle, ei_impulse_result_t *result, EI_IMPULSE_ERROR status)
+{
+    test_model_t *model = (test_model_t *)ctx;
+
+    EI_HOST_CHECK(status == EI_IMPULSE_OK, "%s inference failed (%d)", model->name, status);
+    model->results++;
+    if (run_order_count < sizeof(run_order)) {
+        run_order[run_order_count++] = model->name[0];
+    }
+}
+
+/**
+ * @brief Poll the scheduler for TEST_RUN_MS like ei_start_impulse_scheduled
+ * does, spinning instead of sleeping until the next release
+ */
+static void run_scheduler(void)
+{
+    uint64_t end_ms = ei_read_timer_ms() + TEST_RUN_MS;
+
+    EI_HOST_CHECK(ei_scheduler_start(&process_impulse), "scheduler did not start");
+    while (ei_read_timer_ms() < end_ms) {
+        ei_scheduler_poll();
+    }
+    ei_scheduler_stop();
+    ei_scheduler_print_stats();
+}
+
+/**
+ * @brief Register both impulses, the "imu" one has the shorter deadline
+ */
+static void add_impulses(ei_impulse_handle_t *kws, ei_impulse_handle_t *imu,
+                         uint32_t imu_deadline_ms, int *kws_id, int *imu_id)
+{
+    ei_scheduled_impulse_t config = {};
+
+    ei_scheduler_clear();
+    kws_model.results = imu_model.results = 0;
+    run_order_count = 0;
+
+    config.handle = kws;
+    config.period_ms = 100;
+    config.get_input = &get_window;
+    config.on_result = &on_result;
+    config.ctx = &kws_model;
+    *kws_id = ei_scheduler_add(&config);
+
+    config.handle = imu;
+    config.period_ms = 50;
+    config.deadline_ms = imu_deadline_ms;
+    config.ctx = &imu_model;
+    *imu_id = ei_scheduler_add(&config);
+
+    EI_HOST_CHECK(*kws_id == 0 && *imu_id == 1, "registration failed (%d, %d)", *kws_id, *imu_id);
+}
+
+int main(int argc, char **argv)
+{
+    ei_impulse_t kws_impulse = *ei_default_impulse.impulse;
+    ei_impulse_t imu_impulse = *ei_default_impulse.impulse;
+    ei_scheduler_stats_t kws_stats, imu_stats;
+    int kws_id, imu_id;
+
+    kws_impulse.project_id = 1;
+    kws_impulse.project_name = "Host test: kws";
+    kws_impulse.learning_blocks = kws_learning_blocks;
+    imu_impulse.project_id = 2;
+    imu_impulse.project_name = "Host test: imu";
+    imu_impulse.learning_blocks = imu_learning_blocks;
+
+    ei_impulse_handle_t kws_handle(&kws_impulse);
+    ei_impulse_handle_t imu_handle(&imu_impulse);
+
+    // 20 % and 10 % of the CPU, both fit
+    kws_model.infer_ms = 20;
+    imu_model.infer_ms = 5;
+    add_impulses(&kws_handle, &imu_handle, 0, &kws_id, &imu_id);
+    run_scheduler();
+    ei_scheduler_get_stats(kws_id, &kws_stats);
+    ei_scheduler_get_stats(imu_id, &imu_stats);
+
+    EI_HOST_CHECK(run_order_count >= 2 && run_order[0] == 'i' && run_order[1] == 'k',
+        "released together, the earlier deadline did not run first");
+    EI_HOST_CHECK(kws_stats.runs >= 8 && kws_stats.runs <= 11, "kws ran %u times", kws_stats.runs);
+    EI_HOST_CHECK(imu_stats.runs >= 16 && imu_stats.runs <= 21, "imu ran %u times", imu_stats.runs);
+    EI_HOST_CHECK(kws_model.results == kws_stats.runs && imu_model.results == imu_stats.runs,
+        "results were not reported for every run");
+    EI_HOST_CHECK(kws_stats.deadline_misses == 0 && imu_stats.deadline_misses == 0,
+        "%u and %u deadline misses", kws_stats.deadline_misses, imu_stats.deadline_misses);
+    EI_HOST_CHECK(kws_stats.busy_us >= kws_stats.runs * 20000ULL, "kws busy for %u us",
+        (unsigned)kws_stats.busy_us);
+    EI_HOST_CHECK(kws_model.arena != nullptr && kws_model.arena == imu_model.arena,
+        "the impulses did not share the tensor arena");
+
+    // the kws impulse keeps the CPU for 70 ms, longer than the imu deadline
+    kws_model.infer_ms = 70;
+    add_impulses(&kws_handle, &imu_handle, 30, &kws_id, &imu_id);
+    run_scheduler();
+    ei_scheduler_get_stats(kws_id, &kws_stats);
+    ei_scheduler_get_stats(imu_id, &imu_stats);
+
+    EI_HOST_CHECK(kws_stats.runs >= 8, "kws ran %u times", kws_stats.runs);
+    EI_HOST_CHECK(imu_stats.deadline_misses > 0, "imu never missed its deadline");
+    EI_HOST_CHECK(imu_stats.runs + imu_stats.skipped >= 16, "imu released %u times",
+        imu_stats.runs + imu_stats.skipped);
+
+    return ei_host_test_result("test_impulse_scheduler");
+}
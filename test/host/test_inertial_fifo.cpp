@@ -0,0 +1,164 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * FIFO batch reads of the inertial sensor against the LIS3DHTR register
+ * model. Time is simulated and shared by the model and esp_timer, the
+ * signal on X encodes the time a sample was taken, so every fusion tick
+ * can be traced back to the sensor sample it was answered with.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "ei_inertial_sensor.h"
+#include "LIS3DHTR_sim.h"
+
+#include "esp_timer.h"
+
+#include <math.h>
+
+/* Constants --------------------------------------------------------------- */
+#define CONVERT_G_TO_MS2    9.80665f
+/** Sensor output data rate set by ei_inertial_init() */
+#define TEST_ODR_PERIOD_US  2500
+/** Ticks skipped at the start while the queue fills */
+#define TEST_SETTLE_TICKS   16
+
+/* Private variables ------------------------------------------------------- */
+static int64_t now_us = 1000000;
+
+/* Private functions ------------------------------------------------------- */
+
+int64_t esp_timer_get_time(void)
+{
+    return now_us;
+}
+
+bool ei_add_sensor_to_fusion_list(ei_device_fusion_sensor_t sensor)
+{
+    return true;
+}
+
+/**
+ * @brief X is the time within the second the sample was taken, in g
+ */
+static void time_signal(int64_t t_us, float *xyz, void *ctx)
+{
+    xyz[0] = (float)(t_us % 1000000) / 1000000.0f;
+    xyz[1] = 0.0f;
+    xyz[2] = 1.0f;
+}
+
+/**
+ * @brief Sample at the fusion frequency and check that consecutive ticks are
+ * answered with samples spaced by the tick period
+ */
+static void run_ticks(const char *name, uint32_t tick_us, uint32_t ticks)
+{
+    lis3dhtr_sim_stats_t before, after;
+    int64_t prev = -1;
+    int64_t min_dt = INT64_MAX, max_dt = 0, max_lag = 0;
+    uint32_t repeated = 0;
+
+    lis3dhtr_sim_get_stats(&before);
+
+    for (uint32_t ix = 0; ix < ticks; ix++) {
+        now_us += tick_us;
+
+        float *data = ei_fusion_inertial_read_data(INERTIAL_AXIS_SAMPLED);
+        int64_t sampled = (int64_t)lroundf(data[0] / CONVERT_G_TO_MS2 * 1000000.0f);
+        int64_t lag = (now_us % 1000000) - sampled;
+
+        if (lag < 0) {
+            lag += 1000000;
+        }
+        if (ix < TEST_SETTLE_TICKS) {
+            prev = sampled;
+            continue;
+        }
+
+        int64_t dt = sampled - prev;
+        if (dt < 0) {
+            dt += 1000000;
+        }
+        if (dt == 0) {
+            repeated++;
+        }
+        min_dt = dt < min_dt ? dt : min_dt;
+        max_dt = dt > max_dt ? dt : max_dt;
+        max_lag = lag > max_lag ? lag : max_lag;
+        prev = sampled;
+    }
+
+    lis3dhtr_sim_get_stats(&after);
+    uint32_t produced = after.produced - before.produced;
+    uint32_t reads = after.bus_reads - before.bus_reads;
+
+    printf("%-8s %8u %8u %8lld %8lld %8lld %8u %8u %8u\n", name, ticks, produced,
+        (long long)min_dt, (long long)max_dt, (long long)max_lag, repeated,
+        after.overwritten - before.overwritten, reads);
+
+    // samples are on the ODR grid, ticks that are not a multiple of it alternate
+    int64_t slack = tick_us % TEST_ODR_PERIOD_US ? TEST_ODR_PERIOD_US : 100;
+    EI_HOST_CHECK(llabs(min_dt - tick_us) <= slack && llabs(max_dt - tick_us) <= slack,
+        "%s: ticks answered with samples %lld..%lld us apart", name, (long long)min_dt, (long long)max_dt);
+    EI_HOST_CHECK(repeated == 0, "%s: %u ticks repeated the previous sample", name, repeated);
+    EI_HOST_CHECK(after.overwritten == before.overwritten, "%s: %u samples overwritten in the FIFO", name, after.overwritten - before.overwritten);
+    // one FIFO_SRC and one burst per batch of 8, polling takes one read per tick
+    EI_HOST_CHECK(reads * 8 <= produced * 2 + 8, "%s: %u bus reads for %u samples", name, reads, produced);
+    EI_HOST_CHECK(max_lag <= 12 * TEST_ODR_PERIOD_US, "%s: samples up to %lld us old", name, (long long)max_lag);
+}
+
+int main(int argc, char **argv)
+{
+    lis3dhtr_sim_set_clock(esp_timer_get_time);
+    lis3dhtr_sim_set_signal(time_signal, nullptr);
+
+    EI_HOST_CHECK(ei_inertial_init(), "init failed");
+    // begin() resets the model, which selects the host clock again
+    lis3dhtr_sim_set_clock(esp_timer_get_time);
+
+    printf("%-8s %8s %8s %8s %8s %8s %8s %8s %8s\n", "", "ticks", "samples", "min dt", "max dt", "max lag", "repeated", "lost", "reads");
+    run_ticks("62.5 Hz", 16000, 600);
+    run_ticks("100 Hz", 10000, 600);
+    run_ticks("400 Hz", 2500, 2000);
+
+    // a pause longer than the FIFO restarts the queue, the first tick after
+    // it reads the overrun FIFO
+    now_us += 1000000;
+    ei_fusion_inertial_read_data(INERTIAL_AXIS_SAMPLED);
+    run_ticks("restart", 10000, 200);
+
+    return ei_host_test_result("test_inertial_fifo");
+}
@@ -0,0 +1,312 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * AT+READBUFFER / AT+READRAW readback on a file backed storage partition.
+ * The sample log is written through EiFlashMemory, read back with
+ * ei_readback_esp32.cpp and compared with the byte by byte encoders it
+ * replaced. The UART is simulated: the TX ring drains at baudrate / 10
+ * bytes/s on a simulated clock, so the reported throughput shows whether
+ * reading and encoding keep up with the line.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_device.h"
+#include "host_test.h"
+#include "flash_memory.h"
+#include "ei_readback_esp32.h"
+#include "ei_device_lib.h"
+#include "at_base64_lib.h"
+#include "driver/uart.h"
+#include "esp_timer.h"
+
+#include <chrono>
+#include <string>
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_PARTITION_SIZE     (1024 * 1024)
+#define TEST_SAMPLE_SIZE        100003
+#define TEST_TX_RING_SIZE       8192
+
+/* Simulated UART ---------------------------------------------------------- */
+static std::string uart_out;
+static bool uart_installed = false;
+static uint32_t uart_baudrate = 115200;
+static size_t uart_ring_size = 0;
+/** Bytes in the TX ring at uart_time_us */
+static double uart_queued = 0;
+static double uart_time_us = 0;
+/** Time spent waiting for the UART, added to the host clock */
+static double wait_us = 0;
+static const auto start = std::chrono::steady_clock::now();
+
+int64_t esp_timer_get_time(void)
+{
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now - start).count() + (int64_t)wait_us;
+}
+
+static double uart_bytes_per_us(void)
+{
+    return uart_baudrate / 10.0 / 1e6;
+}
+
+/** Send what the line allowed since the last call */
+static void uart_drain(void)
+{
+    double now = (double)esp_timer_get_time();
+
+    uart_queued -= (now - uart_time_us) * uart_bytes_per_us();
+    if (uart_queued < 0) {
+        uart_queued = 0;
+    }
+    uart_time_us = now;
+}
+
+esp_err_t uart_driver_install(uart_port_t, int, int tx_buffer_size, int, QueueHandle_t *, int)
+{
+    uart_installed = true;
+    uart_ring_size = tx_buffer_size;
+    uart_queued = 0;
+    uart_time_us = (double)esp_timer_get_time();
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_delete(uart_port_t)
+{
+    uart_installed = false;
+    return ESP_OK;
+}
+
+int uart_write_bytes(uart_port_t, const void *src, size_t size)
+{
+    EI_HOST_CHECK(uart_installed, "uart_write_bytes without the driver");
+    uart_out.append((const char *)src, size);
+
+    // blocks until the data fits in the ring, the same as the driver
+    size_t remaining = size;
+    while (remaining > 0) {
+        uart_drain();
+        size_t space = uart_ring_size - (size_t)uart_queued;
+        size_t take = remaining < space ? remaining : space;
+
+        if (take == 0) {
+            size_t need = remaining < uart_ring_size ? remaining : uart_ring_size;
+            wait_us += need / uart_bytes_per_us();
+            continue;
+        }
+        uart_queued += take;
+        remaining -= take;
+    }
+
+    return (int)size;
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t, TickType_t)
+{
+    uart_drain();
+    wait_us += uart_queued / uart_bytes_per_us();
+    uart_drain();
+    return ESP_OK;
+}
+
+esp_err_t uart_wait_tx_idle_polling(uart_port_t)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_get_baudrate(uart_port_t, uint32_t *baudrate)
+{
+    *baudrate = uart_baudrate;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t, uint32_t baudrate)
+{
+    uart_baudrate = baudrate;
+    return ESP_OK;
+}
+
+/* Device ------------------------------------------------------------------ */
+static EiDeviceInfo *device = NULL;
+
+EiDeviceInfo *EiDeviceInfo::get_device(void)
+{
+    return device;
+}
+
+/* Reference encoders, as used before the bulk readback -------------------- */
+static std::string ref_out;
+
+static void ref_putc(char c)
+{
+    ref_out += c;
+}
+
+static std::string ref_base64(EiDeviceMemory *memory, size_t address, size_t length)
+{
+    uint8_t buffer[513];
+
+    ref_out.clear();
+    while (length > 0) {
+        size_t bytes_to_read = length < sizeof(buffer) ? length : sizeof(buffer);
+
+        memory->read_sample_data(buffer, address, bytes_to_read);
+        base64_encode((char *)buffer, bytes_to_read, &ref_putc);
+        address += bytes_to_read;
+        length -= bytes_to_read;
+    }
+    return ref_out;
+}
+
+static std::string ref_hex(EiDeviceMemory *memory, size_t start, size_t length)
+{
+    uint8_t buffer[32];
+    char text[4];
+    int n_display_bytes = 16;
+
+    ref_out.clear();
+    for (; start < length; start += n_display_bytes) {
+        memory->read_sample_data(buffer, start, n_display_bytes);
+
+        for (int i = 0; i < n_display_bytes; i++) {
+            snprintf(text, sizeof(text), "%02X%c", buffer[i], (i % n_display_bytes == n_display_bytes - 1) ? '\n' : ' ');
+            ref_out += text;
+        }
+    }
+    ref_out += "\n";
+    return ref_out;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "readback_partition.bin";
+
+    EI_HOST_CHECK(esp_partition_host_add("storage", path, TEST_PARTITION_SIZE) != NULL, "can't create %s", path);
+
+    static EiFlashMemory memory(sizeof(EiConfig));
+    static EiHostDevice host_device(&memory);
+    device = &host_device;
+
+    // one record with a non repeating pattern
+    std::vector<uint8_t> sample(TEST_SAMPLE_SIZE);
+    for (size_t ix = 0; ix < sample.size(); ix++) {
+        sample[ix] = (uint8_t)((ix * 7919) ^ (ix >> 8));
+    }
+    memory.setup_sampling("test", "readback");
+    EI_HOST_CHECK(memory.erase_sample_data(0, sample.size()) == sample.size(), "erase failed");
+    EI_HOST_CHECK(memory.write_sample_data(sample.data(), 0, sample.size()) == sample.size(), "write failed");
+    memory.finalize_samplig();
+
+    const size_t lengths[] = { 0, 1, 2, 3, 4, 512, 513, 514, 12287, 12288, 12289, 50001, TEST_SAMPLE_SIZE };
+    const size_t addresses[] = { 0, 7 };
+
+    for (size_t address : addresses) {
+        for (size_t length : lengths) {
+            if (address + length > sample.size()) {
+                continue;
+            }
+            uart_out.clear();
+            EI_HOST_CHECK(read_encode_send_sample_buffer(address, length), "base64 readback failed");
+            EI_HOST_CHECK(uart_out == ref_base64(&memory, address, length),
+                "base64 readback of %zu bytes at %zu differs", length, address);
+
+            // AT+READRAW takes the end address, whole lines are printed
+            size_t end = address + (length / 16) * 16;
+            uart_out.clear();
+            EI_HOST_CHECK(ei_readback_hex(address, end), "hex readback failed");
+            EI_HOST_CHECK(uart_out == ref_hex(&memory, address, end),
+                "hex readback from %zu to %zu differs", address, end);
+        }
+    }
+
+    // throughput at the default, maximum and highest usable baudrate
+    const uint32_t baudrates[] = { 115200, 1000000, 2000000 };
+    printf("baudrate   base64 bytes/s   line limit   hex bytes/s   line limit\n");
+    for (uint32_t baudrate : baudrates) {
+        uart_set_baudrate(UART_NUM_0, baudrate);
+
+        read_encode_send_sample_buffer(0, sample.size());
+        ei_readback_stats_t b64 = *ei_readback_get_stats();
+        ei_readback_hex(0, sample.size());
+        ei_readback_stats_t hex = *ei_readback_get_stats();
+
+        // payload bytes/s when the line never idles: base64 sends 4 / 3, hex 3 characters per byte
+        double b64_limit = baudrate / 10.0 * 3 / 4;
+        double hex_limit = baudrate / 10.0 / 3;
+        double b64_rate = (double)b64.bytes * 1e6 / b64.time_us;
+        double hex_rate = (double)hex.bytes * 1e6 / hex.time_us;
+
+        printf("%8u   %14.0f   %10.0f   %11.0f   %10.0f\n", baudrate, b64_rate, b64_limit, hex_rate, hex_limit);
+        EI_HOST_CHECK(b64.baudrate == baudrate, "stats report %u baud", b64.baudrate);
+        EI_HOST_CHECK(b64_rate > 0.95 * b64_limit, "base64 readback at %u baud does not keep the line busy", baudrate);
+        EI_HOST_CHECK(hex_rate > 0.95 * hex_limit, "hex readback at %u baud does not keep the line busy", baudrate);
+    }
+
+    // whole sector multiples per flash read
+    uint64_t read_bytes, bytes_before;
+    uint32_t read_calls, calls_before;
+    esp_partition_host_read_stats(&bytes_before, &calls_before);
+    read_encode_send_sample_buffer(0, sample.size());
+    esp_partition_host_read_stats(&read_bytes, &read_calls);
+    printf("base64 readback of %zu bytes: %u esp_partition_read calls\n", sample.size(), read_calls - calls_before);
+    EI_HOST_CHECK(read_calls - calls_before <= (sample.size() + 3 * 4096 - 1) / (3 * 4096) + 1,
+        "%u flash reads for %zu bytes", read_calls - calls_before, sample.size());
+
+    // keep recording until a record wraps around the end of the log, the
+    // partition file keeps the log head of the previous run
+    const uint32_t log_sectors = (memory.get_available_sample_bytes() + 4096 - 1) / 4096;
+    bool wrapped = false;
+    for (int n = 0; n < 64 && !wrapped; n++) {
+        for (size_t ix = 0; ix < sample.size(); ix++) {
+            sample[ix] = (uint8_t)(ix * 31 + n);
+        }
+        memory.setup_sampling("test", "wrap");
+        memory.erase_sample_data(0, sample.size());
+        memory.write_sample_data(sample.data(), 0, sample.size());
+        memory.finalize_samplig();
+
+        ei_sample_record_t last = memory.get_records().back();
+        wrapped = last.first_sector + last.n_sectors > log_sectors;
+    }
+    EI_HOST_CHECK(wrapped, "no record wrapped around the log");
+
+    uart_out.clear();
+    ref_out.clear();
+    base64_encode((const char *)sample.data(), sample.size(), &ref_putc);
+    EI_HOST_CHECK(read_encode_send_sample_buffer(0, sample.size()), "readback of the wrapped record failed");
+    EI_HOST_CHECK(uart_out == ref_out, "readback of the wrapped record differs");
+
+    return ei_host_test_result("test_readback");
+}
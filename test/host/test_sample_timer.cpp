@@ -0,0 +1,237 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Drift and jitter of the sampling scheduler in ei_sample_timer_esp32.cpp,
+ * running on the POSIX esp_timer stand-in. The sample task notes the time
+ * of every callback and how many periods were missed before it, which puts
+ * each sample on the nominal grid from the start of sampling.
+ *
+ * - drift: the smallest lateness in the last quarter of a run against the
+ *   first quarter, stays below a quarter period if the rate holds
+ * - jitter: median lateness, spikes of a loaded host only show up in the
+ *   90th percentile, max and rms columns
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "ei_sample_timer_esp32.h"
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <algorithm>
+#include <atomic>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_MAX_SAMPLES    2000
+
+/* Private variables ------------------------------------------------------- */
+static int64_t start_us;
+static int64_t sample_times[TEST_MAX_SAMPLES];
+static uint32_t sample_missed[TEST_MAX_SAMPLES];
+static std::atomic<uint32_t> sample_count;
+static uint32_t stop_after = 0;
+/** Every slow_every-th callback takes slow_us */
+static uint32_t slow_every = 0;
+static uint32_t slow_us = 0;
+
+/* Private functions ------------------------------------------------------- */
+
+static void busy_wait_us(uint32_t us)
+{
+    int64_t until = esp_timer_get_time() + us;
+
+    while (esp_timer_get_time() < until) {
+    }
+}
+
+static void sample_cb(void)
+{
+    uint32_t n = sample_count.load();
+
+    if (n < TEST_MAX_SAMPLES) {
+        sample_times[n] = esp_timer_get_time();
+        sample_missed[n] = ei_sample_timer_get_stats()->missed;
+    }
+    sample_count = n + 1;
+
+    if (slow_every != 0 && (n + 1) % slow_every == 0) {
+        busy_wait_us(slow_us);
+    }
+    if (stop_after != 0 && n + 1 == stop_after) {
+        ei_sample_timer_stop();
+    }
+}
+
+/**
+ * @brief Sample until n callbacks ran or the timeout passed
+ */
+static bool run_samples(uint32_t period_us, uint32_t n, uint32_t timeout_ms)
+{
+    sample_count = 0;
+    start_us = esp_timer_get_time();
+
+    if (ei_sample_timer_start(sample_cb, period_us) == false) {
+        return false;
+    }
+
+    int64_t until = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    while (sample_count.load() < n && esp_timer_get_time() < until) {
+        vTaskDelay(1);
+    }
+    ei_sample_timer_stop();
+
+    return sample_count.load() >= n;
+}
+
+/**
+ * @brief Time of sample ix after its deadline, missed periods still count
+ */
+static int64_t lateness_us(uint32_t ix, uint32_t period_us)
+{
+    return sample_times[ix] - (start_us + (int64_t)(ix + sample_missed[ix] + 1) * period_us);
+}
+
+static int64_t min_lateness_us(uint32_t from, uint32_t to, uint32_t period_us)
+{
+    int64_t min = INT64_MAX;
+
+    for (uint32_t ix = from; ix < to; ix++) {
+        min = std::min(min, lateness_us(ix, period_us));
+    }
+
+    return min;
+}
+
+static int64_t drift_us(uint32_t n, uint32_t period_us)
+{
+    return min_lateness_us(n - n / 4, n, period_us) - min_lateness_us(0, n / 4, period_us);
+}
+
+/**
+ * @brief Lateness percentile of the samples, in microseconds
+ */
+static int64_t lateness_percentile_us(uint32_t n, uint32_t period_us, uint32_t percent)
+{
+    std::vector<int64_t> lateness;
+
+    for (uint32_t ix = 0; ix < n; ix++) {
+        lateness.push_back(lateness_us(ix, period_us));
+    }
+    std::sort(lateness.begin(), lateness.end());
+
+    return lateness[lateness.size() * percent / 100];
+}
+
+static float jitter_rms_us(const ei_sample_timer_stats_t *stats)
+{
+    return sqrtf((float)stats->sum_sq_dev / (stats->samples - 1));
+}
+
+static void print_stats(const char *name, const ei_sample_timer_stats_t *stats, uint32_t n, int64_t drift)
+{
+    printf("%-22s %8lu %8lu %8lu %8lu %8.1f %8lld %8lld %8lld %6lu\n", name,
+        (unsigned long)stats->nominal_us, (unsigned long)stats->samples,
+        (unsigned long)stats->min_us, (unsigned long)stats->max_us, jitter_rms_us(stats),
+        (long long)lateness_percentile_us(n, stats->nominal_us, 50),
+        (long long)lateness_percentile_us(n, stats->nominal_us, 90),
+        (long long)drift, (unsigned long)stats->missed);
+}
+
+/**
+ * @brief Run the scheduler and check rate and jitter
+ */
+static void check_rate(const char *name, uint32_t period, uint32_t n)
+{
+    const ei_sample_timer_stats_t *stats = ei_sample_timer_get_stats();
+
+    EI_HOST_CHECK(run_samples(period, n, n * period / 1000 * 3 + 500), "%s: %lu of %lu samples",
+        name, (unsigned long)sample_count.load(), (unsigned long)n);
+
+    uint32_t samples = std::min(sample_count.load(), (uint32_t)TEST_MAX_SAMPLES);
+    int64_t drift = drift_us(samples, period);
+    int64_t median = lateness_percentile_us(samples, period, 50);
+    print_stats(name, stats, samples, drift);
+
+    EI_HOST_CHECK(llabs(drift) < period / 4, "%s: drifted %lld us in %lu samples", name, (long long)drift, (unsigned long)samples);
+    EI_HOST_CHECK(min_lateness_us(0, samples, period) >= 0, "%s: sampled before the deadline", name);
+    EI_HOST_CHECK(median < period / 4, "%s: median lateness %lld us", name, (long long)median);
+}
+
+int main(int argc, char **argv)
+{
+    const ei_sample_timer_stats_t *stats = ei_sample_timer_get_stats();
+
+    printf("%-22s %8s %8s %8s %8s %8s %8s %8s %8s %6s\n", "", "nominal", "samples", "min", "max", "rms", "late p50", "late p90", "drift", "missed");
+
+    // 160 Hz, 6.25 ms is not a whole number of ticks
+    check_rate("160 Hz", 6250, 320);
+
+    // 1 kHz, single late samples don't move the grid
+    check_rate("1 kHz", 1000, 2000);
+
+    // every 20th callback takes 3.5 periods, at least two periods pass while
+    // it is busy and the sampling grid is kept
+    {
+        const uint32_t period = 2000, n = 400, every = 20;
+
+        slow_every = every;
+        slow_us = period * 7 / 2;
+        check_rate("500 Hz, slow callback", period, n);
+        slow_every = 0;
+
+        EI_HOST_CHECK(stats->missed >= (n / every - 1) * 2, "%lu periods missed", (unsigned long)stats->missed);
+    }
+
+    // stopping from the callback, then restarting resets the statistics
+    {
+        stop_after = 10;
+        sample_count = 0;
+        EI_HOST_CHECK(ei_sample_timer_start(sample_cb, 2000), "start failed");
+        vTaskDelay(100);
+        EI_HOST_CHECK(sample_count.load() == 10, "%lu samples after stopping at 10", (unsigned long)sample_count.load());
+        stop_after = 0;
+
+        EI_HOST_CHECK(run_samples(3000, 5, 1000), "restart failed");
+        EI_HOST_CHECK(stats->nominal_us == 3000 && stats->samples >= 5 && stats->samples < 10 + 5,
+            "statistics not reset, %lu samples", (unsigned long)stats->samples);
+    }
+
+    return ei_host_test_result("test_sample_timer");
+}
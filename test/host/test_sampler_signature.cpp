@@ -0,0 +1,228 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Samples recorded by ei_sampler_start_sampling() are encoded and signed a
+ * batch at a time. Record the same frames through the per-sample
+ * sensor_aq_add_data() path and check that the stored sample, the
+ * signature written into its header, and an independent HMAC of the file
+ * all agree.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_device.h"
+#include "host_test.h"
+#include "ei_sampler.h"
+#include "sensor_aq_mbedtls_hs256.h"
+#include <math.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <string>
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_AXES           3
+#define TEST_INTERVAL_MS    10.0f
+#define TEST_LENGTH_MS      5030    /* not a multiple of the 16 row batch */
+#define TEST_HMAC_KEY       "0123456789abcdef0123456789abcdef"
+
+/* Private variables ------------------------------------------------------- */
+static EiHostFlash flash(256 * 1024);
+static EiHostDevice device(&flash);
+static bool upload_enqueued = false;
+
+/* Platform functions used by ei_sampler.cpp ------------------------------- */
+EiDeviceInfo *EiDeviceInfo::get_device(void)
+{
+    return &device;
+}
+
+bool ei_uploader_enqueue_last(void)
+{
+    upload_enqueued = true;
+    return true;
+}
+
+/**
+ * @brief Frame ix of the test signal
+ */
+static void test_frame(uint32_t ix, float *values)
+{
+    for (int axis = 0; axis < TEST_AXES; axis++) {
+        values[axis] = sinf((float)ix * 0.05f * (axis + 1)) * 9.81f + axis;
+    }
+}
+
+/**
+ * @brief Starter passed to ei_sampler_start_sampling(), feeds every frame at once
+ */
+static bool test_sample_start(sampler_callback callback, float sample_interval_ms)
+{
+    float values[TEST_AXES];
+    uint32_t ix = 0;
+
+    do {
+        test_frame(ix++, values);
+    } while (callback(values, sizeof(values)) == false);
+
+    return true;
+}
+
+/* Per-sample reference ---------------------------------------------------- */
+static std::vector<uint8_t> ref_file;
+static size_t ref_pos = 0;
+
+static size_t ref_write(const void *buffer, size_t size, size_t count, EI_SENSOR_AQ_STREAM *)
+{
+    const uint8_t *data = (const uint8_t *)buffer;
+
+    for (size_t ix = 0; ix < size * count; ix++, ref_pos++) {
+        if (ref_pos < ref_file.size()) {
+            ref_file[ref_pos] = data[ix];
+        }
+        else {
+            ref_file.push_back(data[ix]);
+        }
+    }
+    return count;
+}
+
+static int ref_seek(EI_SENSOR_AQ_STREAM *, long int offset, int origin)
+{
+    ref_pos = (origin == SEEK_SET) ? offset : ref_pos + offset;
+    return 0;
+}
+
+static time_t ref_time(time_t *t)
+{
+    time_t cur_time = 4564867;
+    if (t) *(t) = cur_time;
+    return cur_time;
+}
+
+/**
+ * @brief Record the sample frame by frame with sensor_aq_add_data()
+ *
+ * @return signature index in ref_file, 0 on error
+ */
+static size_t record_reference(sensor_aq_payload_info *payload, uint32_t n_frames)
+{
+    static unsigned char ref_buffer[1024];
+    sensor_aq_signing_ctx_t signing_ctx;
+    sensor_aq_mbedtls_hs256_ctx_t hs_ctx;
+    sensor_aq_ctx ctx = {
+        { ref_buffer, sizeof(ref_buffer) },
+        &signing_ctx,
+        &ref_write,
+        &ref_seek,
+        &ref_time,
+    };
+    float values[TEST_AXES];
+
+    sensor_aq_init_mbedtls_hs256_context(&signing_ctx, &hs_ctx, TEST_HMAC_KEY);
+
+    int ret = sensor_aq_init(&ctx, payload, (EI_SENSOR_AQ_STREAM *)&ref_file, false);
+    EI_HOST_CHECK(ret == AQ_OK, "sensor_aq_init returned %d", ret);
+
+    for (uint32_t ix = 0; ix < n_frames && ret == AQ_OK; ix++) {
+        test_frame(ix, values);
+        ret = sensor_aq_add_data(&ctx, values, TEST_AXES);
+        EI_HOST_CHECK(ret == AQ_OK, "sensor_aq_add_data returned %d", ret);
+    }
+
+    ret = sensor_aq_finish(&ctx);
+    EI_HOST_CHECK(ret == AQ_OK, "sensor_aq_finish returned %d", ret);
+
+    return ret == AQ_OK ? ctx.signature_index : 0;
+}
+
+int main(void)
+{
+    sensor_aq_payload_info payload = {
+        "01:02:03:04:05:06",
+        "ESP32_HOST",
+        TEST_INTERVAL_MS,
+        { { "accX", "m/s2" }, { "accY", "m/s2" }, { "accZ", "m/s2" } }
+    };
+    uint32_t n_frames = (uint32_t)(TEST_LENGTH_MS / TEST_INTERVAL_MS);
+
+    device.set_sample_hmac_key(TEST_HMAC_KEY, false);
+    device.set_sample_interval_ms(TEST_INTERVAL_MS, false);
+    device.set_sample_length_ms(TEST_LENGTH_MS, false);
+
+    bool ok = ei_sampler_start_sampling(&payload, &test_sample_start, TEST_AXES * sizeof(float));
+    EI_HOST_CHECK(ok, "ei_sampler_start_sampling failed");
+    EI_HOST_CHECK(flash.finalize_count == 1, "record finalized %d times", flash.finalize_count);
+    EI_HOST_CHECK(upload_enqueued, "sample not queued for upload");
+
+    size_t sig_ix = record_reference(&payload, n_frames);
+    size_t sig_len = 64;
+    EI_HOST_CHECK(sig_ix != 0, "no reference signature");
+
+    if (ok && sig_ix != 0 && flash.finalized.size() >= ref_file.size()) {
+        std::string ref_sig((char *)&ref_file[sig_ix], sig_len);
+        std::string rec_sig((char *)&flash.finalized[sig_ix], sig_len);
+
+        EI_HOST_CHECK(ref_sig != std::string(sig_len, '0'), "reference is not signed");
+        EI_HOST_CHECK(rec_sig == ref_sig, "signature %s, per-sample %s", rec_sig.c_str(), ref_sig.c_str());
+
+        size_t first_diff = ref_file.size();
+        for (size_t ix = 0; ix < ref_file.size(); ix++) {
+            if (flash.finalized[ix] != ref_file[ix]) {
+                first_diff = ix;
+                break;
+            }
+        }
+        EI_HOST_CHECK(first_diff == ref_file.size(), "stored sample differs at byte %zu of %zu", first_diff, ref_file.size());
+
+        // the signature covers the file with the '0' placeholder in place of the signature
+        std::vector<uint8_t> signed_file(ref_file);
+        memset(&signed_file[sig_ix], '0', sig_len);
+        uint8_t mac[32];
+        unsigned int mac_len = sizeof(mac);
+        HMAC(EVP_sha256(), TEST_HMAC_KEY, strlen(TEST_HMAC_KEY), signed_file.data(), signed_file.size(), mac, &mac_len);
+
+        char mac_hex[65];
+        for (int ix = 0; ix < 32; ix++) {
+            snprintf(&mac_hex[ix * 2], 3, "%02x", mac[ix]);
+        }
+        EI_HOST_CHECK(rec_sig == mac_hex, "signature %s, HMAC of the file %s", rec_sig.c_str(), mac_hex);
+
+        printf("%u frames, %zu bytes, signature %s\n", n_frames, ref_file.size(), rec_sig.c_str());
+    }
+    else {
+        EI_HOST_CHECK(false, "stored sample is %zu bytes, per-sample %zu", flash.finalized.size(), ref_file.size());
+    }
+
+    return ei_host_test_result("test_sampler_signature");
+}
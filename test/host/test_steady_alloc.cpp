@@ -0,0 +1,118 @@
+/* The Clear BSD License
+ *
+ * Copyright (c) 2025 EdgeImpulse Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted (subject to the limitations in the disclaimer
+ * below) provided that the following conditions are met:
+ *
+ *   * Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ *
+ *   * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ *   * Neither the name of the copyright holder nor the names of its
+ *   contributors may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+ * THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Heap use of run_classifier in steady state, on the impulse in
+ * fusion_model/. Built with EI_ALLOC_TRACE_ASSERT_STEADY, so an inference
+ * after the first one that allocates aborts the test.
+ */
+
+/* Include ----------------------------------------------------------------- */
+#include "host_test.h"
+#include "model-parameters/model_metadata.h"
+#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include "edge-impulse-sdk/dsp/ei_alloc_trace.h"
+
+#include <type_traits>
+
+/* Constants --------------------------------------------------------------- */
+#define TEST_INFERENCES     20
+
+static_assert(!std::is_copy_constructible<ei_impulse_arena_t>::value, "the arena owns its buffers");
+static_assert(!std::is_copy_assignable<ei_impulse_arena_t>::value, "the arena owns its buffers");
+
+/* Private variables ------------------------------------------------------- */
+static float window[EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE];
+
+/* Private functions ------------------------------------------------------- */
+
+EI_IMPULSE_ERROR run_nn_inference(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config_ptr, bool debug)
+{
+    return EI_IMPULSE_UNSUPPORTED_INFERENCING_ENGINE;
+}
+
+EI_IMPULSE_ERROR host_fusion_infer(const ei_impulse_t *impulse, ei_feature_t *fmatrix, uint32_t learn_block_index, uint32_t* input_block_ids, uint32_t input_block_ids_size, ei_impulse_result_t *result, void *config, bool debug)
+{
+    const ei::matrix_t *features = fmatrix[0].matrix;
+
+    result->classification[0].label = impulse->categories[0];
+    result->classification[0].value = features->buffer[0] > 0.0f ? 1.0f : 0.0f;
+    result->classification[1].label = impulse->categories[1];
+    result->classification[1].value = 1.0f - result->classification[0].value;
+
+    return EI_IMPULSE_OK;
+}
+
+/**
+ * @brief Run one inference in a trace window
+ *
+ * @return allocations it made
+ */
+static uint32_t traced_inference(uint32_t ix)
+{
+    signal_t signal;
+    ei_impulse_result_t result = { 0 };
+    ei_alloc_trace_window_t trace_window;
+
+    numpy::signal_from_buffer(window, EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE, &signal);
+
+    ei_alloc_trace_begin(&trace_window);
+    EI_IMPULSE_ERROR res = run_classifier(&signal, &result, false);
+    ei_alloc_trace_end(&trace_window);
+
+    EI_HOST_CHECK(res == EI_IMPULSE_OK, "inference %u failed (%d)", ix, res);
+    if (ix > 0) {
+        ei_alloc_trace_check_steady(&trace_window, "run_classifier");
+    }
+
+    return trace_window.allocs;
+}
+
+int main(int argc, char **argv)
+{
+    for (size_t ix = 0; ix < EI_CLASSIFIER_DSP_INPUT_FRAME_SIZE; ix++) {
+        window[ix] = (float)(ix % 7) - 3.0f;
+    }
+
+    uint32_t first = traced_inference(0);
+    uint32_t steady = 0;
+    for (uint32_t ix = 1; ix < TEST_INFERENCES; ix++) {
+        steady += traced_inference(ix);
+    }
+    printf("run_classifier: %u allocations in the first inference, %u in the next %d\n", first, steady, TEST_INFERENCES - 1);
+    EI_HOST_CHECK(first > 0, "the first inference did not set up the arena");
+    EI_HOST_CHECK(steady == 0, "%u allocations in steady state", steady);
+
+    return ei_host_test_result("test_steady_alloc");
+}
@@ -36,6 +36,8 @@
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
 #include "edge-impulse-sdk/tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include "edge-impulse-sdk/classifier/ei_eon_profile.h"
+#include "edge-impulse-sdk/porting/ei_memory_placement.h"
 
 #if EI_CLASSIFIER_PRINT_STATE
 #if defined(__cplusplus) && EI_C_LINKAGE == 1
@@ -336,6 +338,13 @@ TfLiteNode tflNodes[11] = {
 used_operators_e used_ops[] =
 {OP_RESHAPE, OP_CONV_2D, OP_RESHAPE, OP_MAX_POOL_2D, OP_RESHAPE, OP_CONV_2D, OP_RESHAPE, OP_MAX_POOL_2D, OP_RESHAPE, OP_FULLY_CONNECTED, OP_SOFTMAX, };
 
+#if EI_CLASSIFIER_PROFILE_LAYERS == 1
+const char *used_op_names[] =
+{"RESHAPE", "CONV_2D", "RESHAPE", "MAX_POOL_2D", "RESHAPE", "CONV_2D", "RESHAPE", "MAX_POOL_2D", "RESHAPE", "FULLY_CONNECTED", "SOFTMAX", };
+
+static ei_eon_layer_profile_t layer_profile[11];
+#endif // EI_CLASSIFIER_PROFILE_LAYERS == 1
+
 
 // Indices into tflTensors and tflNodes for subgraphs
 const size_t tflTensors_subgraph_index[] = {0, 23, };
@@ -578,6 +587,65 @@ class EonMicroContext : public MicroContext {
 
 };
 
+#if EI_CLASSIFIER_PROFILE_LAYERS == 1
+static void init_layer_profile() {
+  for (size_t i = 0; i < 11; ++i) {
+    layer_profile[i].op = used_op_names[i];
+    layer_profile[i].ticks = 0;
+    layer_profile[i].input_bytes = 0;
+    layer_profile[i].weight_bytes = 0;
+    layer_profile[i].output_bytes = 0;
+
+    for (int ix = 0; ix < tflNodes[i].inputs->size; ix++) {
+      const TensorInfo_t &d = tensorData[tflNodes[i].inputs->data[ix]];
+      if (d.allocation_type == kTfLiteArenaRw) {
+        layer_profile[i].input_bytes += d.bytes;
+      }
+      else {
+        layer_profile[i].weight_bytes += d.bytes;
+      }
+    }
+    for (int ix = 0; ix < tflNodes[i].outputs->size; ix++) {
+      layer_profile[i].output_bytes += tensorData[tflNodes[i].outputs->data[ix]].bytes;
+    }
+  }
+}
+#endif // EI_CLASSIFIER_PROFILE_LAYERS == 1
+
+#if EI_CLASSIFIER_EON_WEIGHTS_IN_RAM == 1
+// flash address of every constant tensor that was copied to RAM, the copies
+// are made on the first init and kept until tflite_learn_44_13_release()
+static void* weights_in_flash[23];
+
+static TfLiteStatus copy_weights_to_ram() {
+  EiMemoryPlacement placement(EI_MEMORY_CLASS_WEIGHTS);
+  for (size_t i = 0; i < 23; ++i) {
+    if (tensorData[i].allocation_type != kTfLiteMmapRo || weights_in_flash[i]) {
+      continue;
+    }
+    void* ram = ei_malloc(tensorData[i].bytes);
+    if (!ram) {
+      ei_printf("ERR: failed to copy weights of tensor %d to RAM\n", (int)i);
+      return kTfLiteError;
+    }
+    memcpy(ram, tensorData[i].data, tensorData[i].bytes);
+    weights_in_flash[i] = tensorData[i].data;
+    tensorData[i].data = ram;
+  }
+  return kTfLiteOk;
+}
+
+static void free_weights_in_ram() {
+  for (size_t i = 0; i < 23; ++i) {
+    if (weights_in_flash[i]) {
+      ei_free(tensorData[i].data);
+      tensorData[i].data = weights_in_flash[i];
+      weights_in_flash[i] = nullptr;
+    }
+  }
+}
+#endif // EI_CLASSIFIER_EON_WEIGHTS_IN_RAM == 1
+
 
 } // namespace
 
@@ -594,6 +662,12 @@ TfLiteStatus tflite_learn_44_13_init( void*(*alloc_fnc)(size_t,size_t) ) {
   tensor_boundary = tensor_arena;
   current_location = tensor_arena + kTensorArenaSize;
 
+#if EI_CLASSIFIER_EON_WEIGHTS_IN_RAM == 1
+  if (copy_weights_to_ram() != kTfLiteOk) {
+    return kTfLiteError;
+  }
+#endif // EI_CLASSIFIER_EON_WEIGHTS_IN_RAM == 1
+
   EonMicroContext micro_context_;
   
   // Set microcontext as the context ptr
@@ -653,6 +727,10 @@ TfLiteStatus tflite_learn_44_13_init( void*(*alloc_fnc)(size_t,size_t) ) {
   }
   current_subgraph_index = 0;
 
+#if EI_CLASSIFIER_PROFILE_LAYERS == 1
+  init_layer_profile();
+#endif // EI_CLASSIFIER_PROFILE_LAYERS == 1
+
   return kTfLiteOk;
 }
 
@@ -670,8 +748,16 @@ TfLiteStatus tflite_learn_44_13_invoke() {
   for (size_t i = 0; i < 11; ++i) {
     ResetTensors();
 
+#if EI_CLASSIFIER_PROFILE_LAYERS == 1
+    uint32_t layer_start = ei_eon_profile_ticks();
+#endif // EI_CLASSIFIER_PROFILE_LAYERS == 1
+
     TfLiteStatus status = registrations[used_ops[i]].invoke(&ctx, &tflNodes[i]);
 
+#if EI_CLASSIFIER_PROFILE_LAYERS == 1
+    layer_profile[i].ticks = ei_eon_profile_ticks() - layer_start;
+#endif // EI_CLASSIFIER_PROFILE_LAYERS == 1
+
 #if EI_CLASSIFIER_PRINT_STATE
     ei_printf("layer %lu\n", i);
     ei_printf("    inputs:\n");
@@ -738,6 +824,17 @@ TfLiteStatus tflite_learn_44_13_invoke() {
   return kTfLiteOk;
 }
 
+TfLiteStatus tflite_learn_44_13_profile(const ei_eon_layer_profile_t **layers, size_t *count) {
+#if EI_CLASSIFIER_PROFILE_LAYERS == 1
+  *layers = layer_profile;
+  *count = 11;
+#else
+  *layers = nullptr;
+  *count = 0;
+#endif // EI_CLASSIFIER_PROFILE_LAYERS == 1
+  return kTfLiteOk;
+}
+
 TfLiteStatus tflite_learn_44_13_reset( void (*free_fnc)(void* ptr) ) {
 #ifdef EI_CLASSIFIER_ALLOCATION_HEAP
   free_fnc(tensor_arena);
@@ -753,3 +850,9 @@ TfLiteStatus tflite_learn_44_13_reset( void (*free_fnc)(void* ptr) ) {
   overflow_buffers_ix = 0;
   return kTfLiteOk;
 }
+
+void tflite_learn_44_13_release() {
+#if EI_CLASSIFIER_EON_WEIGHTS_IN_RAM == 1
+  free_weights_in_ram();
+#endif // EI_CLASSIFIER_EON_WEIGHTS_IN_RAM == 1
+}
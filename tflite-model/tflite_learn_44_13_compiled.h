@@ -34,6 +34,7 @@
 #define tflite_learn_44_13_GEN_H
 
 #include "edge-impulse-sdk/tensorflow/lite/c/common.h"
+#include "edge-impulse-sdk/classifier/ei_eon_profile.h"
 
 // Sets up the model with init and prepare steps.
 TfLiteStatus tflite_learn_44_13_init( void*(*alloc_fnc)(size_t,size_t) );
@@ -45,6 +46,10 @@ TfLiteStatus tflite_learn_44_13_output(int index, TfLiteTensor* tensor);
 TfLiteStatus tflite_learn_44_13_invoke();
 //Frees memory allocated
 TfLiteStatus tflite_learn_44_13_reset( void (*free)(void* ptr) );
+// Frees what init keeps across resets (weights copied to RAM).
+void tflite_learn_44_13_release();
+// Returns the per-layer profile of the last invoke (count is 0 unless EI_CLASSIFIER_PROFILE_LAYERS is set).
+TfLiteStatus tflite_learn_44_13_profile(const ei_eon_layer_profile_t **layers, size_t *count);
 
 
 // Returns the number of input tensors.